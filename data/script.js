@@ -34,12 +34,35 @@ const ACTION_TYPE_MAP = {
   0: "No Action",
   1: "Enable Joystick 1",
   2: "Disable Joystick 1",
+  3: "Enable Button Group #",
+  4: "Disable Button Group #",
+  5: "LED # On",
+  6: "LED # Off",
+  7: "Blink LED #",
+  8: "Stop Blinking LED #",
+  9: "Joystick Scale % =",
+};
+const TRIGGER_MODE_MAP = {
+  0: "While active",
+  1: "When it starts",
+  2: "When it ends",
 };
 const BINDING_TYPE_MAP = {
   0: "Unbound",
   1: "Bound to Button",
   2: "Bound to LCNC",
 };
+const CURVE_MAP = {
+  0: "Linear",
+  1: "Expo",
+  2: "S-Curve",
+};
+const LED_PATTERN_MAP = {
+  0: "Steady",
+  1: "Blink",
+  2: "Fast Blink",
+  3: "Pulse",
+};
 
 // --- INITIALIZATION ---
 window.addEventListener("load", onLoad);
@@ -110,6 +133,12 @@ function onMessage(event) {
     buildConfigUI(data.payload);
   } else if (data.type === "liveStatus") {
     updateLiveStatus(data.payload);
+  } else if (data.type === "calibrationStatus") {
+    updateCalibrationStatus(data.payload);
+  } else if (data.type === "calibrationResult") {
+    showCalibrationResult(data.payload);
+  } else if (data.type === "taskStats") {
+    updateTaskStats(data.payload);
   }
 }
 
@@ -150,6 +179,29 @@ function updateLiveStatus(status) {
   }
 }
 
+/**
+ * @brief Shows the per-task CPU report the panel sends every few seconds.
+ * @param {object} stats The payload: window_ms and one entry per task.
+ */
+function updateTaskStats(stats) {
+  const table = document.getElementById("task-stats-live");
+  if (!table) return;
+  table.innerHTML =
+    "<tr><th>Task</th><th>CPU</th><th>Passes</th><th>Max</th><th>Stack free</th></tr>";
+  stats.tasks.forEach((task) => {
+    const row = table.insertRow();
+    [
+      task.name,
+      `${task.cpu_pct.toFixed(1)} %`,
+      task.passes,
+      `${task.max_us} µs`,
+      `${task.stack_free} B`,
+    ].forEach((value) => {
+      row.insertCell().textContent = value;
+    });
+  });
+}
+
 /**
  * @brief Creates an 8x8 grid of divs for the live status displays.
  * @param {string} containerId The ID of the parent element.
@@ -200,7 +252,7 @@ function buildConfigUI(config) {
   // --- Build LED Config Table ---
   if (config.leds) {
     const container = document.getElementById("led-config-table");
-    let html = `<div class="config-table-header"><div>#</div><div>Name</div><div>Binding Type</div><div>Bound To Button #</div><div>LCNC State Bit #</div></div>`;
+    let html = `<div class="config-table-header"><div>#</div><div>Name</div><div>Binding Type</div><div>Bound To Button #</div><div>LCNC State Bit #</div><div>Pattern</div><div>Brightness %</div></div>`;
     config.leds.forEach((led, index) => {
       let bindingOptions = "";
       for (const [key, value] of Object.entries(BINDING_TYPE_MAP)) {
@@ -208,12 +260,20 @@ function buildConfigUI(config) {
           led.binding_type == key ? "selected" : ""
         }>${value}</option>`;
       }
+      let patternOptions = "";
+      for (const [key, value] of Object.entries(LED_PATTERN_MAP)) {
+        patternOptions += `<option value="${key}" ${
+          led.pattern == key ? "selected" : ""
+        }>${value}</option>`;
+      }
       html += `<div class="config-table-row">
                 <div>${index}</div>
                 <div><input type="text" id="led-name-${index}" value="${led.name}"></div>
                 <div><select id="led-binding-${index}" onchange="toggleLedInputs(${index})">${bindingOptions}</select></div>
                 <div id="led-bound-button-wrapper-${index}"><input type="number" id="led-bound-button-${index}" value="${led.bound_button_index}" min="-1"></div>
                 <div id="led-lcnc-bit-wrapper-${index}"><input type="number" id="led-lcnc-bit-${index}" value="${led.lcnc_state_bit}" min="-1"></div>
+                <div><select id="led-pattern-${index}">${patternOptions}</select></div>
+                <div><input type="number" id="led-brightness-${index}" value="${led.brightness}" min="0" max="100"></div>
             </div>`;
     });
     container.innerHTML = html;
@@ -226,9 +286,18 @@ function buildConfigUI(config) {
     let html = ``;
     config.joysticks.forEach((joy, index) => {
       html += `<h3>${joy.name}</h3>
-                <div class="config-table-header"><div>Axis</div><div>Invert</div><div>Sensitivity</div><div>Deadzone</div></div>`;
+                <div class="config-table-header"><div>Axis</div><div>Invert</div><div>Sensitivity</div><div>Deadzone</div><div>Curve</div><div>Curve %</div><div>Calibration (min / center / max)</div></div>`;
       joy.axes.forEach((axis, axis_idx) => {
         const axis_name = ["X", "Y", "Z"][axis_idx];
+        let curveOptions = "";
+        for (const [key, value] of Object.entries(CURVE_MAP)) {
+          curveOptions += `<option value="${key}" ${
+            axis.curve == key ? "selected" : ""
+          }>${value}</option>`;
+        }
+        const cal = axis.calibration
+          ? `${axis.calibration.min} / ${axis.calibration.center} / ${axis.calibration.max}`
+          : "Not calibrated";
         html += `<div class="config-table-row">
                     <div><b>${axis_name}</b></div>
                     <div><input type="checkbox" id="joy-${index}-axis-${axis_idx}-inverted" ${
@@ -240,8 +309,19 @@ function buildConfigUI(config) {
                     <div><input type="number" id="joy-${index}-axis-${axis_idx}-deadzone" value="${
           axis.center_deadzone
         }"></div>
+                    <div><select id="joy-${index}-axis-${axis_idx}-curve">${curveOptions}</select></div>
+                    <div><input type="number" id="joy-${index}-axis-${axis_idx}-curve-strength" value="${
+          axis.curve_strength
+        }" min="0" max="100"></div>
+                    <div id="joy-${index}-axis-${axis_idx}-cal">${cal}</div>
                 </div>`;
       });
+      html += `<div class="calibration-panel">
+                <button id="cal-start-${index}" onclick="startCalibration(${index})">Calibrate</button>
+                <button id="cal-finish-${index}" onclick="finishCalibration()" hidden>Finish</button>
+                <button id="cal-cancel-${index}" onclick="cancelCalibration(${index})" hidden>Cancel</button>
+                <span id="cal-message-${index}"></span>
+              </div>`;
     });
     container.innerHTML = html;
   }
@@ -249,7 +329,7 @@ function buildConfigUI(config) {
   // --- Build Action Binding Table ---
   if (config.bindings) {
     const container = document.getElementById("action-binding-table");
-    let html = `<div class="config-table-header"><div>Active</div><div>IF (Machine State Is...)</div><div>THEN (Perform Action...)</div></div>`;
+    let html = `<div class="config-table-header"><div>Active</div><div>IF (Machine State Is...)</div><div>Mode</div><div>THEN (Perform Action...)</div><div>#</div></div>`;
     config.bindings.forEach((binding, index) => {
       let triggerOptions = "";
       for (const [key, value] of Object.entries(TRIGGER_TYPE_MAP)) {
@@ -257,6 +337,12 @@ function buildConfigUI(config) {
           binding.trigger == key ? "selected" : ""
         }>${value}</option>`;
       }
+      let modeOptions = "";
+      for (const [key, value] of Object.entries(TRIGGER_MODE_MAP)) {
+        modeOptions += `<option value="${key}" ${
+          binding.mode == key ? "selected" : ""
+        }>${value}</option>`;
+      }
       let actionOptions = "";
       for (const [key, value] of Object.entries(ACTION_TYPE_MAP)) {
         actionOptions += `<option value="${key}" ${
@@ -268,7 +354,11 @@ function buildConfigUI(config) {
         binding.is_active ? "checked" : ""
       }></div>
                 <div><select id="binding-trigger-${index}">${triggerOptions}</select></div>
+                <div><select id="binding-mode-${index}">${modeOptions}</select></div>
                 <div><select id="binding-action-${index}">${actionOptions}</select></div>
+                <div><input type="number" id="binding-param-${index}" value="${
+        binding.param || 0
+      }" min="0" max="255"></div>
             </div>`;
     });
     container.innerHTML = html;
@@ -319,6 +409,10 @@ function saveConfiguration() {
       lcnc_state_bit: parseInt(
         document.getElementById(`led-lcnc-bit-${i}`).value
       ),
+      pattern: parseInt(document.getElementById(`led-pattern-${i}`).value),
+      brightness: parseInt(
+        document.getElementById(`led-brightness-${i}`).value
+      ),
     });
   }
 
@@ -336,6 +430,12 @@ function saveConfiguration() {
         center_deadzone: parseInt(
           document.getElementById(`joy-${i}-axis-${j}-deadzone`).value
         ),
+        curve: parseInt(
+          document.getElementById(`joy-${i}-axis-${j}-curve`).value
+        ),
+        curve_strength: parseInt(
+          document.getElementById(`joy-${i}-axis-${j}-curve-strength`).value
+        ),
       });
     }
     config.joysticks.push(joy_data);
@@ -347,6 +447,8 @@ function saveConfiguration() {
       is_active: document.getElementById(`binding-active-${i}`).checked,
       trigger: parseInt(document.getElementById(`binding-trigger-${i}`).value),
       action: parseInt(document.getElementById(`binding-action-${i}`).value),
+      mode: parseInt(document.getElementById(`binding-mode-${i}`).value),
+      param: parseInt(document.getElementById(`binding-param-${i}`).value) || 0,
     });
   }
 
@@ -355,6 +457,74 @@ function saveConfiguration() {
   alert("Configuration sent to HMI!");
 }
 
+// --- JOYSTICK CALIBRATION ---
+
+let calibratingJoystick = -1;
+
+/**
+ * @brief Shows the calibration controls of one joystick, or restores the idle state.
+ * @param {number} index The joystick, or -1 when no calibration is running.
+ */
+function setCalibrationControls(index) {
+  for (let i = 0; document.getElementById(`cal-start-${i}`); i++) {
+    document.getElementById(`cal-start-${i}`).hidden = index >= 0;
+    document.getElementById(`cal-finish-${i}`).hidden = i !== index;
+    document.getElementById(`cal-cancel-${i}`).hidden = i !== index;
+  }
+  calibratingJoystick = index;
+}
+
+/**
+ * @brief Starts calibrating a joystick. The stick must be released at this point.
+ * @param {number} index The joystick to calibrate.
+ */
+function startCalibration(index) {
+  if (!confirm("Release the joystick, then press OK. Afterwards move every axis fully to both ends and press Finish.")) {
+    return;
+  }
+  websocket.send(JSON.stringify({ command: "startCalibration", payload: { joystick: index } }));
+  setCalibrationControls(index);
+  document.getElementById(`cal-message-${index}`).textContent = "Move every axis to both ends...";
+}
+
+function finishCalibration() {
+  websocket.send(JSON.stringify({ command: "finishCalibration" }));
+}
+
+function cancelCalibration(index) {
+  websocket.send(JSON.stringify({ command: "cancelCalibration" }));
+  setCalibrationControls(-1);
+  document.getElementById(`cal-message-${index}`).textContent = "Calibration cancelled.";
+}
+
+/**
+ * @brief Shows the ranges captured so far while a calibration runs.
+ * @param {object} status The payload with the joystick index and per-axis min/center/max/raw.
+ */
+function updateCalibrationStatus(status) {
+  status.axes.forEach((axis, axis_idx) => {
+    const cell = document.getElementById(`joy-${status.joystick}-axis-${axis_idx}-cal`);
+    if (cell) {
+      cell.textContent = `${axis.min} / ${axis.center} / ${axis.max} (now ${axis.raw})`;
+    }
+  });
+}
+
+/**
+ * @brief Reports the outcome of "Finish". On success the server also resends the config.
+ * @param {object} result The payload with `ok` and `message`.
+ */
+function showCalibrationResult(result) {
+  const index = calibratingJoystick >= 0 ? calibratingJoystick : 0;
+  if (result.ok) {
+    setCalibrationControls(-1);
+  }
+  const message = document.getElementById(`cal-message-${index}`);
+  if (message) {
+    message.textContent = result.message;
+  }
+}
+
 /**
  * @brief Handles the logic for switching between configuration tabs.
  * @param {Event} evt The click event.
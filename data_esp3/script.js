@@ -3,6 +3,7 @@
 document.addEventListener("DOMContentLoaded", () => {
   const appState = {
     config: {},
+    lcncStatus: {},
     websocket: null,
     isConnecting: false,
   };
@@ -28,6 +29,7 @@ document.addEventListener("DOMContentLoaded", () => {
 
     const wsUrl = `ws://${window.location.hostname}/ws`;
     appState.websocket = new WebSocket(wsUrl);
+    appState.websocket.binaryType = "arraybuffer";
 
     appState.websocket.onopen = () => {
       console.log("WebSocket connected.");
@@ -44,6 +46,10 @@ document.addEventListener("DOMContentLoaded", () => {
     };
 
     appState.websocket.onmessage = (event) => {
+      if (event.data instanceof ArrayBuffer) {
+        handleLiveFrame(new DataView(event.data));
+        return;
+      }
       try {
         const msg = JSON.parse(event.data);
         handleWsMessage(msg);
@@ -71,14 +77,49 @@ document.addEventListener("DOMContentLoaded", () => {
         appState.config = msg.payload;
         buildFullUI();
         break;
-      case "liveStatus":
-        updateLiveStatusUI(msg.payload);
-        break;
       default:
         console.warn("Unknown message type:", msg.type);
     }
   }
 
+  // --- Binary live-status frames (see web_interface.cpp) ---
+  const LIVE_PROTOCOL_VERSION = 1;
+  const LIVE_FRAME_LCNC = 0x01;
+  const LIVE_FRAME_PENDANT = 0x02;
+
+  function handleLiveFrame(view) {
+    if (view.byteLength < 4) return;
+    const type = view.getUint8(0);
+    if (view.getUint8(1) !== LIVE_PROTOCOL_VERSION) {
+      console.warn("Live frame version mismatch; reload the page.");
+      return;
+    }
+    // All fields are little-endian; offsets follow the 4-byte header.
+    if (type === LIVE_FRAME_PENDANT && view.byteLength >= 14) {
+      updateLiveStatusUI({
+        buttons: view.getUint32(4, true),
+        handwheel: view.getInt32(8, true),
+        axis: view.getUint8(12),
+        step: view.getUint8(13),
+      });
+    } else if (type === LIVE_FRAME_LCNC && view.byteLength >= 60) {
+      const dro = [];
+      for (let i = 0; i < 6; i++) dro.push(view.getFloat32(36 + i * 4, true));
+      appState.lcncStatus = {
+        linuxcnc_status: view.getUint32(4, true),
+        machine_status: view.getUint16(8, true),
+        spindle_coolant_status: view.getUint16(10, true),
+        feed_override: view.getFloat32(12, true),
+        rapid_override: view.getFloat32(16, true),
+        spindle_override: view.getFloat32(20, true),
+        current_feedrate: view.getFloat32(24, true),
+        spindle_rpm: view.getUint32(28, true),
+        cutting_speed: view.getFloat32(32, true),
+        dro_pos: dro,
+      };
+    }
+  }
+
   // --- UI Building ---
   function buildFullUI() {
     buildButtonMatrix();
@@ -69,7 +69,7 @@ public:
             cfg.y_min = 0;
             cfg.x_max = 479;
             cfg.y_max = 319;
-            cfg.bus_shared = true;
+            cfg.bus_shared = false; // Own I2C bus: the touch reader task must not wait on display DMA
             cfg.offset_rotation = 0;
             cfg.pin_int = DisplayConfig::PIN_TOUCH_INT;
             cfg.pin_sda = DisplayConfig::PIN_TOUCH_SDA;
@@ -0,0 +1,214 @@
+/**
+ * @file json_stream.h
+ * @brief Minimal streaming JSON writer, shared by the ESP2 panel and the ESP3 pendant.
+ *
+ * Writes tokens straight to any Arduino Print, with no intermediate
+ * document. Memory use is independent of the size of what is written. For
+ * WebSocket messages, ws_send_json() sizes the message in a counting pass
+ * and then writes it once into an exactly reserved String, so a config
+ * reaches the socket without a JsonDocument or repeated reallocation.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <string>
+
+/** @brief A Print that only counts bytes; used to size a buffer up front. */
+class CountingPrint : public Print
+{
+public:
+    size_t write(uint8_t) override
+    {
+        count++;
+        return 1;
+    }
+    size_t write(const uint8_t *, size_t len) override
+    {
+        count += len;
+        return len;
+    }
+    size_t count = 0;
+};
+
+/** @brief A Print that appends to an Arduino String. */
+class StringPrint : public Print
+{
+public:
+    explicit StringPrint(String &out) : out(out) {}
+    size_t write(uint8_t c) override
+    {
+        out += (char)c;
+        return 1;
+    }
+    size_t write(const uint8_t *data, size_t n) override
+    {
+        out.concat((const char *)data, n);
+        return n;
+    }
+    String &out;
+};
+
+/**
+ * @brief Emits JSON tokens in order, inserting commas automatically.
+ *
+ * Usage mirrors the document being written:
+ *   w.begin_object(); w.field("type", "x"); w.key("payload"); w.begin_array(); ...
+ * Nesting depth is limited to 32 levels.
+ */
+class JsonStreamWriter
+{
+public:
+    explicit JsonStreamWriter(Print &out) : out(out) {}
+
+    void begin_object() { open('{'); }
+    void end_object() { close('}'); }
+    void begin_array() { open('['); }
+    void end_array() { close(']'); }
+
+    /** @brief Writes an object key; the next token is its value. */
+    void key(const char *k)
+    {
+        separator();
+        write_string(k);
+        out.write(':');
+        after_key = true;
+    }
+
+    void value(const char *s)
+    {
+        separator();
+        write_string(s ? s : "");
+    }
+    void value(const std::string &s) { value(s.c_str()); }
+    void value(bool b)
+    {
+        separator();
+        out.print(b ? "true" : "false");
+    }
+    // One overload per fundamental type, so int32_t/uint32_t resolve the
+    // same way whichever typedef the toolchain uses; narrower types promote.
+    void value(int v) { number(v); }
+    void value(unsigned int v) { number(v); }
+    void value(long v) { number(v); }
+    void value(unsigned long v) { number(v); }
+    void value(const String &s) { value(s.c_str()); }
+    void value(double v)
+    {
+        separator();
+        if (isnan(v) || isinf(v))
+            out.print("null");
+        else
+            out.print(v, 3);
+    }
+
+    template <typename T>
+    void field(const char *k, const T &v)
+    {
+        key(k);
+        value(v);
+    }
+
+private:
+    template <typename N>
+    void number(N v)
+    {
+        separator();
+        out.print(v);
+    }
+
+    void separator()
+    {
+        if (after_key)
+        {
+            after_key = false;
+            return;
+        }
+        if (depth > 0)
+        {
+            uint32_t bit = 1u << (depth - 1);
+            if (has_items & bit)
+                out.write(',');
+            has_items |= bit;
+        }
+    }
+
+    void open(char c)
+    {
+        separator();
+        out.write(c);
+        if (depth < 32)
+            has_items &= ~(1u << depth);
+        depth++;
+    }
+
+    void close(char c)
+    {
+        if (depth > 0)
+            depth--;
+        out.write(c);
+    }
+
+    void write_string(const char *s)
+    {
+        out.write('"');
+        for (; *s; ++s)
+        {
+            char c = *s;
+            if (c == '"' || c == '\\')
+            {
+                out.write('\\');
+                out.write(c);
+            }
+            else if ((uint8_t)c < 0x20)
+            {
+                out.printf("\\u%04x", (unsigned)(uint8_t)c);
+            }
+            else
+            {
+                out.write(c);
+            }
+        }
+        out.write('"');
+    }
+
+    Print &out;
+    uint32_t has_items = 0; // Bit n: the container at depth n already has an element
+    uint8_t depth = 0;
+    bool after_key = false;
+};
+
+/**
+ * @brief Streams a JSON text message to one WebSocket client.
+ *
+ * The writer callback runs twice: once against a CountingPrint to size
+ * the message, and once into a String reserved to exactly that size, so
+ * the text is never reallocated while it grows. The String is copied into
+ * the client's own queue. A shared makeBuffer() buffer is not used: the
+ * library frees those only from textAll()/binaryAll(), which could delete
+ * it mid-write from another task, or never free it at all.
+ *
+ * @return false if the message could not be allocated.
+ */
+template <typename WriteFn>
+inline bool ws_send_json(AsyncWebSocketClient *client, WriteFn &&write)
+{
+    CountingPrint counter;
+    JsonStreamWriter sizing(counter);
+    write(sizing);
+
+    String message;
+    if (!message.reserve(counter.count))
+        return false;
+
+    StringPrint sink(message);
+    JsonStreamWriter writer(sink);
+    write(writer);
+    client->text(message);
+    return true;
+}
+
+#endif // __cplusplus
@@ -41,7 +41,7 @@
  * - LV_STDLIB_RTTHREAD:    RT-Thread implementation
  * - LV_STDLIB_CUSTOM:      Implement the functions externally
  */
-#define LV_USE_STDLIB_MALLOC    LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_MALLOC    LV_STDLIB_CUSTOM  /*Tiered internal/PSRAM allocator in src/esp3/lvgl_mem_tiered.c*/
 #define LV_USE_STDLIB_STRING    LV_STDLIB_BUILTIN
 #define LV_USE_STDLIB_SPRINTF   LV_STDLIB_BUILTIN
 
@@ -68,6 +68,18 @@
     #endif
 #endif  /*LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN*/
 
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
+    /*Blocks up to this size (objects, styles, short label text) go to internal RAM; larger ones to PSRAM*/
+    #define LV_MEM_TIER_SMALL_MAX       256U               /*[bytes]*/
+
+    /*Upper bound on internal RAM that LVGL may hold; beyond it small blocks spill to PSRAM*/
+    #define LV_MEM_TIER_INTERNAL_BUDGET (48 * 1024U)       /*[bytes]*/
+
+    /*Fragmentation guard: if the largest free internal block drops below this, everything goes to PSRAM
+     *so Wi-Fi and display DMA keep a contiguous region*/
+    #define LV_MEM_TIER_INTERNAL_RESERVE (24 * 1024U)      /*[bytes]*/
+#endif  /*LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM*/
+
 /*====================
    HAL SETTINGS
  *====================*/
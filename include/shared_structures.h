@@ -14,6 +14,10 @@
 // NOTE: These structs use __attribute__((packed)) to prevent compiler padding,
 // which is CRITICAL for reliable network communication.
 
+// Radio channel ESP1 listens on. A board that also joins Wi-Fi only accepts
+// an access point on this channel, or it would drop off the ESP-NOW link.
+#define ESPNOW_CHANNEL 1
+
 /** @brief Outgoing Packet: Sent from the Pendant (HMI) to LinuxCNC. */
 typedef struct
 {
@@ -42,10 +46,59 @@ typedef struct
     float cutting_speed;
     float dro_pos[6];
     char macro_text[64];
+    uint16_t key_event_epoch; // Echo of struct_message_from_esp2::key_event_epoch
+    uint16_t key_event_ack;   // Highest key event seq ESP1 has taken over from the panel
 } LcncStatusPacket;
 
+/** @brief Kinds of records in the main panel's key event stream. */
+typedef enum
+{
+    KEY_EVENT_NONE = 0,
+    KEY_EVENT_PRESS = 1,      // Debounced press edge
+    KEY_EVENT_RELEASE = 2,    // Debounced release edge
+    KEY_EVENT_LONG_PRESS = 3, // Key held for KEY_LONG_PRESS_MS
+    KEY_EVENT_DOUBLE_TAP = 4, // Second press within KEY_DOUBLE_TAP_MS of a short tap
+    KEY_EVENT_CHORD = 5       // Several keys pressed together within KEY_CHORD_WINDOW_MS
+} PanelKeyEventType;
+
+#define KEY_EVENTS_PER_PACKET 8 // Unacknowledged events carried by one panel packet
+#define KEY_CHORD_MAX_KEYS 4    // Larger chords are not reported
+
+/** @brief One record of the main panel's key event stream. */
+typedef struct __attribute__((packed))
+{
+    uint16_t seq;                        // Running number within the epoch; wraps
+    uint8_t type;                        // PanelKeyEventType
+    uint8_t key;                         // Key index (row * 8 + col); lowest key for chords
+    uint32_t time_ms;                    // Panel millis() when the event was recognized
+    uint8_t chord[KEY_CHORD_MAX_KEYS];   // Chord keys in ascending order, 0xFF = unused
+} PanelKeyEvent;
+
+/**
+ * @brief Outgoing Packet: Sent from the Main Panel (ESP2) to ESP1.
+ *
+ * Every packet repeats the oldest events ESP1 has not acknowledged yet
+ * (LcncStatusPacket::key_event_ack), so a lost packet only delays them.
+ * The epoch is drawn at panel boot; a new epoch restarts the sequence.
+ */
+typedef struct __attribute__((packed))
+{
+    uint8_t button_matrix_states[8];
+    int16_t joystick_values[6];   // Up to 2 joysticks x 3 axes
+    int32_t encoder_counts[8];    // Panel encoder counts
+    uint8_t rotary_positions[4];  // Rotary switch positions, 0 = first
+    uint16_t key_event_epoch;
+    uint8_t key_event_count;
+    PanelKeyEvent key_events[KEY_EVENTS_PER_PACKET];
+} struct_message_from_esp2;
+
+// Names used by the ESP1 bridge and the main panel.
+typedef LcncStatusPacket struct_message_to_hmi;
+typedef PendantStatePacket struct_message_from_esp3;
+
 // --- C++ ONLY Structures (for Web Configuration) ---
-#ifdef __cplusplus
+// Pendant only: the main panel has its own LedBinding in config_esp2.h.
+#if defined(__cplusplus) && defined(CORE_ESP3)
 
 #include <string>
 #include <vector>
@@ -102,4 +155,4 @@ struct PendantWebConfig
     std::vector<MacroEntry> macros;
 };
 
-#endif // __cplusplus
+#endif // __cplusplus && CORE_ESP3
@@ -0,0 +1,101 @@
+/**
+ * @file web_assets.h
+ * @brief Serves the precompressed web UI built by scripts/build_web_assets.py.
+ *
+ * Shared by the ESP2 panel and the ESP3 pendant. The LittleFS image holds
+ * gzip files plus an assets.json manifest; each asset is answered with
+ * Content-Encoding: gzip, a strong ETag and a cache policy, and a matching
+ * If-None-Match gets an empty 304. Hashed CSS/JS names are cached as
+ * immutable, index.html is always revalidated.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include <FS.h>
+#include <string>
+#include <vector>
+
+struct WebAsset
+{
+    std::string url;
+    std::string file;
+    std::string type;
+    std::string etag;
+    bool immutable;
+};
+
+/**
+ * @brief Answers one request for a manifest entry.
+ */
+inline void web_assets_send(AsyncWebServerRequest *req, fs::FS &fs, const WebAsset &asset)
+{
+    const char *cache = asset.immutable ? "public, max-age=31536000, immutable" : "no-cache";
+
+    if (req->hasHeader("If-None-Match") &&
+        req->getHeader("If-None-Match")->value() == asset.etag.c_str())
+    {
+        AsyncWebServerResponse *res = req->beginResponse(304);
+        res->addHeader("ETag", asset.etag.c_str());
+        res->addHeader("Cache-Control", cache);
+        req->send(res);
+        return;
+    }
+
+    AsyncWebServerResponse *res = req->beginResponse(fs, asset.file.c_str(), asset.type.c_str());
+    res->addHeader("Content-Encoding", "gzip");
+    res->addHeader("ETag", asset.etag.c_str());
+    res->addHeader("Cache-Control", cache);
+    req->send(res);
+}
+
+/**
+ * @brief Registers a handler for every asset in the manifest.
+ *
+ * Falls back to serving the raw files from the filesystem root when no
+ * manifest is present, e.g. after an upload that skipped the asset pipeline.
+ *
+ * @return The number of URLs registered from the manifest (0 on fallback).
+ */
+inline size_t web_assets_register(AsyncWebServer &server, fs::FS &fs, const char *manifest_path = "/assets.json")
+{
+    static std::vector<WebAsset> assets;
+
+    File f = fs.open(manifest_path, "r");
+    if (!f)
+    {
+        Serial.println("WARN: No web asset manifest; serving raw files.");
+        server.serveStatic("/", fs, "/").setDefaultFile("index.html");
+        return 0;
+    }
+
+    DynamicJsonDocument doc(2048);
+    DeserializationError err = deserializeJson(doc, f);
+    f.close();
+    if (err)
+    {
+        Serial.printf("ERROR: Bad web asset manifest (%s); serving raw files.\n", err.c_str());
+        server.serveStatic("/", fs, "/").setDefaultFile("index.html");
+        return 0;
+    }
+
+    assets.clear();
+    for (JsonObjectConst a : doc["assets"].as<JsonArrayConst>())
+    {
+        assets.push_back({a["url"] | "", a["file"] | "", a["type"] | "text/plain",
+                          a["etag"] | "", a["immutable"] | false});
+    }
+
+    // The vector is no longer resized, so handlers may index into it.
+    for (size_t i = 0; i < assets.size(); ++i)
+    {
+        server.on(assets[i].url.c_str(), HTTP_GET, [&fs, i](AsyncWebServerRequest *req)
+                  { web_assets_send(req, fs, assets[i]); });
+    }
+    return assets.size();
+}
+
+#endif // __cplusplus
@@ -0,0 +1,181 @@
+# -----------------------------------------------------------------------------
+# Web Asset Pipeline
+#
+# Description:
+# Turns the hand-edited web UI sources in data/ (ESP2) and data_esp3/ (ESP3)
+# into the files that are actually flashed to LittleFS:
+#
+# 1. Every asset is lightly minified (comments and indentation stripped).
+# 2. CSS and JS get a content hash in their file name (style.1a2b3c4d.css)
+#    and index.html is rewritten to reference the hashed names, so browsers
+#    may cache them forever.
+# 3. Everything is gzip-compressed (deterministically, mtime 0).
+# 4. An assets.json manifest lists URL, stored file, MIME type, strong ETag
+#    and cache policy; include/web_assets.h serves from it.
+#
+# Output goes to .pio/webfs/<env>/, which the PlatformIO envs use as their
+# data_dir. The script runs automatically as a PlatformIO pre-script, or by
+# hand with:  python scripts/build_web_assets.py
+# -----------------------------------------------------------------------------
+
+import gzip
+import hashlib
+import json
+import os
+import re
+import shutil
+
+# --- FILE PATHS (ABSOLUTE) ---
+script_dir = os.path.dirname(os.path.abspath(__file__))
+project_root = os.path.dirname(script_dir)
+
+# PlatformIO env name -> source directory (relative to the project root)
+ASSET_SETS = {
+    "esp2": "data",
+    "esp3": "data_esp3",
+}
+OUTPUT_ROOT = os.path.join(project_root, ".pio", "webfs")
+MANIFEST_NAME = "assets.json"
+
+MIME_TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".json": "application/json",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+    ".png": "image/png",
+}
+
+# Only these get a hashed file name; index.html must keep a fixed URL.
+HASHED_EXTENSIONS = {".css", ".js"}
+
+
+# --- MINIFIERS ---
+# Deliberately conservative: gzip removes most redundancy anyway, and a
+# minifier that can break the firmware UI is not worth the last few bytes.
+
+def minify_css(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.DOTALL)
+    text = re.sub(r"\s+", " ", text)
+    text = re.sub(r"\s*([{}:;,>])\s*", r"\1", text)
+    return text.replace(";}", "}").strip()
+
+
+def minify_js(text):
+    # Block comments only when they start a line, so "/*" inside strings survives.
+    text = re.sub(r"^\s*/\*.*?\*/\s*$", "", text, flags=re.DOTALL | re.MULTILINE)
+    lines = []
+    for line in text.splitlines():
+        stripped = line.strip()
+        if not stripped or stripped.startswith("//"):
+            continue
+        lines.append(stripped)
+    # Keep line breaks: automatic semicolon insertion depends on them.
+    return "\n".join(lines)
+
+
+def minify_html(text):
+    text = re.sub(r"<!--.*?-->", "", text, flags=re.DOTALL)
+    return "\n".join(line.strip() for line in text.splitlines() if line.strip())
+
+
+MINIFIERS = {".css": minify_css, ".js": minify_js, ".html": minify_html}
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:8]
+
+
+def write_gzip(path, data):
+    # mtime=0 keeps the output byte-identical between builds.
+    with open(path, "wb") as raw:
+        with gzip.GzipFile(filename="", mode="wb", fileobj=raw, compresslevel=9, mtime=0) as gz:
+            gz.write(data)
+
+
+def build_asset_set(src_dir, out_dir):
+    """
+    Builds one LittleFS image directory. Returns the number of assets written.
+    """
+    if not os.path.isdir(src_dir):
+        print(f"ERROR: Asset source {src_dir} not found. Skipping.")
+        return 0
+
+    shutil.rmtree(out_dir, ignore_errors=True)
+    os.makedirs(out_dir)
+
+    # 1. Minify everything and hash the assets that may be renamed.
+    processed = {}
+    renames = {}
+    for name in sorted(os.listdir(src_dir)):
+        path = os.path.join(src_dir, name)
+        if not os.path.isfile(path):
+            continue
+        ext = os.path.splitext(name)[1].lower()
+        with open(path, "rb") as f:
+            data = f.read()
+        if ext in MINIFIERS:
+            data = MINIFIERS[ext](data.decode("utf-8")).encode("utf-8")
+        processed[name] = data
+        if ext in HASHED_EXTENSIONS:
+            stem = os.path.splitext(name)[0]
+            renames[name] = f"{stem}.{content_hash(data)}{ext}"
+
+    # 2. Point the HTML at the hashed names.
+    for name, data in processed.items():
+        if not name.endswith(".html"):
+            continue
+        text = data.decode("utf-8")
+        for old, new in renames.items():
+            text = re.sub(r'((?:href|src)=")' + re.escape(old) + r'"', r"\g<1>" + new + '"', text)
+        processed[name] = text.encode("utf-8")
+
+    # 3. Compress and describe every asset.
+    manifest = []
+    for name, data in processed.items():
+        ext = os.path.splitext(name)[1].lower()
+        served_name = renames.get(name, name)
+        stored = f"/{served_name}.gz"
+        write_gzip(os.path.join(out_dir, stored.lstrip("/")), data)
+
+        entry = {
+            "file": stored,
+            "type": MIME_TYPES.get(ext, "application/octet-stream"),
+            "etag": f'"{content_hash(data)}"',
+        }
+        urls = [(f"/{served_name}", name in renames)]
+        if name in renames:
+            urls.append((f"/{name}", False))  # Un-hashed alias for pages cached before this build
+        if name == "index.html":
+            urls.append(("/", False))
+        for url, immutable in urls:
+            manifest.append(dict(entry, url=url, immutable=immutable))
+
+        print(f"    {name:<12} -> {stored:<24} {len(data):6d} B minified")
+
+    with open(os.path.join(out_dir, MANIFEST_NAME), "w", encoding="utf-8") as f:
+        json.dump({"assets": manifest}, f, separators=(",", ":"))
+    return len(processed)
+
+
+def build(env_names):
+    print("--- Running Web Asset Pipeline ---")
+    for env_name in env_names:
+        src = os.path.join(project_root, ASSET_SETS[env_name])
+        out = os.path.join(OUTPUT_ROOT, env_name)
+        print(f"--> {ASSET_SETS[env_name]}/ -> {os.path.relpath(out, project_root)}/")
+        count = build_asset_set(src, out)
+        print(f"    SUCCESS: {count} assets.")
+    print("--- Asset pipeline complete. ---")
+
+
+# --- ENTRY POINTS ---
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    pio_env = env["PIOENV"]  # noqa: F821
+    if pio_env in ASSET_SETS:
+        build([pio_env])
+except NameError:
+    if __name__ == "__main__":
+        build(sorted(ASSET_SETS))
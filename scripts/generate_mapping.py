@@ -40,6 +40,10 @@ TYPE_INFO = {
     "uint8_t": {"size": 1}, "float": {"size": 4}
 }
 
+# uint8_t arrays that hold bitmasks: each byte becomes 8 bit signals.
+# Every other array gets one signal per element (e.g. rotary_pos).
+BITMASK_ARRAYS = {"button_matrix"}
+
 def parse_mydata_h():
     """
     Parses the source MyData.h file to extract the variable definitions
@@ -62,7 +66,7 @@ def parse_mydata_h():
     # This pattern finds all typedef union blocks for PROCBUFFER_IN or PROCBUFFER_OUT
     union_regex = re.compile(r'(typedef\s+union.*?PROCBUFFER_(?:IN|OUT);)', re.DOTALL)
     # This pattern finds the content inside the 'struct { ... } Cust;'
-    struct_content_regex = re.compile(r'struct\s*\{(.*?)\s*\} Cust;', re.DOTALL)
+    struct_content_regex = re.compile(r'struct(?:\s+__attribute__\(\(packed\)\))?\s*\{(.*?)\s*\} Cust;', re.DOTALL)
     # This pattern extracts individual variable declarations
     var_regex = re.compile(r"^\s*(\w+)\s+([\w_]+)(?:\[(\d+)\])?\s*;\s*(?://\s*(.*))?")
 
@@ -90,6 +94,33 @@ def parse_mydata_h():
 
     return in_map, out_map
 
+def byte_count(var_map):
+    """Sums the sizes of the variables, i.e. the packed size of the struct."""
+    total = 0
+    for item in var_map:
+        base_type = item['type'].split('[')[0]
+        count = int(item['type'].split('[')[1][:-1]) if '[' in item['type'] else 1
+        total += TYPE_INFO[base_type]["size"] * count
+    return total
+
+def check_sizes(in_map, out_map):
+    """
+    The offsets in the documentation are packed offsets. They only match the
+    firmware if MyData.h declares the same byte counts (its static_asserts
+    check the compiled struct against them). Returns False on a mismatch.
+    """
+    with open(SOURCE_H_FILE, 'r', encoding='utf-8') as f:
+        content = f.read()
+    ok = True
+    for direction, var_map in (("IN", in_map), ("OUT", out_map)):
+        match = re.search(rf'#define\s+CUST_BYTE_NUM_{direction}\s+(\d+)', content)
+        declared = int(match.group(1)) if match else None
+        packed = byte_count(var_map)
+        if declared != packed:
+            print(f"ERROR: {direction} variables add up to {packed} bytes, CUST_BYTE_NUM_{direction} is {declared}.")
+            ok = False
+    return ok
+
 def generate_hal_file(in_map, out_map):
     """Generates the hmi.hal template file for LinuxCNC."""
     print(f"--> Generating {HAL_PATH}...")
@@ -107,7 +138,7 @@ def generate_hal_file(in_map, out_map):
             base_type = item['type'].split('[')[0]
             if '[' in item['type']:
                 size = int(item['type'].split('[')[1][:-1])
-                if base_type == "uint8_t":
+                if base_type == "uint8_t" and name in BITMASK_ARRAYS:
                     for i in range(size):
                         for j in range(8):
                             f.write(f"net hmi-{name}-{i*8+j} <= easycat.0.pdo-in.{name}-{i}.{j}\n")
@@ -165,6 +196,10 @@ def main():
         print(f"WARNING: Could not parse any variables from {SOURCE_H_FILE}. Output files will be empty.")
         return
 
+    if not check_sizes(in_map, out_map):
+        print("ERROR: Fix MyData.h first; the generated offsets would be wrong. Aborting.")
+        return
+
     generate_hal_file(in_map, out_map)
     generate_markdown_table(in_map, out_map)
     
@@ -10,14 +10,14 @@
 //-------------------------------------------------------------------//
 
 #define CUST_BYTE_NUM_OUT 60
-#define CUST_BYTE_NUM_IN 103
+#define CUST_BYTE_NUM_IN 127
 #define TOT_BYTE_NUM_ROUND_OUT 60
-#define TOT_BYTE_NUM_ROUND_IN 104
+#define TOT_BYTE_NUM_ROUND_IN 128
 
 typedef union //---- output buffer ----
 {
 	uint8_t Byte[TOT_BYTE_NUM_ROUND_OUT];
-	struct
+	struct __attribute__((packed))
 	{
 		// --- Standard HMI Feedback ---
 		uint8_t led_matrix[8];	   // 64 LED states (8 bytes) for the main panel
@@ -42,10 +42,14 @@ typedef union //---- output buffer ----
 	} Cust;
 } PROCBUFFER_OUT;
 
+static_assert(sizeof(((PROCBUFFER_OUT *)0)->Cust) == CUST_BYTE_NUM_OUT, "PROCBUFFER_OUT layout does not match CUST_BYTE_NUM_OUT");
+static_assert(sizeof(PROCBUFFER_OUT) <= TOT_BYTE_NUM_ROUND_OUT, "PROCBUFFER_OUT exceeds the transferred output image");
+
 typedef union //---- input buffer ----
 {
 	uint8_t Byte[TOT_BYTE_NUM_ROUND_IN];
-	struct
+	// Packed: the EtherCAT image has no padding, fields sit at the offsets in mapping_doku.md
+	struct __attribute__((packed))
 	{
 		// --- ESP1 Peripherals ---
 		int32_t enc_pos[8];	  // Position of up to 8 encoders on ESP1
@@ -57,13 +61,24 @@ typedef union //---- input buffer ----
 		int16_t joystick_axes[6]; // 6 analog axes from up to 2 joysticks
 		int32_t hmi_enc_pos[8];	  // Position of up to 8 encoders on ESP2
 		uint8_t rotary_pos[4];	  // Position of up to 4 rotary switches
+		uint16_t key_event_seq;	  // Sequence number of the key event below; changes once per event
+		uint8_t key_event_type;	  // 0 none, 1 press, 2 release, 3 long press, 4 double tap, 5 chord
+		uint8_t key_event_key;	  // Key index (row * 8 + col) of the event; lowest key of a chord
+		uint32_t key_event_chord; // Chord key indices, one per byte from the LSB, 0xFF = unused
+		uint32_t key_event_time;  // Panel timestamp of the event in ms
 
 		// --- NEW: ESP3 (Handheld Pendant) Peripherals ---
 		int32_t pendant_handwheel_pos;	// Current count from the handwheel encoder
 		uint32_t pendant_button_states; // Bitmask for up to 25 pendant buttons
 		uint8_t pendant_selected_axis;	// Current position of the axis selector (0-5)
 		uint8_t pendant_selected_step;	// Current position of the step selector (0-3)
+		float pendant_feed_override;	// Feed override knob (e.g., 1.0 for 100%)
+		float pendant_rapid_override;	// Rapid override knob
+		float pendant_spindle_override; // Spindle override knob
 	} Cust;
 } PROCBUFFER_IN;
 
+static_assert(sizeof(((PROCBUFFER_IN *)0)->Cust) == CUST_BYTE_NUM_IN, "PROCBUFFER_IN layout does not match CUST_BYTE_NUM_IN");
+static_assert(sizeof(PROCBUFFER_IN) <= TOT_BYTE_NUM_ROUND_IN, "PROCBUFFER_IN exceeds the transferred input image");
+
 #endif
\ No newline at end of file
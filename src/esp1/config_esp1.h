@@ -59,4 +59,15 @@ const int ENCODER_B_PINS[NUM_ENCODERS] = {35, 33}; // GPIO pins for Channel B of
 // The interval in milliseconds at which to calculate a new RPM value.
 #define TACHO_UPDATE_INTERVAL_MS 500
 
+// --- MAIN PANEL KEY EVENTS ---
+// Key events from ESP2 are presented in the PDO one at a time. Each one is
+// held long enough for at least one servo-thread read before the next.
+#define KEY_EVENT_BUFFER_LEN 32 // Events taken over from ESP2 but not yet presented (power of 2)
+#define KEY_EVENT_HOLD_MS 4     // Minimum time each event stays in the PDO
+
+// --- MAIN PANEL LINK ---
+// ESP2 repeats its packet every 50 ms while a joystick is deflected. Without
+// any packet for this long the joystick axes are reported as centered.
+#define ESP2_JOYSTICK_TIMEOUT_MS 250
+
 #endif // CONFIG_ESP1_H
\ No newline at end of file
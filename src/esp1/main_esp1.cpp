@@ -16,6 +16,7 @@
 #include <Arduino.h>
 #include <esp_now.h>
 #include <WiFi.h>
+#include <esp_wifi.h>
 #include "config_esp1.h"
 #include "shared_structures.h"
 #include "ESP32Encoder.h"
@@ -42,6 +43,18 @@ unsigned long last_rpm_calc_time = 0;             // Timer for non-blocking RPM
 struct_message_from_esp2 incoming_esp2_data; // Buffer for data received from ESP2
 struct_message_from_esp3 incoming_esp3_data; // Buffer for data received from ESP3 (pendant)
 struct_message_to_hmi outgoing_lcnc_data;    // Buffer for data to be sent to both HMIs
+portMUX_TYPE esp2_mux = portMUX_INITIALIZER_UNLOCKED; // Guards incoming_esp2_data against the receive callback
+bool esp2_data_fresh = false;                         // A packet from ESP2 arrived since the last loop pass
+unsigned long esp2_last_packet_ms = 0;                // Loop time of the last packet from ESP2
+
+// Key events taken over from ESP2, waiting to be presented in the PDO
+PanelKeyEvent key_event_buffer[KEY_EVENT_BUFFER_LEN];
+static_assert((KEY_EVENT_BUFFER_LEN & (KEY_EVENT_BUFFER_LEN - 1)) == 0, "KEY_EVENT_BUFFER_LEN must be a power of 2");
+uint8_t key_event_head = 0;
+uint8_t key_event_count = 0;
+uint16_t key_event_epoch = 0;         // Epoch of the ESP2 event stream being followed
+uint16_t key_event_last_seq = 0;      // Highest sequence number taken over (= acknowledged)
+unsigned long key_event_shown_ms = 0; // When the current PDO event was presented
 
 // Conditional global variables based on sensor choice in config_esp1.h
 #if SPINDLE_SENSOR_TYPE == HALL_SENSOR
@@ -57,9 +70,12 @@ volatile uint32_t hall_pulse_count = 0; // Pulse counter for RPM, modified by an
  */
 void OnDataRecv(const uint8_t *mac_addr, const uint8_t *incomingData, int len)
 {
-    if (memcmp(mac_addr, esp2_mac_address, 6) == 0)
+    if (memcmp(mac_addr, esp2_mac_address, 6) == 0 && len == sizeof(incoming_esp2_data))
     {
+        portENTER_CRITICAL(&esp2_mux);
         memcpy(&incoming_esp2_data, incomingData, sizeof(incoming_esp2_data));
+        esp2_data_fresh = true;
+        portEXIT_CRITICAL(&esp2_mux);
     }
     else if (memcmp(mac_addr, esp3_mac_address, 6) == 0)
     {
@@ -78,6 +94,57 @@ void OnDataSent(const uint8_t *mac_addr, esp_now_send_status_t status)
     }
 }
 
+// --- MAIN PANEL KEY EVENTS ---
+
+/**
+ * @brief Takes over the new key events of an ESP2 packet and acknowledges them.
+ * Events taken over before are skipped. Only as many are taken as the buffer
+ * holds; the rest stay unacknowledged, so ESP2 keeps repeating them.
+ */
+void take_over_key_events(const struct_message_from_esp2 &data)
+{
+    if (data.key_event_epoch != key_event_epoch)
+    {
+        // ESP2 restarted: follow its new stream from the first event it offers.
+        key_event_epoch = data.key_event_epoch;
+        key_event_last_seq = (data.key_event_count ? data.key_events[0].seq : 1) - 1;
+    }
+
+    const uint8_t count = min<uint8_t>(data.key_event_count, KEY_EVENTS_PER_PACKET);
+    for (int i = 0; i < count && key_event_count < KEY_EVENT_BUFFER_LEN; i++)
+    {
+        const PanelKeyEvent &ev = data.key_events[i];
+        if ((int16_t)(ev.seq - key_event_last_seq) <= 0)
+            continue;
+        key_event_buffer[(key_event_head + key_event_count) & (KEY_EVENT_BUFFER_LEN - 1)] = ev;
+        key_event_count++;
+        key_event_last_seq = ev.seq;
+    }
+
+    outgoing_lcnc_data.key_event_epoch = key_event_epoch;
+    outgoing_lcnc_data.key_event_ack = key_event_last_seq;
+}
+
+/**
+ * @brief Moves the next buffered key event into the PDO once the current one
+ * has been visible for KEY_EVENT_HOLD_MS.
+ */
+void present_key_event()
+{
+    if (key_event_count == 0 || millis() - key_event_shown_ms < KEY_EVENT_HOLD_MS)
+        return;
+
+    const PanelKeyEvent &ev = key_event_buffer[key_event_head];
+    EASYCAT.BufferIn.Cust.key_event_seq = ev.seq;
+    EASYCAT.BufferIn.Cust.key_event_type = ev.type;
+    EASYCAT.BufferIn.Cust.key_event_key = ev.key;
+    EASYCAT.BufferIn.Cust.key_event_chord = ev.chord[0] | (ev.chord[1] << 8) | (ev.chord[2] << 16) | ((uint32_t)ev.chord[3] << 24);
+    EASYCAT.BufferIn.Cust.key_event_time = ev.time_ms;
+    key_event_head = (key_event_head + 1) & (KEY_EVENT_BUFFER_LEN - 1);
+    key_event_count--;
+    key_event_shown_ms = millis();
+}
+
 // --- INTERRUPT SERVICE ROUTINES (ISRs) ---
 #if SPINDLE_SENSOR_TYPE == HALL_SENSOR
 void IRAM_ATTR hall_sensor_isr() { hall_pulse_count++; }
@@ -100,7 +167,9 @@ void setup()
     Serial.println("Starting ESP1 - EtherCAT Bridge...");
 
     // -- 1. Initialize networking for ESP-NOW --
+    // Fixed channel: the panels reach ESP1 whether or not they are on Wi-Fi.
     WiFi.mode(WIFI_STA);
+    esp_wifi_set_channel(ESPNOW_CHANNEL, WIFI_SECOND_CHAN_NONE);
     esp_now_init();
     esp_now_register_recv_cb(OnDataRecv);
     esp_now_register_send_cb(OnDataSent);
@@ -204,13 +273,36 @@ void loop()
     EASYCAT.BufferIn.Cust.probe_states = probe_bitmask;
 
     // 4. Bridge data from ESP2 and ESP3 into the EtherCAT IN buffer.
-    memcpy(EASYCAT.BufferIn.Cust.button_matrix, incoming_esp2_data.button_matrix_states, sizeof(EASYCAT.BufferIn.Cust.button_matrix));
-    memcpy(EASYCAT.BufferIn.Cust.joystick_axes, incoming_esp2_data.joystick_values, sizeof(EASYCAT.BufferIn.Cust.joystick_axes));
+    struct_message_from_esp2 esp2_data;
+    portENTER_CRITICAL(&esp2_mux);
+    esp2_data = incoming_esp2_data;
+    const bool esp2_fresh = esp2_data_fresh;
+    esp2_data_fresh = false;
+    portEXIT_CRITICAL(&esp2_mux);
+    if (esp2_fresh)
+    {
+        take_over_key_events(esp2_data);
+        esp2_last_packet_ms = millis();
+    }
+    else if (millis() - esp2_last_packet_ms > ESP2_JOYSTICK_TIMEOUT_MS)
+    {
+        // Link lost: never keep jogging on the last deflection ESP2 sent
+        memset(esp2_data.joystick_values, 0, sizeof(esp2_data.joystick_values));
+    }
+    present_key_event();
+
+    memcpy(EASYCAT.BufferIn.Cust.button_matrix, esp2_data.button_matrix_states, sizeof(EASYCAT.BufferIn.Cust.button_matrix));
+    memcpy(EASYCAT.BufferIn.Cust.joystick_axes, esp2_data.joystick_values, sizeof(EASYCAT.BufferIn.Cust.joystick_axes));
+    memcpy(EASYCAT.BufferIn.Cust.hmi_enc_pos, esp2_data.encoder_counts, sizeof(EASYCAT.BufferIn.Cust.hmi_enc_pos));
+    memcpy(EASYCAT.BufferIn.Cust.rotary_pos, esp2_data.rotary_positions, sizeof(EASYCAT.BufferIn.Cust.rotary_pos));
 
     EASYCAT.BufferIn.Cust.pendant_handwheel_pos = incoming_esp3_data.handwheel_position;
     EASYCAT.BufferIn.Cust.pendant_button_states = incoming_esp3_data.button_states;
     EASYCAT.BufferIn.Cust.pendant_selected_axis = incoming_esp3_data.selected_axis;
     EASYCAT.BufferIn.Cust.pendant_selected_step = incoming_esp3_data.selected_step;
+    EASYCAT.BufferIn.Cust.pendant_feed_override = incoming_esp3_data.feed_override_position;
+    EASYCAT.BufferIn.Cust.pendant_rapid_override = incoming_esp3_data.rapid_override_position;
+    EASYCAT.BufferIn.Cust.pendant_spindle_override = incoming_esp3_data.spindle_override_position;
 
     // 5. Bridge data from the EtherCAT OUT buffer to both HMIs.
     memcpy(outgoing_lcnc_data.led_matrix_states, EASYCAT.BufferOut.Cust.led_matrix, sizeof(outgoing_lcnc_data.led_matrix_states));
@@ -0,0 +1,268 @@
+/**
+ * @file action_bindings.cpp
+ * @brief Implements the binding compiler and the edge/level rule evaluator.
+ */
+
+#include "action_bindings.h"
+#include <Arduino.h>
+
+// --- INTERNAL DATA STRUCTURES ---
+
+// Bitset outputs a rule can set or clear. The joystick scale is a value, handled separately.
+enum OutputBits : uint8_t
+{
+    OUT_JOYSTICKS_DISABLED,
+    OUT_GROUPS_DISABLED,
+    OUT_LEDS_ON,
+    OUT_LEDS_BLINKING,
+    OUT_SCALE, // Not a bitset; `arg` is the percentage
+    OUT_BITSET_COUNT = OUT_SCALE
+};
+
+struct CompiledRule
+{
+    uint8_t output; // OutputBits
+    bool set;       // Set or clear the bit (always true for OUT_SCALE)
+    uint8_t arg;    // Bit index within the output, or the scale percentage
+};
+
+// Rules of one trigger mode, bucketed by trigger bit: the rules for bit b
+// are rules[start[b]] .. rules[start[b + 1] - 1], in configuration order.
+struct RuleTable
+{
+    uint32_t mask; // Trigger bits that have at least one rule
+    uint8_t start[33];
+    CompiledRule rules[MAX_ACTION_BINDINGS];
+};
+
+struct OutputState
+{
+    uint64_t bits[OUT_BITSET_COUNT];
+    int16_t scale; // -1 = no rule sets it
+};
+
+// --- MODULE STATE ---
+static portMUX_TYPE bindings_mux = portMUX_INITIALIZER_UNLOCKED;
+static RuleTable tables[3]; // Indexed by TriggerMode
+static OutputState latched; // Effects of edge rules; persist until changed by another edge
+static OutputState level;   // Effects of level rules whose trigger bit is currently set
+static uint64_t level_clear[OUT_BITSET_COUNT];
+static const uint8_t DEFAULT_SCALE_PCT = 100;
+static BindingOutputs published = {0, 0, 0, 0, DEFAULT_SCALE_PCT};
+static uint32_t last_state = 0;
+static bool have_state = false;
+
+// --- COMPILER ---
+
+/**
+ * @brief Translates one binding into an output operation.
+ * @return false for bindings that do nothing (NO_ACTION, bad parameters).
+ */
+static bool compile_rule(const ActionBinding &b, CompiledRule &out)
+{
+    switch (b.action)
+    {
+    case ENABLE_JOYSTICK_1:
+        out = {OUT_JOYSTICKS_DISABLED, false, 0};
+        return true;
+    case DISABLE_JOYSTICK_1:
+        out = {OUT_JOYSTICKS_DISABLED, true, 0};
+        return true;
+    case ENABLE_BUTTON_GROUP:
+    case DISABLE_BUTTON_GROUP:
+        if (b.param == 0 || b.param > 31)
+            return false; // Group 0 means "no group"
+        out = {OUT_GROUPS_DISABLED, b.action == DISABLE_BUTTON_GROUP, b.param};
+        return true;
+    case LED_ON:
+    case LED_OFF:
+        if (b.param >= MAX_LEDS)
+            return false;
+        out = {OUT_LEDS_ON, b.action == LED_ON, b.param};
+        return true;
+    case LED_BLINK:
+    case LED_STEADY:
+        if (b.param >= MAX_LEDS)
+            return false;
+        out = {OUT_LEDS_BLINKING, b.action == LED_BLINK, b.param};
+        return true;
+    case SET_JOYSTICK_SCALE:
+        out = {OUT_SCALE, true, b.param};
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void reset_outputs(OutputState &s)
+{
+    memset(s.bits, 0, sizeof(s.bits));
+    s.scale = -1;
+}
+
+// --- EVALUATION HELPERS (called with bindings_mux held) ---
+
+static void apply(OutputState &s, const CompiledRule &r)
+{
+    if (r.output == OUT_SCALE)
+        s.scale = r.arg;
+    else if (r.set)
+        s.bits[r.output] |= 1ULL << r.arg;
+    else
+        s.bits[r.output] &= ~(1ULL << r.arg);
+}
+
+static void apply_edges(const RuleTable &t, uint32_t edges)
+{
+    edges &= t.mask;
+    while (edges)
+    {
+        int bit = __builtin_ctz(edges);
+        edges &= edges - 1;
+        for (int i = t.start[bit]; i < t.start[bit + 1]; ++i)
+            apply(latched, t.rules[i]);
+    }
+}
+
+// Level rules are additive: a "set" rule sets while active, a "clear" rule
+// masks the bit out. Clears win over sets and over latched state.
+static void rebuild_level(uint32_t state)
+{
+    const RuleTable &t = tables[TRIGGER_LEVEL];
+    reset_outputs(level);
+    memset(level_clear, 0, sizeof(level_clear));
+
+    uint32_t active = state & t.mask;
+    while (active)
+    {
+        int bit = __builtin_ctz(active);
+        active &= active - 1;
+        for (int i = t.start[bit]; i < t.start[bit + 1]; ++i)
+        {
+            const CompiledRule &r = t.rules[i];
+            if (r.output == OUT_SCALE)
+                level.scale = r.arg;
+            else if (r.set)
+                level.bits[r.output] |= 1ULL << r.arg;
+            else
+                level_clear[r.output] |= 1ULL << r.arg;
+        }
+    }
+}
+
+static void publish()
+{
+    uint64_t out[OUT_BITSET_COUNT];
+    for (int i = 0; i < OUT_BITSET_COUNT; ++i)
+        out[i] = (latched.bits[i] | level.bits[i]) & ~level_clear[i];
+
+    published.joysticks_disabled = (uint32_t)out[OUT_JOYSTICKS_DISABLED];
+    published.groups_disabled = (uint32_t)out[OUT_GROUPS_DISABLED];
+    published.leds_on = out[OUT_LEDS_ON];
+    published.leds_blinking = out[OUT_LEDS_BLINKING];
+    published.joystick_scale_pct = level.scale >= 0     ? level.scale
+                                   : latched.scale >= 0 ? latched.scale
+                                                        : DEFAULT_SCALE_PCT;
+}
+
+// --- PUBLIC API ---
+
+void action_bindings_compile(const ActionBinding *bindings, int count)
+{
+    // Bucket sort by trigger bit, per mode, keeping configuration order.
+    RuleTable fresh[3] = {};
+    uint8_t per_bit[3][32] = {};
+    CompiledRule compiled[MAX_ACTION_BINDINGS];
+    bool usable[MAX_ACTION_BINDINGS] = {};
+
+    count = min(count, MAX_ACTION_BINDINGS);
+    for (int i = 0; i < count; ++i)
+    {
+        const ActionBinding &b = bindings[i];
+        if (!b.is_active || (unsigned)b.trigger > 31 || (unsigned)b.mode > TRIGGER_FALLING)
+            continue;
+        if (!compile_rule(b, compiled[i]))
+            continue;
+        usable[i] = true;
+        per_bit[b.mode][b.trigger]++;
+        fresh[b.mode].mask |= 1UL << b.trigger;
+    }
+
+    uint8_t fill[3][32];
+    for (int m = 0; m < 3; ++m)
+    {
+        fresh[m].start[0] = 0;
+        for (int bit = 0; bit < 32; ++bit)
+        {
+            fill[m][bit] = fresh[m].start[bit];
+            fresh[m].start[bit + 1] = fresh[m].start[bit] + per_bit[m][bit];
+        }
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        if (!usable[i])
+            continue;
+        const ActionBinding &b = bindings[i];
+        fresh[b.mode].rules[fill[b.mode][b.trigger]++] = compiled[i];
+    }
+
+    portENTER_CRITICAL(&bindings_mux);
+    memcpy(tables, fresh, sizeof(tables));
+    reset_outputs(latched);
+    reset_outputs(level);
+    memset(level_clear, 0, sizeof(level_clear));
+    have_state = false; // Re-derive level outputs from the next packet; no edges on it
+    publish();
+    portEXIT_CRITICAL(&bindings_mux);
+
+    if (DEBUG_ENABLED)
+        Serial.printf("Action bindings compiled: %d level, %d rising, %d falling.\n",
+                      fresh[TRIGGER_LEVEL].start[32], fresh[TRIGGER_RISING].start[32],
+                      fresh[TRIGGER_FALLING].start[32]);
+}
+
+void action_bindings_evaluate(uint16_t machine_status, uint16_t spindle_coolant_status)
+{
+    const uint32_t state = machine_status | ((uint32_t)spindle_coolant_status << 16);
+
+    portENTER_CRITICAL(&bindings_mux);
+    const uint32_t changed = state ^ last_state;
+    if (have_state && changed == 0)
+    {
+        portEXIT_CRITICAL(&bindings_mux);
+        return;
+    }
+
+    // The first packet after boot or a recompile only establishes the
+    // baseline: a bit that is already set is not an edge.
+    bool dirty = !have_state;
+    if (have_state)
+    {
+        const uint32_t edge_bits = changed & (tables[TRIGGER_RISING].mask | tables[TRIGGER_FALLING].mask);
+        if (edge_bits)
+        {
+            apply_edges(tables[TRIGGER_RISING], changed & state);
+            apply_edges(tables[TRIGGER_FALLING], changed & ~state);
+            dirty = true;
+        }
+    }
+    if (!have_state || (changed & tables[TRIGGER_LEVEL].mask))
+    {
+        rebuild_level(state);
+        dirty = true;
+    }
+    if (dirty)
+        publish();
+
+    last_state = state;
+    have_state = true;
+    portEXIT_CRITICAL(&bindings_mux);
+}
+
+BindingOutputs action_bindings_outputs()
+{
+    portENTER_CRITICAL(&bindings_mux);
+    BindingOutputs out = published;
+    portEXIT_CRITICAL(&bindings_mux);
+    return out;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file action_bindings.h
+ * @brief Compiled evaluation of the user-defined action bindings (ESP2).
+ *
+ * The binding list from the web config is compiled once, at boot and after
+ * every config save, into per-trigger-bit rule tables for each trigger mode.
+ * The two LinuxCNC status words are merged into one 32-bit state (bits 16-31
+ * are spindle_coolant_status, matching TriggerType). Each packet is then
+ * evaluated with an XOR against the previous state, and only rules whose
+ * trigger bit changed are visited. An unchanged status costs one compare,
+ * however many rules are configured.
+ */
+
+#ifndef ACTION_BINDINGS_H
+#define ACTION_BINDINGS_H
+
+#include <stdint.h>
+#include "persistence.h"
+
+/**
+ * @brief The combined effect of all bindings, consumed by the HMI handler.
+ */
+struct BindingOutputs
+{
+    uint32_t joysticks_disabled; // Bit n: joystick n reports zero
+    uint32_t groups_disabled;    // Bit n: presses of buttons in radio group n are ignored
+    uint64_t leds_on;            // Bit (row * MATRIX_COLS + col): LED forced on
+    uint64_t leds_blinking;      // Same indexing; LED blinks regardless of its source
+    uint8_t joystick_scale_pct;  // Applied on top of each axis' sensitivity
+};
+
+/**
+ * @brief Compiles a binding list into rule tables and resets all outputs.
+ * Safe to call while packets are being evaluated.
+ * @param bindings The bindings to compile, usually web_cfg.bindings.
+ * @param count Number of entries in @p bindings.
+ */
+void action_bindings_compile(const ActionBinding *bindings, int count);
+
+/**
+ * @brief Applies the rules to a new machine state.
+ * Cheap enough to run from the ESP-NOW receive callback.
+ */
+void action_bindings_evaluate(uint16_t machine_status, uint16_t spindle_coolant_status);
+
+/**
+ * @brief Returns a consistent snapshot of the current outputs.
+ */
+BindingOutputs action_bindings_outputs();
+
+#endif // ACTION_BINDINGS_H
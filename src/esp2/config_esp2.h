@@ -18,6 +18,12 @@
 #define WIFI_SSID "Your_SSID"
 #define WIFI_PASSWORD "Your_Password"
 #define OTA_HOSTNAME "linuxcnc-hmi"
+#define WIFI_CONNECT_TIMEOUT_MS 15000 // One scan or join; the panel runs regardless
+#define WIFI_RETRY_MIN_MS 2000        // Backoff after the first failed attempt, doubled per failure
+#define WIFI_RETRY_MAX_MS 60000       // Backoff cap between scans of ESPNOW_CHANNEL
+#define WIFI_AP_FALLBACK_MS 20000     // Without Wi-Fi this long, open the configuration soft-AP
+#define WIFI_AP_SSID OTA_HOSTNAME
+#define WIFI_AP_PASSWORD "linuxcnc"   // At least 8 characters, or "" for an open AP
 
 // --- GPIO ASSIGNMENT ---
 // SPI pins for MCP23S17 I/O Expanders (Standard VSPI).
@@ -25,6 +31,11 @@
 #define PIN_MCP_MISO 19
 #define PIN_MCP_SCK 18
 #define PIN_MCP_CS 5 // Shared Chip Select pin for all MCPs.
+#define MCP_SPI_CLOCK_HZ 8000000 // MCP23S17 max is 10 MHz; leave margin for the level shifters
+#define MATRIX_SCAN_BENCHMARK 0   // 1 = time the button matrix scan at boot and print the rate
+#define PIN_MCP_BUTTONS_INT 16    // INTA/INTB (mirrored) of the button MCP; -1 = not wired, always scan
+#define MATRIX_IDLE_SCANS 4        // Quiet scans before the matrix sleeps on interrupt-on-change
+#define MATRIX_SCAN_INTERVAL_MS 5  // A key must read the same for 4 scans: 20 ms debounce
 
 // Control pin for the TXS0108E Level Shifters' Output Enable.
 #define PIN_LEVEL_SHIFTER_OE 4
@@ -33,10 +44,48 @@
 #define NUM_POTIS 6
 const int POTI_PINS[NUM_POTIS] = {36, 39, 32, 33, 35, 34}; // Physical ADC pins.
 
+// --- JOYSTICK ACQUISITION ---
+// The pots are sampled by the ADC in continuous (DMA) mode and averaged in blocks:
+// 20 kHz over 6 pots / 16 = ~200 filtered values per pot and second.
+#define JOYSTICK_ADC_SAMPLE_HZ 20000     // All pots together; 20 kHz is the ESP32's DMA minimum
+#define JOYSTICK_OVERSAMPLE 16           // Conversions averaged per block
+#define JOYSTICK_FILTER_MEDIAN 1         // 1 = median of the last 3 blocks before the IIR
+#define JOYSTICK_FILTER_IIR_SHIFT 2      // IIR weight 1/2^n per block; 0 = no IIR
+#define JOYSTICK_REST_BLOCKS 32          // Blocks averaged at start-up as each pot's rest position
+#define JOYSTICK_DEADZONE_HYSTERESIS 16  // Raw counts beyond the deadzone needed to leave it again
+#define JOYSTICK_CHANGE_THRESHOLD 4      // Output steps (of +/-512) a value must move to be sent
+#define JOYSTICK_MAX_SEND_HZ 50          // Packets/s caused by joystick motion alone
+#define JOYSTICK_REFRESH_MS 50           // Full packet repeat while a stick is deflected or a send failed
+#define JOYSTICK_LUT_SHIFT 2             // Response table entry per 2^n raw counts (1024 entries/axis)
+#define JOYSTICK_LUT_SIZE (4096 >> JOYSTICK_LUT_SHIFT)
+#define JOYSTICK_CAL_MIN_SPAN 400        // Raw counts each side of center a calibration must cover
+
 // --- ROTARY ENCODERS (ESP2) ---
 #define NUM_ENCODERS_ESP2 2
 const int ENC2_A_PINS[NUM_ENCODERS_ESP2] = {25, 26}; // Example pins
 const int ENC2_B_PINS[NUM_ENCODERS_ESP2] = {27, 14}; // Example pins
+#define HMI_ENCODER_MAX_SEND_HZ 100 // Packets/s caused by encoder motion alone
+
+// --- ROTARY SWITCHES (ESP2) ---
+// Switches sit on the MCP23S17 at MCP_ADDR_ROT_SWITCHES (inputs 0-7 = GPA0-7,
+// 8-15 = GPB0-7, pulled up). An N-position switch uses N-1 consecutive
+// inputs, one per position from 1 on; position 0 is "no input low".
+#define NUM_ROTARY_SWITCHES 4
+#define ROTARY_SWITCH_POLL_MS 10      // Read interval of the switch inputs
+#define ROTARY_SWITCH_STABLE_READS 3  // Equal reads before a new position counts (break-before-make gap)
+
+struct RotarySwitchConfig
+{
+    uint8_t first_input; // Input of position 1
+    uint8_t positions;   // Number of positions, 2..8
+};
+
+const RotarySwitchConfig rotary_switch_configs[NUM_ROTARY_SWITCHES] = {
+    {0, 5},  // Inputs 0-3
+    {4, 5},  // Inputs 4-7
+    {8, 5},  // Inputs 8-11
+    {12, 5}, // Inputs 12-15
+};
 
 // --- I/O EXPANDER HARDWARE ADDRESSES ---
 // Hardware addresses (A0-A2) set on the MCP23S17 chips.
@@ -51,6 +100,41 @@ const int ENC2_B_PINS[NUM_ENCODERS_ESP2] = {27, 14}; // Example pins
 #define MAX_BUTTONS (MATRIX_ROWS * MATRIX_COLS)
 #define MAX_LEDS (MATRIX_ROWS * MATRIX_COLS)
 
+// --- KEY EVENTS ---
+// Debounced edges become timestamped events that are repeated to ESP1 until
+// it acknowledges them. Gestures are recognized on top of the raw edges.
+#define KEY_EVENT_QUEUE_LEN 32       // Unacknowledged events held for ESP1 (power of 2)
+#define KEY_EVENT_RETRY_MS 20        // Resend interval while events are unacknowledged
+#define KEY_EVENT_MAX_AGE_MS 2000    // Older undelivered events are dropped, not replayed late
+#define KEY_LONG_PRESS_MS 600        // Hold time for a long press
+#define KEY_DOUBLE_TAP_MS 300        // Release-to-press gap for a double tap
+#define KEY_CHORD_WINDOW_MS 80       // Presses this close together form a chord
+
+// --- LED MATRIX REFRESH ---
+// Columns are multiplexed by a dedicated task with bit-angle modulation: a
+// column is lit for (2^LED_PWM_BITS - 1) time units, split into one slice
+// per brightness bit. 3 bits at 100 us give 8 columns x 700 us = ~178 Hz.
+#define LED_PWM_BITS 3               // Brightness levels per LED = 2^LED_PWM_BITS
+#define LED_PWM_UNIT_US 100          // Length of the least significant bit slice
+#define LED_REFRESH_TASK_PRIORITY 5  // Above the input task, below the Wi-Fi/ESP-NOW tasks
+#define LED_REFRESH_CORE 1           // Panel I/O core; core 0 belongs to the radio
+#define LED_BLINK_MS 250             // Half period of the blink pattern (and of binding blinks)
+#define LED_PULSE_PERIOD_MS 1500     // Full period of the pulse (breathing) pattern
+
+// --- TASKS ---
+// Core 1 runs the panel I/O (input scan and LED refresh), so its timing does
+// not depend on the radio or on how many browsers are connected. Core 0
+// runs Wi-Fi, ESP-NOW and the web server next to the comms and web tasks.
+#define INPUT_TASK_PRIORITY 4        // Scan, joysticks, encoders, switches, key events
+#define INPUT_TASK_CORE 1
+#define INPUT_TASK_PERIOD_MS 1       // Pass interval; the matrix itself is scanned every MATRIX_SCAN_INTERVAL_MS
+#define COMMS_TASK_PRIORITY 3        // ESP-NOW send/receive processing, bindings, LED states
+#define COMMS_TASK_CORE 0
+#define WEB_TASK_PRIORITY 1          // Wi-Fi join, live status, calibration status, task stats
+#define WEB_TASK_CORE 0
+#define WEB_TASK_PERIOD_MS 50        // Live status goes out at most this often
+#define TASK_STATS_REPORT_MS 5000    // Interval of the per-task CPU report
+
 // --- HMI ELEMENT DEFINITIONS ---
 
 // Defines the source of an LED's state, used in the dynamic web config.
@@ -61,6 +145,17 @@ enum LedBinding
     BOUND_TO_LCNC    // LED state is controlled by a bit from LinuxCNC
 };
 
+// How a lit LED is shown; rendered locally so LinuxCNC only sends a steady bit.
+// Values are stored in NVS and must keep their numbers.
+enum LedPattern
+{
+    LED_PATTERN_STEADY,
+    LED_PATTERN_BLINK,      // On/off every LED_BLINK_MS
+    LED_PATTERN_FAST_BLINK, // Twice as fast
+    LED_PATTERN_PULSE,      // Fades in and out over LED_PULSE_PERIOD_MS
+    LED_PATTERN_COUNT
+};
+
 // Defines special actions a button can perform in addition to its normal function.
 enum class ButtonExtraAction
 {
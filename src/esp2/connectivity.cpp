@@ -0,0 +1,213 @@
+/**
+ * @file connectivity.cpp
+ * @brief Implements the station join state machine and the soft-AP fallback.
+ */
+
+#include "connectivity.h"
+#include <WiFi.h>
+#include <esp_wifi.h>
+#include "shared_structures.h"
+
+enum LinkState
+{
+    LINK_WAITING,   // Backing off before the next join attempt
+    LINK_SCANNING,  // Looking for WIFI_SSID on ESPNOW_CHANNEL only
+    LINK_JOINING,   // WiFi.begin() issued, waiting for the association
+    LINK_CONNECTED, // Associated on ESPNOW_CHANNEL
+    LINK_STOPPED,   // The AP is on another channel; no more attempts until reboot
+};
+
+// --- MODULE STATE ---
+static LinkState state = LINK_WAITING;
+static unsigned long state_since_ms = 0;
+static unsigned long retry_delay_ms = 0; // 0 = join at once
+static unsigned long offline_since_ms = 0;
+static bool ap_active = false;
+static volatile bool join_failed = false; // Set by the Wi-Fi event task, see on_sta_disconnected()
+
+// --- HELPERS ---
+
+// Runs in the Wi-Fi event task. A failed association or authentication ends
+// the attempt at once instead of after WIFI_CONNECT_TIMEOUT_MS.
+// ASSOC_LEAVE is our own WiFi.disconnect() and says nothing about the join.
+static void on_sta_disconnected(arduino_event_id_t event, arduino_event_info_t info)
+{
+    (void)event;
+    if (info.wifi_sta_disconnected.reason != WIFI_REASON_ASSOC_LEAVE)
+        join_failed = true;
+}
+
+static void enter_state(LinkState next, unsigned long now)
+{
+    state = next;
+    state_since_ms = now;
+}
+
+// A dropped association can leave the radio elsewhere.
+static void pin_espnow_channel()
+{
+    if (!ap_active)
+        esp_wifi_set_channel(ESPNOW_CHANNEL, WIFI_SECOND_CHAN_NONE);
+}
+
+static void fail_attempt(unsigned long now)
+{
+    WiFi.disconnect();
+    pin_espnow_channel();
+    retry_delay_ms = retry_delay_ms ? min<unsigned long>(retry_delay_ms * 2, WIFI_RETRY_MAX_MS) : WIFI_RETRY_MIN_MS;
+    if (DEBUG_ENABLED)
+        Serial.printf("WiFi: not connected, next attempt in %lu ms.\n", retry_delay_ms);
+    enter_state(LINK_WAITING, now);
+}
+
+// The AP left ESPNOW_CHANNEL after we joined (a channel switch of the
+// router). Retrying can only find it there again, so give up for good.
+static void stop_joining(unsigned long now)
+{
+    if (DEBUG_ENABLED)
+        Serial.printf("WiFi: access point moved to channel %d, ESP-NOW needs %d; "
+                      "not retrying until reboot.\n",
+                      (int)WiFi.channel(), ESPNOW_CHANNEL);
+    WiFi.disconnect();
+    pin_espnow_channel();
+    offline_since_ms = now;
+    enter_state(LINK_STOPPED, now);
+}
+
+// Joins the strongest WIFI_SSID the scan saw on ESPNOW_CHANNEL, pinned to its
+// BSSID and channel so the association can't end up anywhere else.
+static void join_scanned_ap(int16_t found, unsigned long now)
+{
+    int best = -1;
+    for (int16_t i = 0; i < found; i++)
+    {
+        if (WiFi.SSID(i) == WIFI_SSID && WiFi.channel(i) == ESPNOW_CHANNEL &&
+            (best < 0 || WiFi.RSSI(i) > WiFi.RSSI(best)))
+            best = i;
+    }
+
+    if (best < 0)
+    {
+        WiFi.scanDelete();
+        if (DEBUG_ENABLED)
+            Serial.printf("WiFi: \"%s\" not seen on channel %d.\n", WIFI_SSID, ESPNOW_CHANNEL);
+        fail_attempt(now);
+        return;
+    }
+
+    uint8_t bssid[6];
+    memcpy(bssid, WiFi.BSSID(best), sizeof(bssid));
+    WiFi.scanDelete();
+    join_failed = false;
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD, ESPNOW_CHANNEL, bssid);
+    enter_state(LINK_JOINING, now);
+}
+
+static void update_soft_ap(unsigned long now)
+{
+    if (!ap_active && state != LINK_CONNECTED && now - offline_since_ms >= WIFI_AP_FALLBACK_MS)
+    {
+        const char *password = strlen(WIFI_AP_PASSWORD) ? WIFI_AP_PASSWORD : nullptr;
+        ap_active = WiFi.softAP(WIFI_AP_SSID, password, ESPNOW_CHANNEL);
+        if (DEBUG_ENABLED && ap_active)
+            Serial.printf("WiFi: configuration AP \"%s\" up at %s\n", WIFI_AP_SSID,
+                          WiFi.softAPIP().toString().c_str());
+    }
+    else if (ap_active && state == LINK_CONNECTED && WiFi.softAPgetStationNum() == 0)
+    {
+        WiFi.softAPdisconnect(true);
+        ap_active = false;
+        if (DEBUG_ENABLED)
+            Serial.println("WiFi: configuration AP closed.");
+    }
+}
+
+// --- PUBLIC API ---
+
+void connectivity_init()
+{
+    WiFi.mode(WIFI_STA);
+    WiFi.setHostname(OTA_HOSTNAME);
+    WiFi.setAutoReconnect(false); // Rejoins are paced by connectivity_poll()
+    WiFi.onEvent(on_sta_disconnected, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    pin_espnow_channel();
+    offline_since_ms = millis();
+    enter_state(LINK_WAITING, offline_since_ms);
+}
+
+void connectivity_poll()
+{
+    const unsigned long now = millis();
+    const bool associated = WiFi.status() == WL_CONNECTED;
+
+    switch (state)
+    {
+    case LINK_WAITING:
+        // The scan never leaves ESPNOW_CHANNEL, so ESP-NOW and the soft-AP
+        // clients stay reachable while it runs.
+        if (now - state_since_ms >= retry_delay_ms)
+        {
+            if (WiFi.scanNetworks(/*async=*/true, /*show_hidden=*/false, /*passive=*/false,
+                                  /*max_ms_per_chan=*/300, ESPNOW_CHANNEL) == WIFI_SCAN_RUNNING)
+                enter_state(LINK_SCANNING, now);
+            else
+                fail_attempt(now);
+        }
+        break;
+
+    case LINK_SCANNING:
+    {
+        const int16_t found = WiFi.scanComplete();
+        if (found >= 0)
+        {
+            join_scanned_ap(found, now);
+        }
+        else if (found != WIFI_SCAN_RUNNING || now - state_since_ms >= WIFI_CONNECT_TIMEOUT_MS)
+        {
+            WiFi.scanDelete();
+            fail_attempt(now);
+        }
+        break;
+    }
+
+    case LINK_JOINING:
+        if (associated && WiFi.channel() == ESPNOW_CHANNEL)
+        {
+            retry_delay_ms = 0;
+            enter_state(LINK_CONNECTED, now);
+            if (DEBUG_ENABLED)
+                Serial.printf("WiFi Connected. IP: %s\n", WiFi.localIP().toString().c_str());
+        }
+        else if (associated)
+        {
+            stop_joining(now);
+        }
+        else if (join_failed || now - state_since_ms >= WIFI_CONNECT_TIMEOUT_MS)
+        {
+            fail_attempt(now);
+        }
+        break;
+
+    case LINK_CONNECTED:
+        if (!associated)
+        {
+            // Try again at once; the backoff only starts if that fails.
+            if (DEBUG_ENABLED)
+                Serial.println("WiFi: connection lost.");
+            WiFi.disconnect();
+            pin_espnow_channel();
+            offline_since_ms = now;
+            enter_state(LINK_WAITING, now);
+        }
+        else if (WiFi.channel() != ESPNOW_CHANNEL)
+        {
+            stop_joining(now);
+        }
+        break;
+
+    case LINK_STOPPED:
+        break;
+    }
+
+    update_soft_ap(now);
+}
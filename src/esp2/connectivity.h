@@ -0,0 +1,38 @@
+/**
+ * @file connectivity.h
+ * @brief Background Wi-Fi join and configuration soft-AP (ESP2).
+ *
+ * The panel does not wait for the network: ESP-NOW runs on ESPNOW_CHANNEL
+ * from boot on, and the station join is retried in the background with
+ * exponential backoff. The radio can only be on one channel and ESP1 does
+ * not follow, so only access points on ESPNOW_CHANNEL are accepted and the
+ * join never leaves it to look elsewhere: each attempt scans ESPNOW_CHANNEL
+ * alone and calls WiFi.begin() only when WIFI_SSID was seen there, pinned
+ * to that AP's BSSID. If the AP still ends up on another channel (the
+ * router switched channels), joining stops until reboot instead of
+ * dragging the radio away again on every retry.
+ *
+ * Without Wi-Fi for WIFI_AP_FALLBACK_MS a soft-AP on the same channel
+ * serves the web configuration; it closes once the station is back and no
+ * client is connected to it.
+ */
+
+#ifndef CONNECTIVITY_H
+#define CONNECTIVITY_H
+
+#include <Arduino.h>
+#include "config_esp2.h"
+
+/**
+ * @brief Starts the radio in station mode on ESPNOW_CHANNEL without joining.
+ * Call before esp_now_init().
+ */
+void connectivity_init();
+
+/**
+ * @brief Advances the join, backoff and soft-AP logic. Never blocks;
+ * call periodically from a low-priority task.
+ */
+void connectivity_poll();
+
+#endif // CONNECTIVITY_H
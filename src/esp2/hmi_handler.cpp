@@ -2,194 +2,282 @@
  * @file hmi_handler.cpp
  * @brief Implements the core logic for managing all HMI peripherals for the Main Panel (ESP2).
  *
- * This file contains the state machine for debouncing the button matrix,
- * the processing pipeline for the analog joysticks, the multiplexing
- * logic for driving the physical LED matrix, and the evaluation logic for
- * user-defined action bindings.
+ * This file contains the vertical-counter debouncer for the button matrix,
+ * the processing pipeline for the analog joysticks, and the hand-off of
+ * LED states and binding overrides to the LED refresh task.
+ *
+ * Inputs are owned by the input task (hmi_task()); the comms and web tasks
+ * only see them through lock-free snapshots, and the LED states are owned
+ * by the comms task in the same way.
  */
 
 #include "hmi_handler.h"
 #include "config_esp2.h"
 #include "persistence.h"
-#include <Adafruit_MCP23X17.h>
+#include "action_bindings.h"
+#include "mcp_bus.h"
+#include "mcp_matrix.h"
+#include "led_matrix.h"
+#include "joystick_adc.h"
+#include "joystick_calibration.h"
+#include "key_events.h"
+#include "rotary_switches.h"
+#include "snapshot.h"
 #include <SPI.h>
 #include <ESP32Encoder.h>
 
-// --- CONFIGURATION & CONSTANTS ---
-const unsigned long KEY_DEBOUNCE_MS = 50;
-
 // --- INTERNAL DATA STRUCTURES ---
-enum class KeyState
+
+/**
+ * @brief Debounces all 64 keys at once with 2-bit vertical counters.
+ *
+ * Bit n of `ct0`/`ct1` is the counter of key n (key n = row * 8 + col, so
+ * row r is byte r). A key's counter runs while its sample differs from
+ * the debounced state and resets as soon as it agrees again; only four
+ * differing scans in a row flip the debounced state.
+ */
+struct VerticalDebouncer
+{
+    uint64_t state = 0; // Debounced: bit set = pressed
+    uint64_t ct0 = 0;
+    uint64_t ct1 = 0;
+
+    /** @return The keys whose debounced state flipped with this sample. */
+    uint64_t update(uint64_t sample)
+    {
+        const uint64_t delta = sample ^ state;
+        ct1 = (ct1 ^ ct0) & delta;
+        ct0 = ~ct0 & delta;
+        const uint64_t toggled = delta & ~(ct0 | ct1);
+        state ^= toggled;
+        return toggled;
+    }
+
+    /** @return true if no key is pressed or on its way to a change. */
+    bool settled() const { return (state | ct0 | ct1) == 0; }
+};
+
+// Input values as published by the input task for the comms and web tasks.
+struct InputState
 {
-    IDLE,
-    PRESSED,
-    HELD,
-    RELEASED
+    uint8_t buttons[MATRIX_ROWS];
+    int16_t joysticks[NUM_JOYSTICKS][NUM_JOYSTICK_AXES];
+    int32_t encoders[NUM_ENCODERS_ESP2];
+    uint8_t rotary[NUM_ROTARY_SWITCHES];
 };
-struct KeyInfo
+
+// LED states from LinuxCNC, published by the comms task for the web task.
+struct LedState
 {
-    KeyState state = KeyState::IDLE;
+    uint8_t rows[MATRIX_ROWS];
 };
 
 // --- GLOBAL OBJECTS AND STATE VARIABLES ---
-Adafruit_MCP23X17 mcp_buttons;
-Adafruit_MCP23X17 mcp_led_rows;
-Adafruit_MCP23X17 mcp_led_cols;
 ESP32Encoder encoders[NUM_ENCODERS_ESP2];
 extern WebConfig web_cfg;
-static KeyInfo key_matrix[MATRIX_ROWS][MATRIX_COLS];
+static VerticalDebouncer keys;
+static unsigned long last_scan_ms = 0;
 static uint8_t current_button_bitmask[MATRIX_ROWS] = {0};
-static uint8_t current_led_states[MATRIX_ROWS] = {0};
+static uint8_t current_led_states[MATRIX_ROWS] = {0}; // Owned by the comms task
+static Snapshot<InputState> input_snapshot;
+static Snapshot<LedState> led_snapshot;
 static int16_t processed_joystick_values[NUM_JOYSTICKS][NUM_JOYSTICK_AXES];
+static_assert(sizeof(processed_joystick_values) <= sizeof(struct_message_from_esp2::joystick_values),
+              "The panel packet carries at most 2 joysticks");
 static int32_t hmi_encoder_values[NUM_ENCODERS_ESP2] = {0};
+static_assert(NUM_ENCODERS_ESP2 <= 8 && NUM_ROTARY_SWITCHES <= 4, "The panel packet carries 8 encoders and 4 rotary switches");
+static bool encoder_report_pending = false;
+static unsigned long last_encoder_report_ms = 0;
 static bool joystick_axis_locked[NUM_JOYSTICKS][NUM_JOYSTICK_AXES] = {false};
+static bool joystick_in_deadzone[NUM_JOYSTICKS][NUM_JOYSTICK_AXES] = {false};
+static bool joystick_report_pending = false;
+static unsigned long last_joystick_report_ms = 0;
 static bool data_changed_flag = false;
-static uint8_t current_led_scan_col = 0;
-static bool joystick_1_enabled = true;
+static uint8_t quiet_scans = 0; // Consecutive scans with every key released and settled
+static BindingOutputs binding_outputs = {0, 0, 0, 0, 100}; // Snapshot taken once per hmi_task() pass
 
 // --- PRIVATE FUNCTIONS: CORE LOGIC ---
 
 /**
- * @brief Drives the physical LED matrix using multiplexing.
+ * @brief Publishes the current input values for the other tasks.
  */
-void update_led_matrix()
+static void publish_input_state()
 {
-    mcp_led_cols.writeGPIOAB(0x0000);
-    uint16_t row_data = 0;
-    for (int i = 0; i < MATRIX_ROWS; i++)
+    InputState s;
+    memcpy(s.buttons, current_button_bitmask, sizeof(s.buttons));
+    memcpy(s.joysticks, processed_joystick_values, sizeof(s.joysticks));
+    memcpy(s.encoders, hmi_encoder_values, sizeof(s.encoders));
+    for (int i = 0; i < NUM_ROTARY_SWITCHES; i++)
+        s.rotary[i] = rotary_switch_position(i);
+    input_snapshot.publish(s);
+}
+
+// Keys handled at all: only the named buttons in ButtonIndex.
+static const uint64_t DEFINED_KEYS = MAX_BUTTONS_DEFINED >= 64 ? ~0ULL : (1ULL << MAX_BUTTONS_DEFINED) - 1;
+
+/**
+ * @brief Keys in radio groups that a binding has disabled; they read as released.
+ */
+static uint64_t disabled_keys(uint32_t groups_disabled)
+{
+    uint64_t mask = 0;
+    if (groups_disabled == 0)
+        return mask;
+    for (int i = 0; i < MAX_BUTTONS_DEFINED; i++)
     {
-        if (bitRead(current_led_states[i], current_led_scan_col))
-        {
-            bitSet(row_data, i);
-        }
+        const int group = web_cfg.buttons[i].radio_group_id;
+        if (group > 0 && group < 32 && (groups_disabled & (1UL << group)))
+            mask |= 1ULL << i;
     }
-    mcp_led_rows.writeGPIOAB(row_data);
-    mcp_led_cols.digitalWrite(current_led_scan_col, HIGH);
-    current_led_scan_col = (current_led_scan_col + 1) % MATRIX_COLS;
+    return mask;
 }
 
 /**
- * @brief Scans the button matrix and updates the state of each key.
+ * @brief Scans the button matrix every MATRIX_SCAN_INTERVAL_MS and debounces it.
+ * A key changes state after four equal scans in a row, so the debounce
+ * time is fixed by the interval rather than by the loop speed.
  */
 void update_keypad_states()
 {
-    bool state_has_changed = false;
+    // While idle, the rows are held low and the MCP interrupt replaces polling.
+    if (!mcp_matrix_wait_for_activity(0))
+        return;
+    const unsigned long now = millis();
+    if (now - last_scan_ms < MATRIX_SCAN_INTERVAL_MS)
+        return;
+    last_scan_ms = now;
+
+    uint8_t pressed_cols[MATRIX_ROWS];
+    mcp_matrix_scan(pressed_cols);
+    uint64_t raw = 0;
     for (int row = 0; row < MATRIX_ROWS; row++)
-    {
-        mcp_buttons.digitalWrite(row, LOW);
-        for (int col = 0; col < MATRIX_COLS; col++)
-        {
-            int button_idx = row * MATRIX_COLS + col;
-            if (button_idx >= MAX_BUTTONS_DEFINED)
-                continue;
+        raw |= (uint64_t)pressed_cols[row] << (row * MATRIX_COLS);
 
-            bool is_pressed = (mcp_buttons.digitalRead(col + 8) == LOW);
-            KeyInfo &key = key_matrix[row][col];
-            KeyState old_state = key.state;
+    const uint64_t toggled = keys.update(raw & DEFINED_KEYS & ~disabled_keys(binding_outputs.groups_disabled));
+    if (key_events_process(toggled, keys.state, now))
+        data_changed_flag = true;
+    if (toggled)
+    {
+        for (int row = 0; row < MATRIX_ROWS; row++)
+            current_button_bitmask[row] = (uint8_t)(keys.state >> (row * MATRIX_COLS));
+        data_changed_flag = true;
 
-            switch (key.state)
+        // Extra actions fire on the press edge.
+        uint64_t pressed = toggled & keys.state;
+        while (pressed)
+        {
+            const int button_idx = __builtin_ctzll(pressed);
+            pressed &= pressed - 1;
+            const auto &btn_cfg = button_configs[button_idx];
+            if (btn_cfg.extra_action == ButtonExtraAction::TOGGLE_JOYSTICK_AXIS_LOCK)
             {
-            case KeyState::IDLE:
-                if (is_pressed)
-                    key.state = KeyState::PRESSED;
-                break;
-            case KeyState::PRESSED:
-                key.state = is_pressed ? KeyState::HELD : KeyState::RELEASED;
-                break;
-            case KeyState::HELD:
-                if (!is_pressed)
-                    key.state = KeyState::RELEASED;
-                break;
-            case KeyState::RELEASED:
-                key.state = KeyState::IDLE;
-                break;
-            }
-
-            if (key.state != old_state)
-            {
-                state_has_changed = true;
-                if (key.state == KeyState::PRESSED)
-                {
-                    bitSet(current_button_bitmask[row], col);
-                    const auto &btn_cfg = button_configs[button_idx];
-                    if (btn_cfg.extra_action == ButtonExtraAction::TOGGLE_JOYSTICK_AXIS_LOCK)
-                    {
-                        joystick_axis_locked[btn_cfg.target_joystick_index][btn_cfg.target_axis_index] = !joystick_axis_locked[btn_cfg.target_joystick_index][btn_cfg.target_axis_index];
-                    }
-                }
-                else if (key.state == KeyState::RELEASED)
-                {
-                    bitClear(current_button_bitmask[row], col);
-                }
+                joystick_axis_locked[btn_cfg.target_joystick_index][btn_cfg.target_axis_index] = !joystick_axis_locked[btn_cfg.target_joystick_index][btn_cfg.target_axis_index];
             }
         }
-        mcp_buttons.digitalWrite(row, HIGH);
     }
-    if (state_has_changed)
-        data_changed_flag = true;
+
+    // Any contact closure, including unassigned or disabled keys, keeps the
+    // scanner awake; otherwise the interrupt would wake it straight back up.
+    // Go idle only once every key has been released and debounced.
+    if (raw != 0 || !keys.settled())
+        quiet_scans = 0;
+    else if (++quiet_scans >= MATRIX_IDLE_SCANS)
+    {
+        quiet_scans = 0;
+        mcp_matrix_enter_idle();
+    }
 }
 
 /**
- * @brief Reads all potentiometers and processes them.
+ * @brief Maps one filtered pot reading to the -512..512 output range.
+ * The response table does the mapping; this adds the deadzone hysteresis
+ * (leaving the deadzone takes JOYSTICK_DEADZONE_HYSTERESIS extra counts, so
+ * noise at its edge does not chatter) and the binding scale.
+ */
+static int16_t map_joystick_axis(int joystick, int axis)
+{
+    const auto &static_cfg = joystick_configs[joystick].axes[axis];
+    const auto &dynamic_cfg = web_cfg.joysticks[joystick][axis];
+    const int raw_value = joystick_adc_value(static_cfg.poti_index);
+    const int center_value = joystick_axis_center(joystick, axis);
+
+    bool &in_deadzone = joystick_in_deadzone[joystick][axis];
+    const int deadzone = dynamic_cfg.center_deadzone + (in_deadzone ? JOYSTICK_DEADZONE_HYSTERESIS : 0);
+    in_deadzone = abs(raw_value - center_value) < deadzone;
+    if (in_deadzone)
+        return 0;
+
+    const long value = (long)joystick_axis_lookup(joystick, axis, raw_value) * binding_outputs.joystick_scale_pct / 100;
+    return constrain(value, -512L, 512L);
+}
+
+/**
+ * @brief Processes new filtered pot readings and decides when they are worth sending.
+ *
+ * A value is reported when it moves JOYSTICK_CHANGE_THRESHOLD steps away
+ * from the last reported one, or reaches 0 (so a released stick always
+ * stops the machine). Reports are coalesced to at most JOYSTICK_MAX_SEND_HZ
+ * packets per second; button changes still go out at once and carry the
+ * latest values with them.
  */
 void process_joysticks()
 {
-    if (!joystick_1_enabled)
-    {
-        for (int j = 0; j < NUM_JOYSTICK_AXES; j++)
-        {
-            processed_joystick_values[0][j] = 0;
-        }
-    }
-    else
+    if (joystick_adc_poll() && joystick_adc_ready())
     {
+        joystick_tables_refresh();
+        joystick_calibration_track();
         for (int i = 0; i < NUM_JOYSTICKS; i++)
         {
+            // A joystick being calibrated is swept end to end; it must not move the machine.
+            const bool disabled = (binding_outputs.joysticks_disabled & (1UL << i)) || joystick_calibration_active(i);
             for (int j = 0; j < NUM_JOYSTICK_AXES; j++)
             {
-                if (joystick_axis_locked[i][j])
-                {
-                    processed_joystick_values[i][j] = 0;
+                const int16_t value = (disabled || joystick_axis_locked[i][j]) ? 0 : map_joystick_axis(i, j);
+                const int16_t reported = processed_joystick_values[i][j];
+                if (value == reported)
                     continue;
-                }
-                const auto &static_cfg = joystick_configs[i].axes[j];
-                const auto &dynamic_cfg = web_cfg.joysticks[i][j];
-                int raw_value = analogRead(POTI_PINS[static_cfg.poti_index]);
-                int center_value = 2048;
-                if (abs(raw_value - center_value) < dynamic_cfg.center_deadzone)
+                if (value == 0 || abs(value - reported) >= JOYSTICK_CHANGE_THRESHOLD)
                 {
-                    processed_joystick_values[i][j] = 0;
-                    continue;
-                }
-                long mapped_value = (raw_value > center_value)
-                                        ? map(raw_value, center_value + dynamic_cfg.center_deadzone, 4095, 0, 512)
-                                        : map(raw_value, 0, center_value - dynamic_cfg.center_deadzone, -512, 0);
-                mapped_value *= dynamic_cfg.sensitivity;
-                if (dynamic_cfg.is_inverted)
-                {
-                    mapped_value *= -1;
+                    processed_joystick_values[i][j] = value;
+                    joystick_report_pending = true;
                 }
-                processed_joystick_values[i][j] = constrain(mapped_value, -512, 512);
             }
         }
     }
-    data_changed_flag = true;
+
+    const unsigned long now = millis();
+    if (joystick_report_pending && now - last_joystick_report_ms >= 1000 / JOYSTICK_MAX_SEND_HZ)
+    {
+        joystick_report_pending = false;
+        last_joystick_report_ms = now;
+        data_changed_flag = true;
+    }
 }
 
 /**
  * @brief Reads the current count from all encoders connected to ESP2.
+ * Counts are absolute, so a fast turn is coalesced to at most
+ * HMI_ENCODER_MAX_SEND_HZ packets per second without losing steps.
  */
 void read_hmi_encoders()
 {
     for (int i = 0; i < NUM_ENCODERS_ESP2; i++)
     {
-        long new_count = encoders[i].getCount();
+        const int32_t new_count = encoders[i].getCount();
         if (new_count != hmi_encoder_values[i])
         {
             hmi_encoder_values[i] = new_count;
-            data_changed_flag = true;
+            encoder_report_pending = true;
         }
     }
+
+    const unsigned long now = millis();
+    if (encoder_report_pending && now - last_encoder_report_ms >= 1000 / HMI_ENCODER_MAX_SEND_HZ)
+    {
+        encoder_report_pending = false;
+        last_encoder_report_ms = now;
+        data_changed_flag = true;
+    }
 }
 
 // --- PUBLIC FUNCTIONS: INTERFACE FOR MAIN APP ---
@@ -199,20 +287,22 @@ void hmi_init()
     pinMode(PIN_LEVEL_SHIFTER_OE, OUTPUT);
     digitalWrite(PIN_LEVEL_SHIFTER_OE, HIGH);
     SPI.begin();
-    mcp_buttons.begin_SPI(PIN_MCP_CS, &SPI, MCP_ADDR_BUTTONS);
-    mcp_led_rows.begin_SPI(PIN_MCP_CS, &SPI, MCP_ADDR_LED_ROWS);
-    mcp_led_cols.begin_SPI(PIN_MCP_CS, &SPI, MCP_ADDR_LED_COLS);
+    mcp_bus_init(&SPI, PIN_MCP_CS);
 
-    for (int i = 0; i < 8; i++)
-        mcp_buttons.pinMode(i, OUTPUT);
-    for (int i = 8; i < 16; i++)
-        mcp_buttons.pinMode(i, INPUT_PULLUP);
+    // The button matrix is scanned with raw port access (rows GPA, columns GPB).
+    mcp_matrix_init(MCP_ADDR_BUTTONS, PIN_MCP_BUTTONS_INT);
+    key_events_init();
+#if MATRIX_SCAN_BENCHMARK
+    mcp_matrix_benchmark(1000);
+#endif
 
-    for (int i = 0; i < 16; i++)
-    {
-        mcp_led_rows.pinMode(i, OUTPUT);
-        mcp_led_cols.pinMode(i, OUTPUT);
-    }
+    // From here on the LED matrix refreshes itself in its own task.
+    led_matrix_init(MCP_ADDR_LED_ROWS, MCP_ADDR_LED_COLS);
+
+    rotary_switches_init(MCP_ADDR_ROT_SWITCHES);
+
+    // The pots are sampled by DMA from here on; the first blocks set each rest position.
+    joystick_adc_init();
 
     ESP32Encoder::useInternalWeakPullResistors = puType::up;
     for (int i = 0; i < NUM_ENCODERS_ESP2; i++)
@@ -224,10 +314,15 @@ void hmi_init()
 
 void hmi_task()
 {
+    binding_outputs = action_bindings_outputs();
+    led_matrix_set_overrides(binding_outputs.leds_on, binding_outputs.leds_blinking);
     update_keypad_states();
     process_joysticks();
     read_hmi_encoders();
-    update_led_matrix();
+    if (rotary_switches_poll())
+        data_changed_flag = true;
+    if (data_changed_flag)
+        publish_input_state();
 }
 
 bool hmi_data_has_changed()
@@ -242,52 +337,36 @@ bool hmi_data_has_changed()
 
 void get_hmi_data(struct_message_from_esp2 *data)
 {
-    memcpy(data->button_matrix_states, current_button_bitmask, sizeof(data->button_matrix_states));
-    memcpy(data->joystick_values, processed_joystick_values, sizeof(data->joystick_values));
-    // memcpy(data->hmi_encoder_values, hmi_encoder_values, sizeof(data->hmi_encoder_values)); // Uncomment if added to struct
+    const InputState s = input_snapshot.read();
+    memset(data, 0, sizeof(*data));
+    memcpy(data->button_matrix_states, s.buttons, sizeof(data->button_matrix_states));
+    memcpy(data->joystick_values, s.joysticks, sizeof(s.joysticks));
+    memcpy(data->encoder_counts, s.encoders, sizeof(s.encoders));
+    memcpy(data->rotary_positions, s.rotary, sizeof(s.rotary));
+    key_events_fill_packet(data);
 }
 
-void update_leds_from_lcnc(const struct_message_to_hmi &data)
+bool update_leds_from_lcnc(const struct_message_to_hmi &data)
 {
-    if (memcmp(current_led_states, data.led_matrix_states, sizeof(current_led_states)) != 0)
-    {
-        data_changed_flag = true;
-    }
+    if (memcmp(current_led_states, data.led_matrix_states, sizeof(current_led_states)) == 0)
+        return false;
     memcpy(current_led_states, data.led_matrix_states, sizeof(current_led_states));
+    led_matrix_set_states(current_led_states);
+    LedState s;
+    memcpy(s.rows, current_led_states, sizeof(s.rows));
+    led_snapshot.publish(s);
+    return true;
 }
 
 void get_live_status_data(uint8_t *btn_buf, uint8_t *led_buf)
 {
-    memcpy(btn_buf, current_button_bitmask, sizeof(current_button_bitmask));
-    memcpy(led_buf, current_led_states, sizeof(current_led_states));
+    const InputState inputs = input_snapshot.read();
+    const LedState leds = led_snapshot.read();
+    memcpy(btn_buf, inputs.buttons, sizeof(inputs.buttons));
+    memcpy(led_buf, leds.rows, sizeof(leds.rows));
 }
 
 void evaluate_action_bindings(const struct_message_to_hmi &lcnc_data)
 {
-    joystick_1_enabled = true;
-
-    for (int i = 0; i < MAX_ACTION_BINDINGS; i++)
-    {
-        const auto &binding = web_cfg.bindings[i];
-        if (!binding.is_active)
-            continue;
-
-        uint16_t status_word_to_check = (binding.trigger < 16)
-                                            ? lcnc_data.machine_status
-                                            : lcnc_data.spindle_coolant_status;
-
-        uint8_t bit_to_check = binding.trigger % 16;
-
-        if (bitRead(status_word_to_check, bit_to_check))
-        {
-            switch (binding.action)
-            {
-            case DISABLE_JOYSTICK_1:
-                joystick_1_enabled = false;
-                break;
-            case ENABLE_JOYSTICK_1:
-                break;
-            }
-        }
-    }
-}
\ No newline at end of file
+    action_bindings_evaluate(lcnc_data.machine_status, lcnc_data.spindle_coolant_status);
+}
@@ -26,37 +26,43 @@ void hmi_init();
 
 /**
  * @brief Main task function for the HMI handler.
- * This function should be called repeatedly and rapidly in the main loop().
+ * Called by the input task every INPUT_TASK_PERIOD_MS, and only there.
  * It is responsible for executing all sub-tasks like scanning buttons,
- * reading joysticks and encoders, and multiplexing the LED matrix.
+ * reading joysticks and encoders, and passing binding overrides to the LED
+ * matrix (which is multiplexed by its own task, see led_matrix.h). Changed
+ * values are published for get_hmi_data() and get_live_status_data().
  */
 void hmi_task();
 
 /**
  * @brief Checks if there has been a change in the main panel's input state.
  * This is used to determine if a new data packet needs to be sent to ESP1.
+ * Call from the input task, after hmi_task().
  * @return true if an input state has changed since the last check, false otherwise.
  */
 bool hmi_data_has_changed();
 
 /**
  * @brief Fills a data structure with the current state of all main panel inputs.
- * This function packs the processed data (button bitmasks, joystick values)
- * into the ESP-NOW message format for transmission to ESP1.
+ * This function packs the processed data (button bitmasks, joystick values,
+ * encoder counts, rotary switch positions) and the unacknowledged key events into the ESP-NOW message format for
+ * transmission to ESP1. Safe from any task.
  * @param data Pointer to the `struct_message_from_esp2` that will be filled.
  */
 void get_hmi_data(struct_message_from_esp2 *data);
 
 /**
  * @brief Updates the local state of the main panel's LEDs based on data received from LinuxCNC.
- * This function is called from the ESP-NOW receive callback when a new packet
- * arrives from ESP1. It updates the internal buffer that the LED multiplexer uses.
+ * Called by the comms task for every packet from ESP1. The LED refresh task
+ * picks the new states up at its next frame.
  * @param data The `struct_message_to_hmi` received from ESP1.
+ * @return true if any LED state changed.
  */
-void update_leds_from_lcnc(const struct_message_to_hmi &data);
+bool update_leds_from_lcnc(const struct_message_to_hmi &data);
 
 /**
  * @brief Gets the current live status of buttons and LEDs for WebSocket broadcasting.
+ * Safe from any task.
  * @param btn_buf Pointer to a buffer to be filled with the button state bitmask.
  * @param led_buf Pointer to a buffer to be filled with the LED state bitmask.
  */
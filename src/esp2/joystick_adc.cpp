@@ -0,0 +1,192 @@
+/**
+ * @file joystick_adc.cpp
+ * @brief Implements the DMA sampling, oversampling and filter chain for the pots.
+ */
+
+#include "joystick_adc.h"
+#include <driver/adc.h>
+
+// Bytes per DMA conversion frame; each conversion result is 2 bytes (TYPE1 format).
+static const uint32_t ADC_FRAME_BYTES = 256;
+static const uint8_t NO_POT = 0xFF;
+
+// --- INTERNAL DATA STRUCTURES ---
+struct PotChannel
+{
+    uint32_t sum;        // Conversions of the current oversampling block
+    uint16_t count;
+    uint16_t history[3]; // Last block values, for the median
+    uint8_t history_len;
+    bool primed;         // IIR state holds a value
+    uint32_t iir;        // Filter state, value << JOYSTICK_FILTER_IIR_SHIFT
+    uint16_t value;      // Filtered output
+    uint32_t rest_sum;
+    uint16_t rest_blocks;
+};
+
+// --- MODULE STATE ---
+static PotChannel pots[NUM_POTIS];
+static uint8_t channel_to_pot[8]; // ADC1 channel -> POTI_PINS index
+static uint8_t active_pots = 0; // Bit n: POTI_PINS[n] is sampled
+static bool rest_captured = false;
+static bool running = false;
+
+// --- FILTER CHAIN ---
+
+static uint16_t median3(uint16_t a, uint16_t b, uint16_t c)
+{
+    return max(min(a, b), min(max(a, b), c));
+}
+
+/**
+ * @brief Feeds one oversampled block through median and IIR.
+ */
+static void filter_block(PotChannel &p, uint16_t block)
+{
+#if JOYSTICK_FILTER_MEDIAN
+    p.history[0] = p.history[1];
+    p.history[1] = p.history[2];
+    p.history[2] = block;
+    if (p.history_len < 3)
+    {
+        // Not enough history yet: fill it, so the median starts out neutral.
+        if (p.history_len++ == 0)
+            p.history[0] = p.history[1] = block;
+    }
+    block = median3(p.history[0], p.history[1], p.history[2]);
+#endif
+
+    if (!p.primed)
+    {
+        p.iir = (uint32_t)block << JOYSTICK_FILTER_IIR_SHIFT; // Start settled, not ramping up from 0
+        p.primed = true;
+    }
+    p.iir += block - (p.iir >> JOYSTICK_FILTER_IIR_SHIFT);
+    p.value = p.iir >> JOYSTICK_FILTER_IIR_SHIFT;
+
+    if (p.rest_blocks < JOYSTICK_REST_BLOCKS)
+    {
+        p.rest_sum += p.value;
+        p.rest_blocks++;
+    }
+}
+
+// --- PUBLIC API ---
+
+void joystick_adc_init()
+{
+    memset(pots, 0, sizeof(pots));
+    memset(channel_to_pot, NO_POT, sizeof(channel_to_pot));
+
+    adc_digi_pattern_config_t pattern[NUM_POTIS] = {};
+    uint8_t pattern_num = 0;
+    uint16_t channel_mask = 0;
+    for (int i = 0; i < NUM_POTIS; ++i)
+    {
+        const int8_t channel = digitalPinToAnalogChannel(POTI_PINS[i]);
+        if (channel < 0 || channel > 7)
+        {
+            // Not an ADC1 pin; ADC2 is unusable while Wi-Fi runs.
+            if (DEBUG_ENABLED)
+                Serial.printf("Poti %d on GPIO %d is not an ADC1 pin; ignored.\n", i, POTI_PINS[i]);
+            continue;
+        }
+        channel_to_pot[channel] = i;
+        channel_mask |= 1U << channel;
+        active_pots |= 1U << i;
+        adc_digi_pattern_config_t &entry = pattern[pattern_num++];
+        entry.atten = ADC_ATTEN_DB_11;
+        entry.channel = channel;
+        entry.unit = 0; // ADC1
+        entry.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    adc_digi_init_config_t init_cfg = {};
+    init_cfg.max_store_buf_size = 4 * ADC_FRAME_BYTES;
+    init_cfg.conv_num_each_intr = ADC_FRAME_BYTES;
+    init_cfg.adc1_chan_mask = channel_mask;
+    init_cfg.adc2_chan_mask = 0;
+
+    adc_digi_configuration_t dig_cfg = {};
+    dig_cfg.conv_limit_en = 1; // Required on the ESP32 (conversions go through I2S0)
+    dig_cfg.conv_limit_num = 250;
+    dig_cfg.pattern_num = pattern_num;
+    dig_cfg.adc_pattern = pattern;
+    dig_cfg.sample_freq_hz = JOYSTICK_ADC_SAMPLE_HZ;
+    dig_cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    dig_cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+    if (adc_digi_initialize(&init_cfg) != ESP_OK ||
+        adc_digi_controller_configure(&dig_cfg) != ESP_OK ||
+        adc_digi_start() != ESP_OK)
+    {
+        if (DEBUG_ENABLED)
+            Serial.println("Joystick ADC: continuous mode failed to start.");
+        return;
+    }
+    running = true;
+}
+
+bool joystick_adc_poll()
+{
+    if (!running)
+        return false;
+
+    uint8_t frame[ADC_FRAME_BYTES];
+    bool fresh = false;
+    for (;;)
+    {
+        uint32_t len = 0;
+        // ESP_ERR_INVALID_STATE only reports that the ring buffer overflowed
+        // (old conversions were dropped); the returned data is still valid.
+        esp_err_t err = adc_digi_read_bytes(frame, sizeof(frame), &len, 0);
+        if ((err != ESP_OK && err != ESP_ERR_INVALID_STATE) || len == 0)
+            break;
+
+        for (uint32_t i = 0; i + 1 < len; i += 2)
+        {
+            const adc_digi_output_data_t *d = (const adc_digi_output_data_t *)&frame[i];
+            const uint8_t pot = d->type1.channel < 8 ? channel_to_pot[d->type1.channel] : NO_POT;
+            if (pot == NO_POT)
+                continue;
+            PotChannel &p = pots[pot];
+            p.sum += d->type1.data;
+            if (++p.count == JOYSTICK_OVERSAMPLE)
+            {
+                const uint16_t block = p.sum / JOYSTICK_OVERSAMPLE;
+                p.sum = 0;
+                p.count = 0;
+                filter_block(p, block);
+                fresh = true;
+            }
+        }
+    }
+
+    if (fresh && !rest_captured)
+    {
+        rest_captured = true;
+        for (int i = 0; i < NUM_POTIS; ++i)
+        {
+            if ((active_pots & (1U << i)) && pots[i].rest_blocks < JOYSTICK_REST_BLOCKS)
+                rest_captured = false;
+        }
+    }
+    return fresh;
+}
+
+bool joystick_adc_ready()
+{
+    return rest_captured;
+}
+
+uint16_t joystick_adc_value(uint8_t poti_index)
+{
+    return poti_index < NUM_POTIS ? pots[poti_index].value : 0;
+}
+
+uint16_t joystick_adc_rest(uint8_t poti_index)
+{
+    if (poti_index >= NUM_POTIS || pots[poti_index].rest_blocks == 0)
+        return 2048; // Mid-scale until the first blocks arrive
+    return pots[poti_index].rest_sum / pots[poti_index].rest_blocks;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file joystick_adc.h
+ * @brief Continuous-mode (DMA) acquisition and filtering of the joystick pots (ESP2).
+ *
+ * ADC1 converts all POTI_PINS round-robin in continuous mode, and the DMA
+ * fills a ring buffer with no CPU involvement. joystick_adc_poll() drains
+ * the buffer without blocking. It averages JOYSTICK_OVERSAMPLE conversions
+ * per pot into one block value, then runs each block through an optional
+ * median-of-3 (which drops single-block spikes) and a first-order IIR
+ * low-pass.
+ *
+ * The first JOYSTICK_REST_BLOCKS blocks after start-up are averaged into a
+ * per-pot rest value, which replaces an assumed mid-scale center for sticks
+ * that are released at power-on.
+ */
+
+#ifndef JOYSTICK_ADC_H
+#define JOYSTICK_ADC_H
+
+#include <Arduino.h>
+#include "config_esp2.h"
+
+/**
+ * @brief Configures ADC1 continuous mode for all pots and starts conversions.
+ */
+void joystick_adc_init();
+
+/**
+ * @brief Drains the DMA buffer and filters any completed blocks. Never blocks.
+ * @return true if at least one pot has a new filtered value.
+ */
+bool joystick_adc_poll();
+
+/**
+ * @brief True once the rest values have been captured.
+ */
+bool joystick_adc_ready();
+
+/**
+ * @brief Latest filtered reading of a pot, 0..4095.
+ * @param poti_index Index into POTI_PINS.
+ */
+uint16_t joystick_adc_value(uint8_t poti_index);
+
+/**
+ * @brief Reading of a pot at rest, captured at start-up, 0..4095.
+ * @param poti_index Index into POTI_PINS.
+ */
+uint16_t joystick_adc_rest(uint8_t poti_index);
+
+#endif // JOYSTICK_ADC_H
@@ -0,0 +1,196 @@
+/**
+ * @file joystick_calibration.cpp
+ * @brief Implements the response table builder and the calibration capture.
+ */
+
+#include "joystick_calibration.h"
+#include "joystick_adc.h"
+
+static const char AXIS_NAMES[] = "XYZ";
+
+// --- MODULE STATE ---
+static int16_t tables[NUM_JOYSTICKS][NUM_JOYSTICK_AXES][JOYSTICK_LUT_SIZE];
+static uint16_t centers[NUM_JOYSTICKS][NUM_JOYSTICK_AXES];
+static volatile bool tables_stale = true;
+
+// Calibration in progress; shared between the WebSocket handler and the HMI loop.
+static portMUX_TYPE cal_mux = portMUX_INITIALIZER_UNLOCKED;
+static int cal_joystick = -1;
+static AxisCalibration cal_axes[NUM_JOYSTICK_AXES];
+
+// --- RESPONSE TABLES ---
+
+/**
+ * @brief Shapes a normalized deflection 0..1. Both curves keep 0 and 1 fixed.
+ */
+static float apply_curve(JoystickCurve curve, float k, float x)
+{
+    switch (curve)
+    {
+    case CURVE_EXPO:
+        return (1.0f - k) * x + k * x * x * x;
+    case CURVE_S_CURVE:
+        return (1.0f - k) * x + k * x * x * (3.0f - 2.0f * x);
+    default:
+        return x;
+    }
+}
+
+static void build_table(int joystick, int axis)
+{
+    const JoystickAxisDynamicConfig &cfg = web_cfg.joysticks[joystick][axis];
+    const uint8_t poti = joystick_configs[joystick].axes[axis].poti_index;
+    AxisCalibration cal = cfg.cal;
+    if (!cfg.is_calibrated)
+        cal = {0, joystick_adc_rest(poti), 4095};
+    centers[joystick][axis] = cal.center;
+
+    const float k = min<int>(cfg.curve_strength, 100) / 100.0f;
+    const int pos_start = cal.center + cfg.center_deadzone;
+    const int neg_start = cal.center - cfg.center_deadzone;
+    const int pos_span = max(1, (int)cal.max - pos_start);
+    const int neg_span = max(1, neg_start - (int)cal.min);
+    const float gain = 512.0f * cfg.sensitivity * (cfg.is_inverted ? -1.0f : 1.0f);
+
+    int16_t *table = tables[joystick][axis];
+    for (int i = 0; i < JOYSTICK_LUT_SIZE; ++i)
+    {
+        // Each entry stands for the middle of its bucket of raw readings.
+        const int raw = (i << JOYSTICK_LUT_SHIFT) + (1 << JOYSTICK_LUT_SHIFT) / 2;
+        float y = 0.0f;
+        if (raw > pos_start)
+            y = apply_curve(cfg.curve, k, min(1.0f, (float)(raw - pos_start) / pos_span));
+        else if (raw < neg_start)
+            y = -apply_curve(cfg.curve, k, min(1.0f, (float)(neg_start - raw) / neg_span));
+        table[i] = constrain(lroundf(y * gain), -512L, 512L);
+    }
+}
+
+void joystick_tables_invalidate()
+{
+    tables_stale = true;
+}
+
+void joystick_tables_refresh()
+{
+    if (!tables_stale || !joystick_adc_ready())
+        return;
+    tables_stale = false; // Cleared first: a change during the rebuild triggers another one
+    for (int i = 0; i < NUM_JOYSTICKS; ++i)
+    {
+        for (int j = 0; j < NUM_JOYSTICK_AXES; ++j)
+            build_table(i, j);
+    }
+}
+
+uint16_t joystick_axis_center(int joystick, int axis)
+{
+    return centers[joystick][axis];
+}
+
+int16_t joystick_axis_lookup(int joystick, int axis, uint16_t raw)
+{
+    return tables[joystick][axis][min<uint16_t>(raw, 4095) >> JOYSTICK_LUT_SHIFT];
+}
+
+// --- CALIBRATION ---
+
+bool joystick_calibration_start(int joystick)
+{
+    if (joystick < 0 || joystick >= NUM_JOYSTICKS || !joystick_adc_ready())
+        return false;
+
+    portENTER_CRITICAL(&cal_mux);
+    for (int j = 0; j < NUM_JOYSTICK_AXES; ++j)
+    {
+        const uint16_t v = joystick_adc_value(joystick_configs[joystick].axes[j].poti_index);
+        cal_axes[j] = {v, v, v};
+    }
+    cal_joystick = joystick;
+    portEXIT_CRITICAL(&cal_mux);
+    return true;
+}
+
+void joystick_calibration_track()
+{
+    portENTER_CRITICAL(&cal_mux);
+    if (cal_joystick >= 0)
+    {
+        for (int j = 0; j < NUM_JOYSTICK_AXES; ++j)
+        {
+            const uint16_t v = joystick_adc_value(joystick_configs[cal_joystick].axes[j].poti_index);
+            cal_axes[j].min = min(cal_axes[j].min, v);
+            cal_axes[j].max = max(cal_axes[j].max, v);
+        }
+    }
+    portEXIT_CRITICAL(&cal_mux);
+}
+
+bool joystick_calibration_active(int joystick)
+{
+    return joystick < 0 ? cal_joystick >= 0 : cal_joystick == joystick;
+}
+
+const char *joystick_calibration_finish()
+{
+    AxisCalibration axes[NUM_JOYSTICK_AXES];
+    portENTER_CRITICAL(&cal_mux);
+    const int joystick = cal_joystick;
+    memcpy(axes, cal_axes, sizeof(axes));
+    portEXIT_CRITICAL(&cal_mux);
+
+    if (joystick < 0)
+        return "No calibration in progress.";
+
+    static char message[64];
+    for (int j = 0; j < NUM_JOYSTICK_AXES; ++j)
+    {
+        if (axes[j].center - axes[j].min < JOYSTICK_CAL_MIN_SPAN ||
+            axes[j].max - axes[j].center < JOYSTICK_CAL_MIN_SPAN)
+        {
+            snprintf(message, sizeof(message), "Axis %c: move it fully to both ends.", AXIS_NAMES[j]);
+            return message;
+        }
+    }
+
+    if (!save_joystick_calibration(joystick, axes))
+        return "Saving the calibration failed.";
+
+    portENTER_CRITICAL(&cal_mux);
+    cal_joystick = -1;
+    portEXIT_CRITICAL(&cal_mux);
+    joystick_tables_invalidate();
+    return nullptr;
+}
+
+void joystick_calibration_cancel()
+{
+    portENTER_CRITICAL(&cal_mux);
+    cal_joystick = -1;
+    portEXIT_CRITICAL(&cal_mux);
+}
+
+void joystick_calibration_write_status(JsonStreamWriter &w)
+{
+    AxisCalibration axes[NUM_JOYSTICK_AXES];
+    portENTER_CRITICAL(&cal_mux);
+    const int joystick = cal_joystick;
+    memcpy(axes, cal_axes, sizeof(axes));
+    portEXIT_CRITICAL(&cal_mux);
+
+    w.begin_object();
+    w.field("joystick", joystick);
+    w.key("axes");
+    w.begin_array();
+    for (int j = 0; joystick >= 0 && j < NUM_JOYSTICK_AXES; ++j)
+    {
+        w.begin_object();
+        w.field("min", (int)axes[j].min);
+        w.field("center", (int)axes[j].center);
+        w.field("max", (int)axes[j].max);
+        w.field("raw", (int)joystick_adc_value(joystick_configs[joystick].axes[j].poti_index));
+        w.end_object();
+    }
+    w.end_array();
+    w.end_object();
+}
@@ -0,0 +1,84 @@
+/**
+ * @file joystick_calibration.h
+ * @brief Joystick calibration capture and precomputed response tables (ESP2).
+ *
+ * Every axis has a lookup table over the ADC range, indexed by
+ * raw >> JOYSTICK_LUT_SHIFT, that holds the final output for that reading.
+ * Calibrated span, deadzone, response curve, sensitivity and inversion are
+ * folded in when the table is built, so processing a sample is one lookup.
+ * Tables are rebuilt by the HMI loop itself after a configuration change,
+ * so a lookup never sees a half-built table.
+ *
+ * Calibration is driven from the web UI. It starts with the stick
+ * released, so the current reading becomes the center. min/max then follow
+ * the stick while the user moves every axis to both ends, and finishing
+ * stores the result in the configuration. The joystick being calibrated
+ * reports 0 throughout.
+ */
+
+#ifndef JOYSTICK_CALIBRATION_H
+#define JOYSTICK_CALIBRATION_H
+
+#include <Arduino.h>
+#include "config_esp2.h"
+#include "persistence.h"
+
+// --- RESPONSE TABLES ---
+
+/**
+ * @brief Marks the tables stale after a configuration change. Safe from any task.
+ */
+void joystick_tables_invalidate();
+
+/**
+ * @brief Rebuilds stale tables. Call from the HMI loop before looking values up.
+ * Waits for the ADC rest values, which uncalibrated axes use as their center.
+ */
+void joystick_tables_refresh();
+
+/**
+ * @brief The raw reading treated as center: the calibrated one, else the rest position.
+ */
+uint16_t joystick_axis_center(int joystick, int axis);
+
+/**
+ * @brief Maps a filtered raw reading to the -512..512 output, before binding scale.
+ */
+int16_t joystick_axis_lookup(int joystick, int axis, uint16_t raw);
+
+// --- CALIBRATION ---
+
+/**
+ * @brief Starts calibrating a joystick; its current readings become the centers.
+ * @return false if the ADC is not ready or the index is invalid.
+ */
+bool joystick_calibration_start(int joystick);
+
+/**
+ * @brief Widens min/max with the latest readings. Call from the HMI loop after new ADC blocks.
+ */
+void joystick_calibration_track();
+
+/**
+ * @brief True while @p joystick is being calibrated (any joystick if -1).
+ */
+bool joystick_calibration_active(int joystick);
+
+/**
+ * @brief Validates the captured ranges and stores them.
+ * @return nullptr on success, otherwise a message for the web UI. Calibration
+ *         stays active after a failed validation so the user can keep moving.
+ */
+const char *joystick_calibration_finish();
+
+/**
+ * @brief Abandons a calibration in progress without changing the configuration.
+ */
+void joystick_calibration_cancel();
+
+/**
+ * @brief Streams the calibration in progress as {joystick, axes:[{min,center,max,raw}]}.
+ */
+void joystick_calibration_write_status(JsonStreamWriter &w);
+
+#endif // JOYSTICK_CALIBRATION_H
@@ -0,0 +1,203 @@
+/**
+ * @file key_events.cpp
+ * @brief Implements the key event queue, its acknowledgement and the gesture recognizer.
+ */
+
+#include "key_events.h"
+
+static const uint8_t QUEUE_MASK = KEY_EVENT_QUEUE_LEN - 1;
+static_assert((KEY_EVENT_QUEUE_LEN & QUEUE_MASK) == 0, "KEY_EVENT_QUEUE_LEN must be a power of 2");
+
+// --- MODULE STATE ---
+
+// Queue of unacknowledged events; shared with the ESP-NOW receive callback.
+static portMUX_TYPE queue_mux = portMUX_INITIALIZER_UNLOCKED;
+static PanelKeyEvent queue[KEY_EVENT_QUEUE_LEN];
+static uint8_t queue_head = 0;
+static uint8_t queue_count = 0;
+static uint16_t next_seq = 1;
+static uint16_t epoch = 0;
+static uint32_t last_sent_ms = 0;
+static uint32_t dropped_events = 0; // Overflowed or aged out; for the debug log
+
+// Gesture state, owned by the scanning side. Bit n = key n.
+static uint32_t press_ms[MAX_BUTTONS];
+static uint32_t release_ms[MAX_BUTTONS];
+static uint64_t long_reported = 0; // Held keys whose long press has been reported
+static uint64_t tap_armed = 0;     // Keys whose last press was a short tap
+static uint64_t second_tap = 0;    // Held keys whose press completed a double tap
+static uint64_t chorded = 0;       // Held keys that took part in a chord
+static uint64_t chord_group = 0;   // Keys pressed since the chord window opened
+static uint32_t chord_start_ms = 0;
+
+// --- QUEUE ---
+
+static void pop_front()
+{
+    queue_head = (queue_head + 1) & QUEUE_MASK;
+    queue_count--;
+}
+
+static void push_event(PanelKeyEventType type, int key, uint32_t now_ms, uint64_t chord_keys = 0)
+{
+    PanelKeyEvent ev;
+    ev.type = type;
+    ev.key = key;
+    ev.time_ms = now_ms;
+    memset(ev.chord, 0xFF, sizeof(ev.chord));
+    for (int i = 0; chord_keys && i < KEY_CHORD_MAX_KEYS; ++i)
+    {
+        ev.chord[i] = __builtin_ctzll(chord_keys);
+        chord_keys &= chord_keys - 1;
+    }
+
+    portENTER_CRITICAL(&queue_mux);
+    if (queue_count == KEY_EVENT_QUEUE_LEN)
+    {
+        // ESP1 has not acknowledged anything for a whole queue: drop the oldest.
+        pop_front();
+        dropped_events++;
+    }
+    ev.seq = next_seq++;
+    queue[(queue_head + queue_count) & QUEUE_MASK] = ev;
+    queue_count++;
+    portEXIT_CRITICAL(&queue_mux);
+}
+
+// --- GESTURES ---
+
+bool key_events_process(uint64_t toggled, uint64_t state, uint32_t now_ms)
+{
+    bool queued = false;
+
+    uint64_t released = toggled & ~state;
+    while (released)
+    {
+        const int key = __builtin_ctzll(released);
+        const uint64_t bit = 1ULL << key;
+        released &= released - 1;
+        push_event(KEY_EVENT_RELEASE, key, now_ms);
+        queued = true;
+
+        // Only a plain short press can be the first half of a double tap.
+        const bool short_tap = !((long_reported | second_tap | chorded) & bit);
+        tap_armed = short_tap ? (tap_armed | bit) : (tap_armed & ~bit);
+        release_ms[key] = now_ms;
+        chord_group &= ~bit; // Let go before the window closed: not part of a chord
+    }
+    long_reported &= state;
+    second_tap &= state;
+    chorded &= state;
+
+    uint64_t pressed = toggled & state;
+    while (pressed)
+    {
+        const int key = __builtin_ctzll(pressed);
+        const uint64_t bit = 1ULL << key;
+        pressed &= pressed - 1;
+        push_event(KEY_EVENT_PRESS, key, now_ms);
+        queued = true;
+        press_ms[key] = now_ms;
+
+        if ((tap_armed & bit) && now_ms - release_ms[key] <= KEY_DOUBLE_TAP_MS)
+        {
+            push_event(KEY_EVENT_DOUBLE_TAP, key, now_ms);
+            second_tap |= bit;
+        }
+        tap_armed &= ~bit;
+
+        if (chord_group == 0 || now_ms - chord_start_ms > KEY_CHORD_WINDOW_MS)
+        {
+            chord_group = 0;
+            chord_start_ms = now_ms;
+        }
+        chord_group |= bit;
+    }
+
+    if (chord_group && now_ms - chord_start_ms >= KEY_CHORD_WINDOW_MS)
+    {
+        const int size = __builtin_popcountll(chord_group);
+        if (size >= 2)
+        {
+            if (size <= KEY_CHORD_MAX_KEYS)
+            {
+                push_event(KEY_EVENT_CHORD, __builtin_ctzll(chord_group), now_ms, chord_group);
+                queued = true;
+            }
+            chorded |= chord_group;
+        }
+        chord_group = 0;
+    }
+
+    // Keys still inside an open chord window wait for its outcome.
+    uint64_t holding = state & ~(long_reported | chorded | chord_group);
+    while (holding)
+    {
+        const int key = __builtin_ctzll(holding);
+        holding &= holding - 1;
+        if (now_ms - press_ms[key] >= KEY_LONG_PRESS_MS)
+        {
+            push_event(KEY_EVENT_LONG_PRESS, key, now_ms);
+            long_reported |= 1ULL << key;
+            queued = true;
+        }
+    }
+    return queued;
+}
+
+// --- PUBLIC API ---
+
+void key_events_init()
+{
+    portENTER_CRITICAL(&queue_mux);
+    queue_head = 0;
+    queue_count = 0;
+    next_seq = 1;
+    epoch = esp_random() % 0xFFFF + 1; // Never 0, so it cannot match a zeroed acknowledgement
+    portEXIT_CRITICAL(&queue_mux);
+}
+
+void key_events_fill_packet(struct_message_from_esp2 *data)
+{
+    const uint32_t now = millis();
+    uint32_t dropped = 0;
+    uint8_t count = 0;
+
+    portENTER_CRITICAL(&queue_mux);
+    while (queue_count && now - queue[queue_head].time_ms > KEY_EVENT_MAX_AGE_MS)
+    {
+        pop_front();
+        dropped_events++;
+    }
+    for (; count < queue_count && count < KEY_EVENTS_PER_PACKET; ++count)
+        data->key_events[count] = queue[(queue_head + count) & QUEUE_MASK];
+    last_sent_ms = now;
+    if (dropped_events)
+    {
+        dropped = dropped_events;
+        dropped_events = 0;
+    }
+    portEXIT_CRITICAL(&queue_mux);
+
+    memset(&data->key_events[count], 0, (KEY_EVENTS_PER_PACKET - count) * sizeof(PanelKeyEvent));
+    data->key_event_epoch = epoch;
+    data->key_event_count = count;
+
+    if (dropped && DEBUG_ENABLED)
+        Serial.printf("Key events: %u dropped undelivered (ESP1 not acknowledging).\n", (unsigned)dropped);
+}
+
+void key_events_acknowledge(uint16_t acked_epoch, uint16_t seq)
+{
+    if (acked_epoch != epoch)
+        return;
+    portENTER_CRITICAL(&queue_mux);
+    while (queue_count && (int16_t)(seq - queue[queue_head].seq) >= 0)
+        pop_front();
+    portEXIT_CRITICAL(&queue_mux);
+}
+
+bool key_events_resend_due(uint32_t now_ms)
+{
+    return queue_count != 0 && now_ms - last_sent_ms >= KEY_EVENT_RETRY_MS;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file key_events.h
+ * @brief Timestamped key event stream with gesture recognition (ESP2).
+ *
+ * The debounced edges of the button matrix are queued as PRESS/RELEASE
+ * records, so a tap shorter than the send interval still reaches ESP1.
+ * Gestures are recognized here, on top of the raw edges:
+ * - LONG_PRESS once a key has been held for KEY_LONG_PRESS_MS.
+ * - DOUBLE_TAP when a short tap is followed by a press of the same key
+ *   within KEY_DOUBLE_TAP_MS.
+ * - CHORD when 2..KEY_CHORD_MAX_KEYS keys go down within
+ *   KEY_CHORD_WINDOW_MS of the first one and are still held when that
+ *   window closes.
+ *   Keys of a chord report no long press or double tap of their own.
+ *
+ * Delivery: each event gets a sequence number and stays queued until ESP1
+ * acknowledges it in its status packet. Every panel packet carries the
+ * oldest unacknowledged events, and key_events_resend_due() asks for a
+ * packet while any are outstanding. Events not delivered within
+ * KEY_EVENT_MAX_AGE_MS (ESP1 unreachable) are dropped instead of being
+ * replayed after the link returns.
+ */
+
+#ifndef KEY_EVENTS_H
+#define KEY_EVENTS_H
+
+#include <Arduino.h>
+#include "config_esp2.h"
+#include "shared_structures.h"
+
+/**
+ * @brief Draws the stream epoch and clears the queue. Call once before the first scan.
+ */
+void key_events_init();
+
+/**
+ * @brief Records the edges of one debounced scan and updates the gestures.
+ * @param toggled Keys whose debounced state flipped with this scan.
+ * @param state Debounced state after the scan; bit set = pressed.
+ * @param now_ms Time of the scan.
+ * @return true if at least one event was queued.
+ */
+bool key_events_process(uint64_t toggled, uint64_t state, uint32_t now_ms);
+
+/**
+ * @brief Copies the oldest unacknowledged events into a panel packet.
+ * Fills key_event_epoch, key_event_count and key_events.
+ */
+void key_events_fill_packet(struct_message_from_esp2 *data);
+
+/**
+ * @brief Drops the events ESP1 has taken over. Safe from the ESP-NOW receive callback.
+ * @param acked_epoch Epoch echoed by ESP1; acknowledgements of another epoch are ignored.
+ * @param seq Highest sequence number acknowledged.
+ */
+void key_events_acknowledge(uint16_t acked_epoch, uint16_t seq);
+
+/**
+ * @brief True if events are outstanding and the last packet went out KEY_EVENT_RETRY_MS ago.
+ */
+bool key_events_resend_due(uint32_t now_ms);
+
+#endif // KEY_EVENTS_H
@@ -0,0 +1,197 @@
+/**
+ * @file led_matrix.cpp
+ * @brief Implements the LED refresh task, the pattern renderer and the bit-plane output.
+ */
+
+#include "led_matrix.h"
+#include "mcp_bus.h"
+#include "task_stats.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static const uint8_t LED_LEVELS = 1 << LED_PWM_BITS;
+
+// --- MODULE STATE ---
+
+// Inputs, written by the HMI side. Single bytes need no lock; the 64-bit
+// overrides are copied under led_mux.
+static portMUX_TYPE led_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t source_states[MATRIX_ROWS] = {0};
+static uint64_t forced_on = 0;
+static uint64_t forced_blink = 0;
+static uint8_t led_pattern[MAX_LEDS] = {0};
+static uint8_t led_level[MAX_LEDS]; // Level when fully on, 0 .. LED_LEVELS - 1
+static bool styled = false;
+
+// Output, owned by the refresh task: row bits lit during bit slice b of column c.
+static uint8_t planes[LED_PWM_BITS][MATRIX_COLS];
+
+static TaskHandle_t refresh_task = nullptr;
+static esp_timer_handle_t slice_timer = nullptr;
+static uint8_t rows_opcode = 0;
+static uint8_t cols_opcode = 0;
+
+// --- RENDERING ---
+
+/**
+ * @brief Builds the bit planes for one frame from the states, overrides and styles.
+ */
+static void render_frame(uint32_t now_ms)
+{
+    uint8_t states[MATRIX_ROWS];
+    memcpy(states, source_states, sizeof(states));
+    portENTER_CRITICAL(&led_mux);
+    const uint64_t on_mask = forced_on;
+    const uint64_t blink_mask = forced_blink;
+    portEXIT_CRITICAL(&led_mux);
+
+    const bool blink_lit = ((now_ms / LED_BLINK_MS) & 1) == 0;
+    const bool fast_blink_lit = ((now_ms / (LED_BLINK_MS / 2)) & 1) == 0;
+    // Triangle wave 0..256 over one pulse period.
+    const uint32_t phase = now_ms % LED_PULSE_PERIOD_MS;
+    const uint32_t half = LED_PULSE_PERIOD_MS / 2;
+    const uint32_t pulse = ((phase < half ? phase : LED_PULSE_PERIOD_MS - phase) << 8) / half;
+
+    memset(planes, 0, sizeof(planes));
+    for (int led = 0; led < MAX_LEDS; ++led)
+    {
+        const int row = led / MATRIX_COLS;
+        const int col = led % MATRIX_COLS;
+        if (!bitRead(states[row], col) && !((on_mask >> led) & 1))
+            continue;
+
+        const uint8_t pattern = ((blink_mask >> led) & 1) ? LED_PATTERN_BLINK : led_pattern[led];
+        uint32_t level = led_level[led];
+        switch (pattern)
+        {
+        case LED_PATTERN_BLINK:
+            if (!blink_lit)
+                level = 0;
+            break;
+        case LED_PATTERN_FAST_BLINK:
+            if (!fast_blink_lit)
+                level = 0;
+            break;
+        case LED_PATTERN_PULSE:
+            level = (level * pulse + 128) >> 8;
+            break;
+        default:
+            break;
+        }
+
+        for (int b = 0; b < LED_PWM_BITS; ++b)
+        {
+            if (level & (1U << b))
+                planes[b][col] |= 1U << row;
+        }
+    }
+}
+
+// --- REFRESH TASK ---
+
+// Runs in the esp_timer task; only wakes the refresh task.
+static void on_slice_timer(void *)
+{
+    xTaskNotifyGive(refresh_task);
+}
+
+/**
+ * @brief Multiplexes the matrix forever, one frame per pass.
+ *
+ * The slice timer is started before the SPI frames go out, so the bus time
+ * overlaps the slice instead of stretching it. The time spent rendering and
+ * on the bus is reported to task_stats once per frame.
+ */
+static void led_refresh_task(void *)
+{
+    uint8_t blank[3] = {cols_opcode, MCP_OLATA, 0x00};
+    uint8_t rows[3] = {rows_opcode, MCP_OLATA, 0x00};
+    uint8_t select[3] = {cols_opcode, MCP_OLATA, 0x00};
+
+    for (;;)
+    {
+        uint32_t start = task_stats_begin();
+        render_frame(millis());
+        uint32_t busy_us = task_stats_begin() - start;
+        for (int col = 0; col < MATRIX_COLS; ++col)
+        {
+            for (int b = 0; b < LED_PWM_BITS; ++b)
+            {
+                start = task_stats_begin();
+                esp_timer_start_once(slice_timer, (uint64_t)LED_PWM_UNIT_US << b);
+                rows[2] = planes[b][col];
+                mcp_bus_begin();
+                if (b == 0)
+                {
+                    // Blank before the row data changes, so the previous column does not ghost.
+                    select[2] = 1U << col;
+                    mcp_bus_transfer(blank, nullptr, 3);
+                    mcp_bus_transfer(rows, nullptr, 3);
+                    mcp_bus_transfer(select, nullptr, 3);
+                }
+                else
+                {
+                    mcp_bus_transfer(rows, nullptr, 3);
+                }
+                mcp_bus_end();
+                busy_us += task_stats_begin() - start;
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            }
+        }
+        task_stats_add(PANEL_TASK_LED, busy_us);
+    }
+}
+
+// --- PUBLIC API ---
+
+void led_matrix_init(uint8_t rows_addr, uint8_t cols_addr)
+{
+    rows_opcode = mcp_opcode(rows_addr, false);
+    cols_opcode = mcp_opcode(cols_addr, false);
+
+    // Both ports as outputs, all low: rows dark, no column selected.
+    const uint8_t iodir[2] = {0x00, 0x00};
+    const uint8_t latches[2] = {0x00, 0x00};
+    mcp_bus_write(cols_addr, MCP_OLATA, latches, 2);
+    mcp_bus_write(rows_addr, MCP_OLATA, latches, 2);
+    mcp_bus_write(cols_addr, MCP_IODIRA, iodir, 2);
+    mcp_bus_write(rows_addr, MCP_IODIRA, iodir, 2);
+
+    if (!styled)
+        led_matrix_apply_styles(nullptr, 0);
+
+    esp_timer_create_args_t args = {};
+    args.callback = on_slice_timer;
+    args.name = "led_slice";
+    esp_timer_create(&args, &slice_timer);
+    xTaskCreatePinnedToCore(led_refresh_task, "led_refresh", 2048, nullptr,
+                            LED_REFRESH_TASK_PRIORITY, &refresh_task, LED_REFRESH_CORE);
+    task_stats_register(PANEL_TASK_LED, "led_refresh", refresh_task);
+}
+
+void led_matrix_set_states(const uint8_t states[MATRIX_ROWS])
+{
+    memcpy(source_states, states, sizeof(source_states));
+}
+
+void led_matrix_set_overrides(uint64_t on, uint64_t blink)
+{
+    portENTER_CRITICAL(&led_mux);
+    forced_on = on;
+    forced_blink = blink;
+    portEXIT_CRITICAL(&led_mux);
+}
+
+void led_matrix_apply_styles(const LedDynamicConfig *leds, int count)
+{
+    for (int i = 0; i < MAX_LEDS; ++i)
+    {
+        const bool configured = i < count;
+        const uint8_t pct = configured ? min<uint8_t>(leds[i].brightness_pct, 100) : 100;
+        const uint8_t pattern = configured ? leds[i].pattern : LED_PATTERN_STEADY;
+        led_pattern[i] = pattern < LED_PATTERN_COUNT ? pattern : LED_PATTERN_STEADY;
+        led_level[i] = (pct * (LED_LEVELS - 1) + 50) / 100;
+    }
+    styled = true;
+}
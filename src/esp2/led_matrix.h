@@ -0,0 +1,53 @@
+/**
+ * @file led_matrix.h
+ * @brief Timer-driven refresh of the 8x8 LED matrix with per-LED brightness (ESP2).
+ *
+ * A dedicated task multiplexes the matrix at a fixed rate, independent of
+ * how long a pass of the main loop takes. Each column is lit for
+ * 2^LED_PWM_BITS - 1 time units, split into one slice per brightness bit
+ * (bit-angle modulation), with slice lengths timed by a one-shot esp_timer.
+ * Per column change the bus carries three frames (blank, rows, select), and
+ * each further slice carries a single OLATA write to the row chip.
+ *
+ * Patterns (blink, pulse) and binding overrides are rendered into bit planes
+ * once per frame, so a blinking alarm LED only needs a steady bit from
+ * LinuxCNC.
+ */
+
+#ifndef LED_MATRIX_H
+#define LED_MATRIX_H
+
+#include <Arduino.h>
+#include "config_esp2.h"
+#include "persistence.h"
+
+/**
+ * @brief Programs both LED expanders as outputs and starts the refresh task.
+ * Call after mcp_bus_init().
+ * @param rows_addr Hardware address of the row driver chip (port A).
+ * @param cols_addr Hardware address of the column select chip (port A).
+ */
+void led_matrix_init(uint8_t rows_addr, uint8_t cols_addr);
+
+/**
+ * @brief Sets which LEDs are lit, one byte per row (bit n = column n).
+ * Takes effect at the next frame.
+ */
+void led_matrix_set_states(const uint8_t states[MATRIX_ROWS]);
+
+/**
+ * @brief Applies binding overrides on top of the LED states.
+ * @param forced_on Bit (row * MATRIX_COLS + col): LED lit regardless of its state.
+ * @param forced_blink Same indexing: LED uses the blink pattern regardless of its style.
+ */
+void led_matrix_set_overrides(uint64_t forced_on, uint64_t forced_blink);
+
+/**
+ * @brief Copies pattern and brightness of every LED from the web configuration.
+ * Safe to call before led_matrix_init() and while the refresh task runs.
+ * @param leds The LED settings, usually web_cfg.leds.
+ * @param count Number of entries in @p leds.
+ */
+void led_matrix_apply_styles(const LedDynamicConfig *leds, int count);
+
+#endif // LED_MATRIX_H
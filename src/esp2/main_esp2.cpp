@@ -1,6 +1,20 @@
 /**
  * @file main_esp2.cpp
  * @brief Main firmware for ESP2, the Main HMI Panel Controller. (Fully Implemented)
+ *
+ * setup() brings the peripherals, ESP-NOW and the web server up and then
+ * starts the panel tasks; loop() is not used. Nothing waits for Wi-Fi, so
+ * the panel is operational right after boot with or without a network.
+ * The tasks are, by priority:
+ * - LED refresh (led_matrix.cpp), core 1: timer-paced matrix multiplexing.
+ * - Input, core 1: hmi_task() every INPUT_TASK_PERIOD_MS; wakes the comms
+ *   task when an input changed.
+ * - Comms, core 0: sends panel packets to ESP1 and processes the status
+ *   packets handed over by the ESP-NOW receive callback.
+ * - Web, core 0: Wi-Fi join and soft-AP fallback (connectivity.cpp), live
+ *   status, calibration status and the task load report.
+ * Data crosses tasks through lock-free snapshots (snapshot.h) and task
+ * notifications, so no task waits for a slower one.
  */
 
 #include <Arduino.h>
@@ -14,12 +28,32 @@
 #include "shared_structures.h"
 #include "persistence.h"
 #include "hmi_handler.h"
+#include "action_bindings.h"
+#include "led_matrix.h"
+#include "joystick_calibration.h"
+#include "key_events.h"
+#include "snapshot.h"
+#include "task_stats.h"
+#include "web_assets.h"
+#include "connectivity.h"
 
 // --- GLOBAL OBJECTS ---
 AsyncWebServer server(80);
 AsyncWebSocket ws("/ws");
-struct_message_from_esp2 outgoing_hmi_data;
-struct_message_to_hmi incoming_lcnc_data;
+const unsigned long CALIBRATION_STATUS_MS = 200; // Live min/center/max updates while calibrating
+static uint32_t calibration_client_id = 0; // Client that started the calibration
+
+// --- TASK STATE ---
+static TaskHandle_t input_task_handle = nullptr;
+static TaskHandle_t comms_task_handle = nullptr;
+static TaskHandle_t web_task_handle = nullptr;
+static Snapshot<struct_message_to_hmi> lcnc_snapshot; // Written by the ESP-NOW receive callback only
+static volatile bool live_status_dirty = false;       // Buttons or LEDs changed since the last broadcast
+static volatile bool panel_send_failed = false;       // ESP1 did not acknowledge the last panel packet
+
+// Notification bits for the comms task.
+static const uint32_t NOTIFY_HMI_CHANGED = 1 << 0;
+static const uint32_t NOTIFY_LCNC_RECEIVED = 1 << 1;
 
 // --- HELPER FUNCTIONS ---
 void broadcast_live_status()
@@ -42,6 +76,64 @@ void broadcast_live_status()
     ws.textAll(json_output);
 }
 
+void send_config(AsyncWebSocketClient *client)
+{
+    // Stream the envelope and config straight into the frame buffer.
+    bool sent = ws_send_json(client, [](JsonStreamWriter &w)
+                             {
+        w.begin_object();
+        w.field("type", "initialConfig");
+        w.key("payload");
+        write_config_json(w);
+        w.end_object(); });
+    if (!sent && DEBUG_ENABLED)
+        Serial.println("ERROR: Out of memory for initialConfig frame.");
+}
+
+void broadcast_calibration_status()
+{
+    String json_output;
+    StringPrint sink(json_output);
+    JsonStreamWriter w(sink);
+    w.begin_object();
+    w.field("type", "calibrationStatus");
+    w.key("payload");
+    joystick_calibration_write_status(w);
+    w.end_object();
+    ws.textAll(json_output);
+}
+
+void send_calibration_result(AsyncWebSocketClient *client, const char *error)
+{
+    String json_output;
+    StringPrint sink(json_output);
+    JsonStreamWriter w(sink);
+    w.begin_object();
+    w.field("type", "calibrationResult");
+    w.key("payload");
+    w.begin_object();
+    w.field("ok", error == nullptr);
+    w.field("message", error ? error : "Calibration saved.");
+    w.end_object();
+    w.end_object();
+    client->text(json_output);
+}
+
+void broadcast_task_stats()
+{
+    String json_output;
+    StringPrint sink(json_output);
+    JsonStreamWriter w(sink);
+    w.begin_object();
+    w.field("type", "taskStats");
+    w.key("payload");
+    task_stats_write_report(w);
+    w.end_object();
+    ws.textAll(json_output);
+    if (DEBUG_ENABLED)
+        Serial.println(json_output);
+}
+
 // --- WEBSOCKET EVENT HANDLER ---
 void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len)
 {
@@ -49,25 +141,15 @@ void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventTyp
     {
         if (DEBUG_ENABLED)
             Serial.printf("WebSocket client #%u connected\n", client->id());
-
-        StaticJsonDocument<4096> doc;
-        doc["type"] = "initialConfig";
-
-        // CORRECTED: Parse the config string into a temporary document first.
-        StaticJsonDocument<4096> payload_doc;
-        deserializeJson(payload_doc, get_config_as_json());
-
-        // Then, assign the parsed object to the "payload" key.
-        doc["payload"] = payload_doc;
-
-        String json_output;
-        serializeJson(doc, json_output);
-        client->text(json_output);
+        send_config(client);
     }
     else if (type == WS_EVT_DISCONNECT)
     {
         if (DEBUG_ENABLED)
             Serial.printf("WebSocket client #%u disconnected\n", client->id());
+        // Nobody is left to finish it; give the joystick back.
+        if (joystick_calibration_active(-1) && client->id() == calibration_client_id)
+            joystick_calibration_cancel();
     }
     else if (type == WS_EVT_DATA)
     {
@@ -80,19 +162,169 @@ void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventTyp
                 String config_payload;
                 serializeJson(doc["payload"], config_payload);
                 save_configuration(config_payload);
+                action_bindings_compile(web_cfg.bindings, MAX_ACTION_BINDINGS);
+                led_matrix_apply_styles(web_cfg.leds, MAX_LEDS);
+                joystick_tables_invalidate();
+            }
+            else if (strcmp(command, "startCalibration") == 0)
+            {
+                if (joystick_calibration_start(doc["payload"]["joystick"] | 0))
+                    calibration_client_id = client->id();
+                else
+                    send_calibration_result(client, "Joystick input is not ready yet, or no such joystick.");
+            }
+            else if (strcmp(command, "finishCalibration") == 0)
+            {
+                // The config goes first: it rebuilds the joystick table the result is shown in.
+                const char *error = joystick_calibration_finish();
+                if (!error)
+                    send_config(client);
+                send_calibration_result(client, error);
+            }
+            else if (strcmp(command, "cancelCalibration") == 0)
+            {
+                joystick_calibration_cancel();
             }
         }
     }
 }
 
 // --- ESP-NOW CALLBACKS ---
-void OnDataSent(const uint8_t *mac_addr, esp_now_send_status_t status) {}
+void OnDataSent(const uint8_t *mac_addr, esp_now_send_status_t status)
+{
+    panel_send_failed = (status != ESP_NOW_SEND_SUCCESS);
+}
+
+// Runs in the Wi-Fi task: only hands the packet over to the comms task.
 void OnDataRecv(const uint8_t *mac, const uint8_t *incomingData, int len)
 {
-    memcpy(&incoming_lcnc_data, incomingData, sizeof(incoming_lcnc_data));
-    evaluate_action_bindings(incoming_lcnc_data);
-    update_leds_from_lcnc(incoming_lcnc_data);
-    broadcast_live_status();
+    if (len != sizeof(struct_message_to_hmi))
+        return;
+    struct_message_to_hmi packet;
+    memcpy(&packet, incomingData, sizeof(packet));
+    lcnc_snapshot.publish(packet);
+    if (comms_task_handle)
+        xTaskNotify(comms_task_handle, NOTIFY_LCNC_RECEIVED, eSetBits);
+}
+
+// --- PANEL TASKS ---
+
+/**
+ * @brief Runs hmi_task() at a fixed rate and wakes the comms task on changes.
+ */
+static void input_task(void *)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    for (;;)
+    {
+        const uint32_t start = task_stats_begin();
+        hmi_task();
+        if (hmi_data_has_changed())
+        {
+            xTaskNotify(comms_task_handle, NOTIFY_HMI_CHANGED, eSetBits);
+            live_status_dirty = true;
+        }
+        task_stats_end(PANEL_TASK_INPUT, start);
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(INPUT_TASK_PERIOD_MS));
+    }
+}
+
+static bool joystick_deflected(const struct_message_from_esp2 &packet)
+{
+    for (size_t i = 0; i < sizeof(packet.joystick_values) / sizeof(packet.joystick_values[0]); i++)
+        if (packet.joystick_values[i] != 0)
+            return true;
+    return false;
+}
+
+/**
+ * @brief Sends panel packets and processes status packets from ESP1.
+ * Without notifications it still wakes every KEY_EVENT_RETRY_MS, so
+ * unacknowledged key events are repeated until ESP1 confirms them.
+ * Packets otherwise only go out on change; while a stick is deflected or
+ * the last packet was lost, the full packet is repeated every
+ * JOYSTICK_REFRESH_MS so a lost "back to center" can't leave an axis jogging.
+ */
+static void comms_task(void *)
+{
+    struct_message_from_esp2 packet;
+    uint32_t last_send_ms = 0;
+    bool deflected = false;
+    for (;;)
+    {
+        uint32_t events = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &events, pdMS_TO_TICKS(KEY_EVENT_RETRY_MS));
+        const uint32_t start = task_stats_begin();
+        if (events & NOTIFY_LCNC_RECEIVED)
+        {
+            const struct_message_to_hmi status = lcnc_snapshot.read();
+            key_events_acknowledge(status.key_event_epoch, status.key_event_ack);
+            evaluate_action_bindings(status);
+            if (update_leds_from_lcnc(status))
+                live_status_dirty = true;
+        }
+        const uint32_t now = millis();
+        const bool refresh_due = (deflected || panel_send_failed) && now - last_send_ms >= JOYSTICK_REFRESH_MS;
+        if ((events & NOTIFY_HMI_CHANGED) || key_events_resend_due(now) || refresh_due)
+        {
+            get_hmi_data(&packet);
+            if (esp_now_send(esp1_mac_address, (uint8_t *)&packet, sizeof(packet)) != ESP_OK)
+                panel_send_failed = true; // No send callback follows
+            last_send_ms = now;
+            deflected = joystick_deflected(packet);
+        }
+        task_stats_end(PANEL_TASK_COMMS, start);
+    }
+}
+
+/**
+ * @brief Keeps Wi-Fi going and serves the browsers: live status at most every
+ * WEB_TASK_PERIOD_MS, calibration status while calibrating, and the task load report.
+ */
+static void web_task(void *)
+{
+    unsigned long last_calibration_status_ms = 0;
+    unsigned long last_stats_ms = millis();
+    TickType_t last_wake = xTaskGetTickCount();
+    for (;;)
+    {
+        const uint32_t start = task_stats_begin();
+        const unsigned long now = millis();
+        connectivity_poll();
+        ws.cleanupClients();
+        if (live_status_dirty)
+        {
+            live_status_dirty = false;
+            broadcast_live_status();
+        }
+        if (joystick_calibration_active(-1) && now - last_calibration_status_ms >= CALIBRATION_STATUS_MS)
+        {
+            last_calibration_status_ms = now;
+            broadcast_calibration_status();
+        }
+        task_stats_end(PANEL_TASK_WEB, start);
+
+        if (now - last_stats_ms >= TASK_STATS_REPORT_MS)
+        {
+            last_stats_ms = now;
+            broadcast_task_stats();
+        }
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(WEB_TASK_PERIOD_MS));
+    }
+}
+
+/**
+ * @brief Starts the input, comms and web tasks (the LED task runs since hmi_init()).
+ */
+static void start_panel_tasks()
+{
+    // Comms first: the input task notifies it from its first pass on.
+    xTaskCreatePinnedToCore(comms_task, "comms", 4096, nullptr, COMMS_TASK_PRIORITY, &comms_task_handle, COMMS_TASK_CORE);
+    xTaskCreatePinnedToCore(input_task, "input", 4096, nullptr, INPUT_TASK_PRIORITY, &input_task_handle, INPUT_TASK_CORE);
+    xTaskCreatePinnedToCore(web_task, "web", 6144, nullptr, WEB_TASK_PRIORITY, &web_task_handle, WEB_TASK_CORE);
+    task_stats_register(PANEL_TASK_COMMS, "comms", comms_task_handle);
+    task_stats_register(PANEL_TASK_INPUT, "input", input_task_handle);
+    task_stats_register(PANEL_TASK_WEB, "web", web_task_handle);
 }
 
 // --- MAIN SETUP AND LOOP ---
@@ -105,50 +337,37 @@ void setup()
         return;
     }
     load_configuration();
+    action_bindings_compile(web_cfg.bindings, MAX_ACTION_BINDINGS);
+    led_matrix_apply_styles(web_cfg.leds, MAX_LEDS);
     hmi_init();
 
-    WiFi.mode(WIFI_STA);
-    WiFi.setHostname(OTA_HOSTNAME);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-    while (WiFi.status() != WL_CONNECTED)
-    {
-        delay(500);
-    }
-    if (DEBUG_ENABLED)
-        Serial.printf("WiFi Connected. IP: %s\n", WiFi.localIP().toString().c_str());
-
+    // ESP-NOW needs no access point; the Wi-Fi join runs in the web task.
+    connectivity_init();
     esp_now_init();
     esp_now_register_send_cb(OnDataSent);
     esp_now_register_recv_cb(OnDataRecv);
     esp_now_peer_info_t peerInfo = {};
     memcpy(peerInfo.peer_addr, esp1_mac_address, 6);
+    peerInfo.channel = ESPNOW_CHANNEL;
     esp_now_add_peer(&peerInfo);
 
     ws.onEvent(onWsEvent);
     server.addHandler(&ws);
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request)
-              { request->send(LittleFS, "/index.html", "text/html"); });
-    server.on("/style.css", HTTP_GET, [](AsyncWebServerRequest *request)
-              { request->send(LittleFS, "/style.css", "text/css"); });
-    server.on("/script.js", HTTP_GET, [](AsyncWebServerRequest *request)
-              { request->send(LittleFS, "/script.js", "application/javascript"); });
     server.on("/get_config_json", HTTP_GET, [](AsyncWebServerRequest *request)
               { request->send(200, "application/json", get_config_as_json()); });
 
     AsyncElegantOTA.begin(&server);
+    // Registered last: the raw-file fallback is a catch-all on "/"
+    web_assets_register(server, LittleFS);
     server.begin();
     if (DEBUG_ENABLED)
         Serial.println("Web server and OTA handler started.");
+
+    start_panel_tasks();
 }
 
 void loop()
 {
-    hmi_task();
-    ws.cleanupClients();
-    if (hmi_data_has_changed())
-    {
-        get_hmi_data(&outgoing_hmi_data);
-        esp_now_send(esp1_mac_address, (uint8_t *)&outgoing_hmi_data, sizeof(outgoing_hmi_data));
-        broadcast_live_status();
-    }
+    // All work runs in the panel tasks started by setup().
+    vTaskDelete(nullptr);
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+/**
+ * @file mcp_bus.cpp
+ * @brief Implements the shared MCP23S17 bus access.
+ */
+
+#include "mcp_bus.h"
+#include <soc/gpio_reg.h>
+
+// --- MODULE STATE ---
+static SPIClass *bus = nullptr;
+static uint32_t cs_mask = 0;
+static const SPISettings mcp_spi_settings(MCP_SPI_CLOCK_HZ, MSBFIRST, SPI_MODE0);
+
+// --- PUBLIC API ---
+
+void mcp_bus_init(SPIClass *spi, uint8_t cs_pin)
+{
+    bus = spi;
+    cs_mask = 1UL << cs_pin; // Shared CS is on GPIO0-31 (see config_esp2.h)
+    pinMode(cs_pin, OUTPUT);
+    REG_WRITE(GPIO_OUT_W1TS_REG, cs_mask);
+
+    // With HAEN still off, every chip answers address 0; this write turns
+    // address decoding on for all of them.
+    const uint8_t iocon = IOCON_HAEN;
+    mcp_bus_write(0, MCP_IOCON, &iocon, 1);
+}
+
+void mcp_bus_begin()
+{
+    bus->beginTransaction(mcp_spi_settings);
+}
+
+void mcp_bus_end()
+{
+    bus->endTransaction();
+}
+
+void mcp_bus_transfer(const uint8_t *tx, uint8_t *rx, uint32_t len)
+{
+    REG_WRITE(GPIO_OUT_W1TC_REG, cs_mask);
+    bus->transferBytes(tx, rx, len);
+    REG_WRITE(GPIO_OUT_W1TS_REG, cs_mask);
+}
+
+// Consecutive registers go in one frame (IOCON.SEQOP = 0 auto-increments).
+void mcp_bus_write(uint8_t hw_addr, uint8_t reg, const uint8_t *data, uint8_t len)
+{
+    uint8_t tx[2 + 4] = {mcp_opcode(hw_addr, false), reg};
+    memcpy(tx + 2, data, len);
+    mcp_bus_begin();
+    mcp_bus_transfer(tx, nullptr, 2 + len);
+    mcp_bus_end();
+}
+
+void mcp_bus_read(uint8_t hw_addr, uint8_t reg, uint8_t *data, uint8_t len)
+{
+    uint8_t tx[2 + 4] = {mcp_opcode(hw_addr, true), reg};
+    uint8_t rx[2 + 4];
+    mcp_bus_begin();
+    mcp_bus_transfer(tx, rx, 2 + len);
+    mcp_bus_end();
+    memcpy(data, rx + 2, len);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file mcp_bus.h
+ * @brief Raw register access to the MCP23S17 expanders on the shared SPI bus (ESP2).
+ *
+ * All expanders share one chip select and are told apart by their A2..A0
+ * hardware address (IOCON.HAEN). Chip select is driven straight through the
+ * GPIO set/clear registers. Callers that issue several frames in a row wrap
+ * them in one mcp_bus_begin()/mcp_bus_end() pair; that pair also serializes
+ * the bus, since SPIClass holds its mutex from beginTransaction() to
+ * endTransaction(). The LED refresh task and the matrix scanner can therefore
+ * run in different tasks.
+ */
+
+#ifndef MCP_BUS_H
+#define MCP_BUS_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "config_esp2.h"
+
+// --- MCP23S17 REGISTERS (IOCON.BANK = 0) ---
+static const uint8_t MCP_IODIRA = 0x00;
+static const uint8_t MCP_GPINTENB = 0x05;
+static const uint8_t MCP_DEFVALB = 0x07;
+static const uint8_t MCP_INTCONB = 0x09;
+static const uint8_t MCP_IOCON = 0x0A;
+static const uint8_t MCP_GPPUA = 0x0C;
+static const uint8_t MCP_GPIOA = 0x12;
+static const uint8_t MCP_GPIOB = 0x13;
+static const uint8_t MCP_OLATA = 0x14;
+
+static const uint8_t IOCON_MIRROR = 0x40; // INTA and INTB both signal either port
+static const uint8_t IOCON_HAEN = 0x08;   // Hardware address pins enabled (shared CS)
+
+/**
+ * @brief Returns the SPI opcode byte addressing one chip.
+ * @param hw_addr The chip's A2..A0 hardware address.
+ * @param read true for a register read, false for a write.
+ */
+inline uint8_t mcp_opcode(uint8_t hw_addr, bool read)
+{
+    return 0x40 | (hw_addr << 1) | (read ? 0x01 : 0x00);
+}
+
+/**
+ * @brief Takes over the shared chip select and turns on address decoding in every chip.
+ * @param spi The bus shared by the expanders (already begun).
+ * @param cs_pin The shared chip-select pin; must be GPIO0-31.
+ */
+void mcp_bus_init(SPIClass *spi, uint8_t cs_pin);
+
+/**
+ * @brief Locks the bus and applies the expander SPI settings.
+ */
+void mcp_bus_begin();
+
+/**
+ * @brief Releases the bus locked by mcp_bus_begin().
+ */
+void mcp_bus_end();
+
+/**
+ * @brief Clocks one chip-select frame. Only valid between mcp_bus_begin() and mcp_bus_end().
+ * @param tx Opcode, register and data bytes.
+ * @param rx Receives the same number of bytes, or nullptr.
+ */
+void mcp_bus_transfer(const uint8_t *tx, uint8_t *rx, uint32_t len);
+
+/**
+ * @brief Writes consecutive registers of one chip in a single, self-locking transaction.
+ * @param len Number of data bytes (at most 4).
+ */
+void mcp_bus_write(uint8_t hw_addr, uint8_t reg, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Reads consecutive registers of one chip in a single, self-locking transaction.
+ * @param len Number of data bytes (at most 4).
+ */
+void mcp_bus_read(uint8_t hw_addr, uint8_t reg, uint8_t *data, uint8_t len);
+
+#endif // MCP_BUS_H
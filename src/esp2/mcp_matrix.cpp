@@ -0,0 +1,144 @@
+/**
+ * @file mcp_matrix.cpp
+ * @brief Implements raw-register matrix scanning on the MCP23S17.
+ */
+
+#include "mcp_matrix.h"
+#include "mcp_bus.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// --- MODULE STATE ---
+
+// Pre-built frames: one OLATA write per row plus the "all rows idle" write,
+// and the GPIOB read. Only the receive buffer changes between scans.
+static uint8_t row_frames[MATRIX_ROWS + 1][3];
+static uint8_t read_frame[3];
+
+// --- IDLE MODE STATE ---
+static uint8_t chip_addr = 0;
+static int irq_pin = -1;
+static bool idle = false;
+static SemaphoreHandle_t wake_sem = nullptr;
+
+static void IRAM_ATTR on_matrix_interrupt()
+{
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(wake_sem, &woken);
+    if (woken)
+        portYIELD_FROM_ISR();
+}
+
+// --- PUBLIC API ---
+
+void mcp_matrix_init(uint8_t hw_addr, int int_pin)
+{
+    chip_addr = hw_addr;
+    const uint8_t write_op = mcp_opcode(hw_addr, false);
+
+    const uint8_t chip_iocon = IOCON_HAEN | IOCON_MIRROR; // INT active-low push-pull
+    mcp_bus_write(hw_addr, MCP_IOCON, &chip_iocon, 1);
+
+    // IODIRA/IODIRB and GPPUA/GPPUB are adjacent: one frame per pair.
+    const uint8_t iodir[2] = {0x00, 0xFF}; // Rows out, columns in
+    const uint8_t gppu[2] = {0x00, 0xFF};  // Pull-ups on columns
+    mcp_bus_write(hw_addr, MCP_IODIRA, iodir, 2);
+    mcp_bus_write(hw_addr, MCP_GPPUA, gppu, 2);
+
+    // Interrupt on "column differs from DEFVAL (high)", i.e. while any key is down.
+    // Kept disarmed (GPINTENB = 0) until idle mode.
+    const uint8_t defval = 0xFF, intcon = 0xFF, gpinten = 0x00;
+    mcp_bus_write(hw_addr, MCP_DEFVALB, &defval, 1);
+    mcp_bus_write(hw_addr, MCP_INTCONB, &intcon, 1);
+    mcp_bus_write(hw_addr, MCP_GPINTENB, &gpinten, 1);
+
+    irq_pin = int_pin;
+    if (irq_pin >= 0)
+    {
+        wake_sem = xSemaphoreCreateBinary();
+        pinMode(irq_pin, INPUT_PULLUP);
+        attachInterrupt(digitalPinToInterrupt(irq_pin), on_matrix_interrupt, FALLING);
+    }
+
+    for (int row = 0; row <= MATRIX_ROWS; ++row)
+    {
+        row_frames[row][0] = write_op;
+        row_frames[row][1] = MCP_OLATA;
+        row_frames[row][2] = (row < MATRIX_ROWS) ? (uint8_t)~(1U << row) : 0xFF;
+    }
+    read_frame[0] = mcp_opcode(hw_addr, true);
+    read_frame[1] = MCP_GPIOB;
+    read_frame[2] = 0x00;
+
+    mcp_bus_write(hw_addr, MCP_OLATA, &row_frames[MATRIX_ROWS][2], 1); // All rows idle (high)
+}
+
+void mcp_matrix_scan(uint8_t pressed_cols[MATRIX_ROWS])
+{
+    uint8_t rx[3];
+
+    mcp_bus_begin();
+    mcp_bus_transfer(row_frames[0], nullptr, 3);
+    for (int row = 0; row < MATRIX_ROWS; ++row)
+    {
+        // The row has settled during the previous frame; sample, then drive the next.
+        mcp_bus_transfer(read_frame, rx, 3);
+        pressed_cols[row] = ~rx[2]; // Columns read low when pressed
+        mcp_bus_transfer(row_frames[row + 1], nullptr, 3);
+    }
+    mcp_bus_end();
+}
+
+void mcp_matrix_enter_idle()
+{
+    if (irq_pin < 0 || idle)
+        return;
+
+    const uint8_t rows_low = 0x00, arm = 0xFF;
+    uint8_t rx[3];
+
+    xSemaphoreTake(wake_sem, 0); // Drop a stale wake-up from before the last scan
+    mcp_bus_write(chip_addr, MCP_OLATA, &rows_low, 1);
+    mcp_bus_write(chip_addr, MCP_GPINTENB, &arm, 1);
+
+    // Reading GPIOB clears the interrupt latch. A key that is already down
+    // re-asserts INT immediately (DEFVAL compare), but the edge may have
+    // come before the ISR was armed, so check the sample as well.
+    mcp_bus_begin();
+    mcp_bus_transfer(read_frame, rx, 3);
+    mcp_bus_end();
+    idle = true;
+    if (rx[2] != 0xFF)
+        xSemaphoreGive(wake_sem);
+}
+
+bool mcp_matrix_wait_for_activity(uint32_t wait_ms)
+{
+    if (!idle)
+        return true;
+    if (xSemaphoreTake(wake_sem, pdMS_TO_TICKS(wait_ms)) != pdTRUE)
+        return false;
+
+    // Disarm; the next scan drives the rows itself and ends with them high.
+    const uint8_t disarm = 0x00;
+    mcp_bus_write(chip_addr, MCP_GPINTENB, &disarm, 1);
+    idle = false;
+    return true;
+}
+
+void mcp_matrix_benchmark(uint32_t scans)
+{
+    uint8_t cols[MATRIX_ROWS];
+    if (scans == 0)
+        scans = 1;
+
+    int64_t t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < scans; ++i)
+        mcp_matrix_scan(cols);
+    int64_t elapsed = esp_timer_get_time() - t0;
+
+    const float us_per_scan = (float)elapsed / scans;
+    Serial.printf("BENCH matrix scan: %.1f us/scan (%.0f scans/s), %d SPI frames/scan at %u Hz\n",
+                  us_per_scan, 1e6f / us_per_scan, 2 * MATRIX_ROWS + 1, (unsigned)MCP_SPI_CLOCK_HZ);
+}
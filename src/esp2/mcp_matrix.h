@@ -0,0 +1,62 @@
+/**
+ * @file mcp_matrix.h
+ * @brief Bulk-port scanner for the 8x8 button matrix on the MCP23S17 (ESP2).
+ *
+ * Rows are GPA0-7 (outputs, active low) and columns are GPB0-7 (inputs with
+ * pull-ups). Instead of one read-modify-write per pin through the Adafruit
+ * driver, a full scan writes OLATA once per row and reads all eight columns
+ * with a single GPIOB read. The 3-byte SPI frames are pre-built at init and
+ * sent through mcp_bus in one bus transaction. Row writes are pipelined
+ * behind column reads, so a scan is 9 writes + 8 reads.
+ *
+ * Idle mode: when the matrix has been quiet for a few scans, all rows are
+ * driven low and port B's interrupt-on-change is armed in DEFVAL-compare
+ * mode (INT asserts while any column reads low). Polling stops until the
+ * interrupt fires, and a key already held when idle starts wakes it at once.
+ */
+
+#ifndef MCP_MATRIX_H
+#define MCP_MATRIX_H
+
+#include <Arduino.h>
+#include "config_esp2.h"
+
+/**
+ * @brief Configures the button MCP23S17 for scanning with sequential register writes.
+ *
+ * Call after mcp_bus_init(). Only the IOCON, direction, pull-up, latch and
+ * interrupt registers of the given chip are programmed.
+ * @param hw_addr The chip's A2..A0 hardware address.
+ * @param int_pin ESP32 GPIO wired to the chip's INTA/INTB (mirrored), or -1
+ *        if not wired; idle mode is then never entered.
+ */
+void mcp_matrix_init(uint8_t hw_addr, int int_pin);
+
+/**
+ * @brief Scans the whole matrix once.
+ * @param pressed_cols Receives one byte per row; bit n set = column n pressed.
+ */
+void mcp_matrix_scan(uint8_t pressed_cols[MATRIX_ROWS]);
+
+/**
+ * @brief Drives all rows low and arms the column interrupt.
+ * Call after a scan found the matrix idle. No-op without an interrupt pin.
+ */
+void mcp_matrix_enter_idle();
+
+/**
+ * @brief Waits for a key to wake the matrix from idle mode.
+ *
+ * On wake the interrupt is disarmed, so the caller resumes full scans.
+ * @param wait_ms How long to block; 0 just polls.
+ * @return true if the caller should scan (woken, or idle mode unavailable).
+ */
+bool mcp_matrix_wait_for_activity(uint32_t wait_ms);
+
+/**
+ * @brief Times full scans and prints the achievable scan rate to Serial.
+ * @param scans Number of scans to average over.
+ */
+void mcp_matrix_benchmark(uint32_t scans);
+
+#endif // MCP_MATRIX_H
@@ -1,12 +1,30 @@
 /**
  * @file persistence.cpp
- * @brief Implements the logic for saving, loading, and serializing
- * the dynamic web configuration using the Preferences and ArduinoJson libraries.
+ * @brief Implements the record-oriented NVS store for the dynamic web
+ * configuration, and its JSON import/export for the web UI.
+ *
+ * Storage layout:
+ *   "hmi-config"/"gen"   Commit counter; bit 0 selects the active slot.
+ *   "hmi-cfg-a", "-b"    Two complete slots, each holding one NVS blob per record.
+ *
+ * A record is a block of up to RECORD_ITEMS_PER_BLOCK items of one kind
+ * (buttons, LEDs, joystick axes, action bindings), with an 8-byte header:
+ *   u8 kind, u8 version, u8 first item, u8 item count, u32 CRC32 of the items.
+ * Items are encoded field by field, so a struct layout change in
+ * persistence.h does not silently shift the stored data.
+ *
+ * A save brings the inactive slot up to date, writing only the records whose
+ * bytes differ there, and then commits by bumping "gen" (a single atomic NVS
+ * write). A power cut before the commit leaves the previous slot active and
+ * intact.
  */
 
 #include "persistence.h"
 #include <Preferences.h>
 #include <ArduinoJson.h>
+#include <esp_rom_crc.h>
+#include <memory>
+#include <vector>
 
 // --- GLOBAL OBJECTS ---
 WebConfig web_cfg;
@@ -14,36 +32,543 @@ Preferences preferences;
 
 // --- PRIVATE CONSTANTS ---
 const char *PREFERENCES_NAMESPACE = "hmi-config";
-const char *NVS_CONFIG_KEY = "web_config";
+const char *NVS_COMMIT_KEY = "gen";
+const char *NVS_LEGACY_CONFIG_KEY = "web_config"; // Whole-struct blob written by older firmware
+const char *SLOT_NAMESPACES[2] = {"hmi-cfg-a", "hmi-cfg-b"};
+
+// Grouping items keeps the NVS entry count low: one entry per item would use
+// most of the 20 KB NVS partition across two slots.
+#define RECORD_ITEMS_PER_BLOCK 16
+#define RECORD_HEADER_SIZE 8
+
+enum RecordKind : uint8_t
+{
+    RECORD_BUTTONS,
+    RECORD_LEDS,
+    RECORD_JOYSTICK_AXES,
+    RECORD_BINDINGS,
+    RECORD_KIND_COUNT
+};
+
+struct RecordKindInfo
+{
+    const char *key_prefix;
+    uint8_t version; // Bump when the item encoding of this kind changes
+    uint16_t item_count;
+};
+
+static const RecordKindInfo RECORD_KINDS[RECORD_KIND_COUNT] = {
+    /* RECORD_BUTTONS       */ {"btn", 1, MAX_BUTTONS_DEFINED},
+    /* RECORD_LEDS          */ {"led", 2, MAX_LEDS},            // v2: + pattern, brightness
+    /* RECORD_JOYSTICK_AXES */ {"joy", 2, NUM_JOYSTICKS * NUM_JOYSTICK_AXES}, // v2: + curve, calibration
+    /* RECORD_BINDINGS      */ {"bind", 2, MAX_ACTION_BINDINGS}, // v2: + mode, param
+};
+
+// Layout of the whole-struct blob written before the record store, kept
+// only to migrate it once.
+struct LegacyWebConfig
+{
+    ButtonDynamicConfig buttons[MAX_BUTTONS_DEFINED];
+    struct
+    {
+        char name[32];
+        LedBinding binding_type;
+        int bound_button_index;
+        int lcnc_state_bit;
+    } leds[MAX_LEDS];
+    struct
+    {
+        bool is_inverted;
+        float sensitivity;
+        int center_deadzone;
+    } joysticks[NUM_JOYSTICKS][NUM_JOYSTICK_AXES];
+    struct
+    {
+        TriggerType trigger;
+        ActionType action;
+        bool is_active;
+    } bindings[MAX_ACTION_BINDINGS];
+};
+
+static uint32_t commit_generation = 0;
+static bool have_commit = false;
+
+// --- RECORD ENCODING ---
+
+static void put_u8(std::vector<uint8_t> &out, uint8_t v) { out.push_back(v); }
+static void put_i16(std::vector<uint8_t> &out, int v)
+{
+    out.push_back(v & 0xFF);
+    out.push_back((v >> 8) & 0xFF);
+}
+static void put_name(std::vector<uint8_t> &out, const char *name, size_t cap)
+{
+    size_t n = strnlen(name, cap - 1);
+    out.push_back((uint8_t)n);
+    out.insert(out.end(), name, name + n);
+}
+
+// Bounds-checked reader; a short record clears `ok` and yields zeros.
+struct RecordReader
+{
+    RecordReader(const uint8_t *begin, const uint8_t *end) : p(begin), end(end) {}
+
+    const uint8_t *p;
+    const uint8_t *end;
+    bool ok = true;
+
+    uint8_t u8()
+    {
+        if (p >= end)
+        {
+            ok = false;
+            return 0;
+        }
+        return *p++;
+    }
+    int16_t i16()
+    {
+        uint8_t lo = u8();
+        return (int16_t)(lo | (u8() << 8));
+    }
+    float f32()
+    {
+        float v = 0;
+        if (end - p < (ptrdiff_t)sizeof(v))
+        {
+            ok = false;
+            return 0;
+        }
+        memcpy(&v, p, sizeof(v));
+        p += sizeof(v);
+        return v;
+    }
+    void name(char *dst, size_t cap)
+    {
+        uint8_t n = u8();
+        if (!ok || end - p < n || n >= cap)
+        {
+            ok = false;
+            return;
+        }
+        memcpy(dst, p, n);
+        dst[n] = '\0';
+        p += n;
+    }
+};
+
+static void encode_item(RecordKind kind, const WebConfig &cfg, int i, std::vector<uint8_t> &out)
+{
+    switch (kind)
+    {
+    case RECORD_BUTTONS:
+    {
+        const ButtonDynamicConfig &b = cfg.buttons[i];
+        put_name(out, b.name, sizeof(b.name));
+        put_u8(out, b.is_toggle);
+        put_i16(out, b.radio_group_id);
+        break;
+    }
+    case RECORD_LEDS:
+    {
+        const LedDynamicConfig &l = cfg.leds[i];
+        put_name(out, l.name, sizeof(l.name));
+        put_u8(out, (uint8_t)l.binding_type);
+        put_i16(out, l.bound_button_index);
+        put_i16(out, l.lcnc_state_bit);
+        put_u8(out, (uint8_t)l.pattern);
+        put_u8(out, l.brightness_pct);
+        break;
+    }
+    case RECORD_JOYSTICK_AXES:
+    {
+        const JoystickAxisDynamicConfig &a = cfg.joysticks[i / NUM_JOYSTICK_AXES][i % NUM_JOYSTICK_AXES];
+        put_u8(out, a.is_inverted);
+        const uint8_t *f = (const uint8_t *)&a.sensitivity;
+        out.insert(out.end(), f, f + sizeof(a.sensitivity));
+        put_i16(out, a.center_deadzone);
+        put_u8(out, (uint8_t)a.curve);
+        put_u8(out, a.curve_strength);
+        put_u8(out, a.is_calibrated);
+        put_i16(out, a.cal.min);
+        put_i16(out, a.cal.center);
+        put_i16(out, a.cal.max);
+        break;
+    }
+    case RECORD_BINDINGS:
+    {
+        const ActionBinding &b = cfg.bindings[i];
+        put_u8(out, b.is_active);
+        put_u8(out, (uint8_t)b.trigger);
+        put_u8(out, (uint8_t)b.action);
+        put_u8(out, (uint8_t)b.mode);
+        put_u8(out, b.param);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Decodes one item. `version` is the record's stored version; older
+ * versions would be translated here when a kind's encoding changes.
+ */
+static void decode_item(RecordKind kind, uint8_t version, WebConfig &cfg, int i, RecordReader &r)
+{
+    switch (kind)
+    {
+    case RECORD_BUTTONS:
+    {
+        ButtonDynamicConfig &b = cfg.buttons[i];
+        r.name(b.name, sizeof(b.name));
+        b.is_toggle = r.u8();
+        b.radio_group_id = r.i16();
+        break;
+    }
+    case RECORD_LEDS:
+    {
+        LedDynamicConfig &l = cfg.leds[i];
+        r.name(l.name, sizeof(l.name));
+        l.binding_type = (LedBinding)r.u8();
+        l.bound_button_index = r.i16();
+        l.lcnc_state_bit = r.i16();
+        if (version >= 2)
+        {
+            l.pattern = (LedPattern)r.u8();
+            l.brightness_pct = r.u8();
+        }
+        else
+        {
+            l.pattern = LED_PATTERN_STEADY; // v1 LEDs were steady at full brightness
+            l.brightness_pct = 100;
+        }
+        break;
+    }
+    case RECORD_JOYSTICK_AXES:
+    {
+        JoystickAxisDynamicConfig &a = cfg.joysticks[i / NUM_JOYSTICK_AXES][i % NUM_JOYSTICK_AXES];
+        a.is_inverted = r.u8();
+        a.sensitivity = r.f32();
+        a.center_deadzone = r.i16();
+        if (version >= 2)
+        {
+            a.curve = (JoystickCurve)r.u8();
+            a.curve_strength = r.u8();
+            a.is_calibrated = r.u8();
+            a.cal.min = r.i16();
+            a.cal.center = r.i16();
+            a.cal.max = r.i16();
+        }
+        else
+        {
+            a.curve = CURVE_LINEAR; // v1 axes were linear and uncalibrated
+            a.curve_strength = 50;
+            a.is_calibrated = false;
+            a.cal = {0, 2048, 4095};
+        }
+        break;
+    }
+    case RECORD_BINDINGS:
+    {
+        ActionBinding &b = cfg.bindings[i];
+        b.is_active = r.u8();
+        b.trigger = (TriggerType)r.u8();
+        b.action = (ActionType)r.u8();
+        if (version >= 2)
+        {
+            b.mode = (TriggerMode)r.u8();
+            b.param = r.u8();
+        }
+        else
+        {
+            b.mode = TRIGGER_LEVEL; // v1 rules were all level-triggered
+            b.param = 0;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static int block_count(RecordKind kind)
+{
+    return (RECORD_KINDS[kind].item_count + RECORD_ITEMS_PER_BLOCK - 1) / RECORD_ITEMS_PER_BLOCK;
+}
+
+static void record_key(RecordKind kind, int block, char *key, size_t cap)
+{
+    snprintf(key, cap, "%s%d", RECORD_KINDS[kind].key_prefix, block);
+}
+
+static void encode_record(RecordKind kind, int block, const WebConfig &cfg, std::vector<uint8_t> &out)
+{
+    const int first = block * RECORD_ITEMS_PER_BLOCK;
+    const int count = min(RECORD_ITEMS_PER_BLOCK, RECORD_KINDS[kind].item_count - first);
+
+    out.assign(RECORD_HEADER_SIZE, 0);
+    for (int i = first; i < first + count; ++i)
+        encode_item(kind, cfg, i, out);
+
+    const uint32_t crc = esp_rom_crc32_le(0, out.data() + RECORD_HEADER_SIZE, out.size() - RECORD_HEADER_SIZE);
+    out[0] = kind;
+    out[1] = RECORD_KINDS[kind].version;
+    out[2] = first;
+    out[3] = count;
+    memcpy(&out[4], &crc, sizeof(crc));
+}
+
+/**
+ * @brief Validates a stored record and decodes it into `cfg`.
+ * @return false (leaving `cfg` untouched) if the record is damaged, from a
+ * newer firmware, or describes a different block than expected.
+ */
+static bool decode_record(RecordKind kind, int block, const std::vector<uint8_t> &rec, WebConfig &cfg)
+{
+    if (rec.size() < RECORD_HEADER_SIZE)
+        return false;
+
+    const int first = block * RECORD_ITEMS_PER_BLOCK;
+    const int count = min(RECORD_ITEMS_PER_BLOCK, RECORD_KINDS[kind].item_count - first);
+    uint32_t crc;
+    memcpy(&crc, &rec[4], sizeof(crc));
+
+    if (rec[0] != kind || rec[1] > RECORD_KINDS[kind].version || rec[2] != first)
+        return false;
+    if (esp_rom_crc32_le(0, rec.data() + RECORD_HEADER_SIZE, rec.size() - RECORD_HEADER_SIZE) != crc)
+        return false;
+
+    // Decode into a heap copy so a malformed record cannot leave half-applied items.
+    // Items beyond a shorter stored block (the item count grew) keep their defaults.
+    std::unique_ptr<WebConfig> decoded(new WebConfig(cfg));
+    RecordReader r(rec.data() + RECORD_HEADER_SIZE, rec.data() + rec.size());
+    const int stored = min((int)rec[3], count);
+    for (int i = first; i < first + stored; ++i)
+        decode_item(kind, rec[1], *decoded, i, r);
+    if (!r.ok)
+        return false;
+
+    cfg = *decoded;
+    return true;
+}
+
+static bool read_record(Preferences &slot, const char *key, std::vector<uint8_t> &out)
+{
+    size_t len = slot.getBytesLength(key);
+    if (len == 0)
+        return false;
+    out.resize(len);
+    return slot.getBytes(key, out.data(), len) == len;
+}
+
+// --- SLOT HANDLING ---
+
+/**
+ * @brief Loads every record from `slot_index` into `cfg`.
+ * @return The number of records that were missing or invalid.
+ */
+static int load_slot(int slot_index, WebConfig &cfg)
+{
+    Preferences slot;
+    int bad = 0;
+    if (!slot.begin(SLOT_NAMESPACES[slot_index], true))
+        return -1;
+
+    std::vector<uint8_t> rec;
+    char key[16];
+    for (int k = 0; k < RECORD_KIND_COUNT; ++k)
+    {
+        for (int b = 0; b < block_count((RecordKind)k); ++b)
+        {
+            record_key((RecordKind)k, b, key, sizeof(key));
+            if (!read_record(slot, key, rec) || !decode_record((RecordKind)k, b, rec, cfg))
+                bad++;
+        }
+    }
+    slot.end();
+    return bad;
+}
+
+/**
+ * @brief Makes `slot_index` hold `cfg`, rewriting only records that differ.
+ * @return The number of records written, or -1 on an NVS error.
+ */
+static int write_slot(int slot_index, const WebConfig &cfg)
+{
+    Preferences slot;
+    if (!slot.begin(SLOT_NAMESPACES[slot_index], false))
+        return -1;
+
+    int written = 0;
+    std::vector<uint8_t> fresh, stored;
+    char key[16];
+    for (int k = 0; k < RECORD_KIND_COUNT; ++k)
+    {
+        for (int b = 0; b < block_count((RecordKind)k); ++b)
+        {
+            record_key((RecordKind)k, b, key, sizeof(key));
+            encode_record((RecordKind)k, b, cfg, fresh);
+            if (read_record(slot, key, stored) && stored == fresh)
+                continue;
+            if (slot.putBytes(key, fresh.data(), fresh.size()) != fresh.size())
+            {
+                slot.end();
+                return -1;
+            }
+            written++;
+        }
+    }
+    slot.end();
+    return written;
+}
+
+/**
+ * @brief Writes `cfg` to the inactive slot and commits it.
+ * @return true once the new slot is active.
+ */
+static bool commit_configuration(const WebConfig &cfg)
+{
+    const uint32_t next_gen = have_commit ? commit_generation + 1 : 0;
+    const int target = next_gen & 1;
+
+    int written = write_slot(target, cfg);
+    if (written < 0)
+    {
+        if (DEBUG_ENABLED)
+            Serial.println("ERROR: Could not write configuration slot; previous config kept.");
+        return false;
+    }
+
+    preferences.begin(PREFERENCES_NAMESPACE, false);
+    bool ok = preferences.putUInt(NVS_COMMIT_KEY, next_gen) == sizeof(uint32_t);
+    preferences.end();
+    if (!ok)
+        return false;
+
+    commit_generation = next_gen;
+    have_commit = true;
+    if (DEBUG_ENABLED)
+        Serial.printf("Configuration committed to slot %c (%d records written).\n", 'A' + target, written);
+    return true;
+}
+
+/**
+ * @brief Reports whether `cfg` encodes identically to the active slot.
+ */
+static bool matches_active_slot(const WebConfig &cfg)
+{
+    if (!have_commit)
+        return false;
+    std::vector<uint8_t> a, b;
+    for (int k = 0; k < RECORD_KIND_COUNT; ++k)
+    {
+        for (int blk = 0; blk < block_count((RecordKind)k); ++blk)
+        {
+            encode_record((RecordKind)k, blk, cfg, a);
+            encode_record((RecordKind)k, blk, web_cfg, b);
+            if (a != b)
+                return false;
+        }
+    }
+    return true;
+}
 
 // --- FUNCTION IMPLEMENTATIONS ---
 
 /**
- * @brief Loads the configuration from NVS. (No changes needed here)
+ * @brief Loads the configuration from the active NVS slot.
+ *
+ * Damaged records are taken from the other slot (the previous commit) and
+ * otherwise left at their defaults, so one bad record never discards the
+ * rest of the configuration.
  */
 void load_configuration()
 {
+    web_cfg = WebConfig();
+
     preferences.begin(PREFERENCES_NAMESPACE, false);
-    if (preferences.isKey(NVS_CONFIG_KEY))
+    have_commit = preferences.isKey(NVS_COMMIT_KEY);
+    commit_generation = preferences.getUInt(NVS_COMMIT_KEY, 0);
+    bool legacy = !have_commit && preferences.getBytesLength(NVS_LEGACY_CONFIG_KEY) == sizeof(LegacyWebConfig);
+    if (legacy)
     {
-        preferences.getBytes(NVS_CONFIG_KEY, &web_cfg, sizeof(web_cfg));
+        std::unique_ptr<LegacyWebConfig> old(new LegacyWebConfig());
+        preferences.getBytes(NVS_LEGACY_CONFIG_KEY, old.get(), sizeof(LegacyWebConfig));
+        memcpy(web_cfg.buttons, old->buttons, sizeof(web_cfg.buttons));
+        for (int i = 0; i < MAX_LEDS; ++i)
+        {
+            LedDynamicConfig &l = web_cfg.leds[i];
+            memcpy(l.name, old->leds[i].name, sizeof(l.name));
+            l.name[sizeof(l.name) - 1] = '\0';
+            l.binding_type = old->leds[i].binding_type;
+            l.bound_button_index = old->leds[i].bound_button_index;
+            l.lcnc_state_bit = old->leds[i].lcnc_state_bit;
+        }
+        for (int i = 0; i < NUM_JOYSTICKS; ++i)
+        {
+            for (int j = 0; j < NUM_JOYSTICK_AXES; ++j)
+            {
+                web_cfg.joysticks[i][j].is_inverted = old->joysticks[i][j].is_inverted;
+                web_cfg.joysticks[i][j].sensitivity = old->joysticks[i][j].sensitivity;
+                web_cfg.joysticks[i][j].center_deadzone = old->joysticks[i][j].center_deadzone;
+            }
+        }
+        for (int i = 0; i < MAX_ACTION_BINDINGS; ++i)
+        {
+            web_cfg.bindings[i].trigger = old->bindings[i].trigger;
+            web_cfg.bindings[i].action = old->bindings[i].action;
+            web_cfg.bindings[i].is_active = old->bindings[i].is_active;
+        }
+    }
+    preferences.end();
+
+    if (legacy)
+    {
+        // One-time migration from the whole-struct blob of older firmware.
+        if (commit_configuration(web_cfg))
+        {
+            preferences.begin(PREFERENCES_NAMESPACE, false);
+            preferences.remove(NVS_LEGACY_CONFIG_KEY);
+            preferences.end();
+        }
         if (DEBUG_ENABLED)
-            Serial.println("Successfully loaded configuration from NVS.");
+            Serial.println("Migrated legacy configuration to record store.");
+        return;
     }
-    else
+
+    if (!have_commit)
     {
         if (DEBUG_ENABLED)
             Serial.println("No configuration found in NVS. Using default values.");
+        return;
+    }
+
+    const int active = commit_generation & 1;
+    int bad = load_slot(active, web_cfg);
+    if (bad > 0)
+    {
+        // Fill the gaps from the previous commit, then reload the good records on top.
+        std::unique_ptr<WebConfig> merged(new WebConfig());
+        load_slot(active ^ 1, *merged);
+        load_slot(active, *merged);
+        web_cfg = *merged;
+        if (DEBUG_ENABLED)
+            Serial.printf("WARN: %d damaged config record(s) in slot %c; recovered from previous slot.\n",
+                          bad, 'A' + active);
+    }
+    else if (DEBUG_ENABLED)
+    {
+        Serial.printf("Successfully loaded configuration from NVS slot %c.\n", 'A' + active);
     }
-    preferences.end();
 }
 
 /**
- * @brief Saves the configuration received from the web UI to NVS.
+ * @brief Parses the configuration received from the web UI and saves it to NVS.
  */
 void save_configuration(const String &json_string)
 {
-    StaticJsonDocument<4096> doc; // Increased size for new bindings array
+    DynamicJsonDocument doc(json_string.length() * 2 + 1024);
     DeserializationError error = deserializeJson(doc, json_string);
 
     if (error)
@@ -53,85 +578,204 @@ void save_configuration(const String &json_string)
         return;
     }
 
-    // --- Update button settings (no changes here) ---
+    // WebConfig is several KB; keep the working copy off the async task's stack.
+    std::unique_ptr<WebConfig> staged(new WebConfig(web_cfg));
+    WebConfig &next = *staged;
+
+    // --- Buttons ---
     JsonArray buttons = doc["buttons"].as<JsonArray>();
     for (int i = 0; i < buttons.size() && i < MAX_BUTTONS_DEFINED; ++i)
     {
-        // ...
+        JsonObject button = buttons[i];
+        strlcpy(next.buttons[i].name, button["name"] | (const char *)next.buttons[i].name, sizeof(next.buttons[i].name));
+        next.buttons[i].is_toggle = button["is_toggle"] | next.buttons[i].is_toggle;
+        next.buttons[i].radio_group_id = button["radio_group_id"] | next.buttons[i].radio_group_id;
     }
 
-    // --- Update LED settings (no changes here) ---
+    // --- LEDs ---
     JsonArray leds = doc["leds"].as<JsonArray>();
     for (int i = 0; i < leds.size() && i < MAX_LEDS; ++i)
     {
-        // ...
+        JsonObject led = leds[i];
+        strlcpy(next.leds[i].name, led["name"] | (const char *)next.leds[i].name, sizeof(next.leds[i].name));
+        next.leds[i].binding_type = (LedBinding)(led["binding_type"] | (int)next.leds[i].binding_type);
+        next.leds[i].bound_button_index = led["bound_button_index"] | next.leds[i].bound_button_index;
+        next.leds[i].lcnc_state_bit = led["lcnc_state_bit"] | next.leds[i].lcnc_state_bit;
+        next.leds[i].pattern = (LedPattern)(led["pattern"] | (int)next.leds[i].pattern);
+        const int brightness = led["brightness"] | (int)next.leds[i].brightness_pct;
+        next.leds[i].brightness_pct = constrain(brightness, 0, 100); // Stored as uint8_t: 300 would wrap
     }
 
-    // --- Update Joystick settings (no changes here) ---
+    // --- Joysticks ---
     JsonArray joysticks = doc["joysticks"].as<JsonArray>();
     for (int i = 0; i < joysticks.size() && i < NUM_JOYSTICKS; ++i)
     {
-        // ...
+        JsonArray axes = joysticks[i]["axes"].as<JsonArray>();
+        for (int j = 0; j < axes.size() && j < NUM_JOYSTICK_AXES; ++j)
+        {
+            JsonObject axis = axes[j];
+            JoystickAxisDynamicConfig &a = next.joysticks[i][j];
+            a.is_inverted = axis["is_inverted"] | a.is_inverted;
+            a.sensitivity = axis["sensitivity"] | a.sensitivity;
+            a.center_deadzone = axis["center_deadzone"] | a.center_deadzone;
+            a.curve = (JoystickCurve)(axis["curve"] | (int)a.curve);
+            a.curve_strength = axis["curve_strength"] | a.curve_strength;
+            // Calibration normally comes from save_joystick_calibration(); accepted
+            // here too so an exported configuration restores completely.
+            JsonObject cal = axis["calibration"];
+            if (!cal.isNull())
+            {
+                a.is_calibrated = true;
+                a.cal.min = cal["min"] | a.cal.min;
+                a.cal.center = cal["center"] | a.cal.center;
+                a.cal.max = cal["max"] | a.cal.max;
+            }
+        }
     }
 
-    // --- NEW: Update Action Binding settings ---
+    // --- Action Bindings ---
     JsonArray bindings = doc["bindings"].as<JsonArray>();
     for (int i = 0; i < bindings.size() && i < MAX_ACTION_BINDINGS; ++i)
     {
         JsonObject binding = bindings[i];
-        web_cfg.bindings[i].is_active = binding["is_active"] | false;
-        web_cfg.bindings[i].trigger = (TriggerType)(binding["trigger"] | 0);
-        web_cfg.bindings[i].action = (ActionType)(binding["action"] | 0);
+        next.bindings[i].is_active = binding["is_active"] | false;
+        next.bindings[i].trigger = (TriggerType)(binding["trigger"] | 0);
+        next.bindings[i].action = (ActionType)(binding["action"] | 0);
+        next.bindings[i].mode = (TriggerMode)(binding["mode"] | 0);
+        next.bindings[i].param = binding["param"] | 0;
     }
 
-    // --- Save the updated web_cfg struct to NVS (no changes here) ---
-    preferences.begin(PREFERENCES_NAMESPACE, false);
-    preferences.putBytes(NVS_CONFIG_KEY, &web_cfg, sizeof(web_cfg));
-    preferences.end();
+    if (matches_active_slot(next))
+    {
+        if (DEBUG_ENABLED)
+            Serial.println("Configuration unchanged; nothing written.");
+        return;
+    }
 
-    if (DEBUG_ENABLED)
-        Serial.println("Successfully saved new configuration to NVS.");
+    if (commit_configuration(next))
+        web_cfg = next;
 }
 
 /**
- * @brief Serializes the current configuration to a JSON string.
+ * @brief Commits a new calibration for one joystick, leaving all other settings as they are.
  */
-String get_config_as_json()
+bool save_joystick_calibration(int joystick, const AxisCalibration axes[NUM_JOYSTICK_AXES])
+{
+    if (joystick < 0 || joystick >= NUM_JOYSTICKS)
+        return false;
+
+    std::unique_ptr<WebConfig> staged(new WebConfig(web_cfg));
+    for (int j = 0; j < NUM_JOYSTICK_AXES; ++j)
+    {
+        staged->joysticks[joystick][j].is_calibrated = true;
+        staged->joysticks[joystick][j].cal = axes[j];
+    }
+    if (!commit_configuration(*staged))
+        return false;
+    web_cfg = *staged;
+    return true;
+}
+
+/**
+ * @brief Streams the current configuration as one JSON object.
+ */
+void write_config_json(JsonStreamWriter &w)
 {
-    StaticJsonDocument<4096> doc; // Increased size for new bindings array
+    w.begin_object();
 
-    // --- Build buttons array (no changes here) ---
-    JsonArray buttons = doc.createNestedArray("buttons");
+    // --- Buttons ---
+    w.key("buttons");
+    w.begin_array();
     for (int i = 0; i < MAX_BUTTONS_DEFINED; ++i)
     {
-        // ...
+        const ButtonDynamicConfig &b = web_cfg.buttons[i];
+        w.begin_object();
+        w.field("name", b.name);
+        w.field("is_toggle", b.is_toggle);
+        w.field("radio_group_id", b.radio_group_id);
+        w.end_object();
     }
+    w.end_array();
 
-    // --- Build LEDs array (no changes here) ---
-    JsonArray leds = doc.createNestedArray("leds");
+    // --- LEDs ---
+    w.key("leds");
+    w.begin_array();
     for (int i = 0; i < MAX_LEDS; ++i)
     {
-        // ...
+        const LedDynamicConfig &l = web_cfg.leds[i];
+        w.begin_object();
+        w.field("name", l.name);
+        w.field("binding_type", (int)l.binding_type);
+        w.field("bound_button_index", l.bound_button_index);
+        w.field("lcnc_state_bit", l.lcnc_state_bit);
+        w.field("pattern", (int)l.pattern);
+        w.field("brightness", (int)l.brightness_pct);
+        w.end_object();
     }
+    w.end_array();
 
-    // --- Build joysticks array (no changes here) ---
-    JsonArray joysticks = doc.createNestedArray("joysticks");
+    // --- Joysticks ---
+    w.key("joysticks");
+    w.begin_array();
     for (int i = 0; i < NUM_JOYSTICKS; ++i)
     {
-        // ...
+        char name[16];
+        snprintf(name, sizeof(name), "Joystick %d", i + 1);
+        w.begin_object();
+        w.field("name", name);
+        w.key("axes");
+        w.begin_array();
+        for (int j = 0; j < NUM_JOYSTICK_AXES; ++j)
+        {
+            const JoystickAxisDynamicConfig &a = web_cfg.joysticks[i][j];
+            w.begin_object();
+            w.field("is_inverted", a.is_inverted);
+            w.field("sensitivity", a.sensitivity);
+            w.field("center_deadzone", a.center_deadzone);
+            w.field("curve", (int)a.curve);
+            w.field("curve_strength", (int)a.curve_strength);
+            if (a.is_calibrated)
+            {
+                w.key("calibration");
+                w.begin_object();
+                w.field("min", (int)a.cal.min);
+                w.field("center", (int)a.cal.center);
+                w.field("max", (int)a.cal.max);
+                w.end_object();
+            }
+            w.end_object();
+        }
+        w.end_array();
+        w.end_object();
     }
+    w.end_array();
 
-    // --- NEW: Build Action Bindings array ---
-    JsonArray bindings = doc.createNestedArray("bindings");
+    // --- Action Bindings ---
+    w.key("bindings");
+    w.begin_array();
     for (int i = 0; i < MAX_ACTION_BINDINGS; ++i)
     {
-        JsonObject binding = bindings.createNestedObject();
-        binding["is_active"] = web_cfg.bindings[i].is_active;
-        binding["trigger"] = (int)web_cfg.bindings[i].trigger;
-        binding["action"] = (int)web_cfg.bindings[i].action;
+        w.begin_object();
+        w.field("is_active", web_cfg.bindings[i].is_active);
+        w.field("trigger", (int)web_cfg.bindings[i].trigger);
+        w.field("action", (int)web_cfg.bindings[i].action);
+        w.field("mode", (int)web_cfg.bindings[i].mode);
+        w.field("param", web_cfg.bindings[i].param);
+        w.end_object();
     }
+    w.end_array();
 
+    w.end_object();
+}
+
+/**
+ * @brief Serializes the current configuration to a JSON string.
+ */
+String get_config_as_json()
+{
     String json_output;
-    serializeJson(doc, json_output);
+    StringPrint sink(json_output);
+    JsonStreamWriter w(sink);
+    write_config_json(w);
     return json_output;
-}
\ No newline at end of file
+}
@@ -12,6 +12,7 @@
 
 #include <Arduino.h>
 #include "config_esp2.h" // Provides MAX_BUTTONS_DEFINED, MAX_LEDS, etc.
+#include "json_stream.h"
 
 // --- DYNAMIC CONFIGURATION STRUCTURES ---
 
@@ -30,6 +31,26 @@ struct LedDynamicConfig
     LedBinding binding_type = LedBinding::UNBOUND;
     int bound_button_index = -1;
     int lcnc_state_bit = -1;
+    LedPattern pattern = LED_PATTERN_STEADY; // How the LED is shown while lit
+    uint8_t brightness_pct = 100;
+};
+
+// Response curve of a joystick axis beyond the deadzone.
+// Values are stored in NVS and must keep their numbers.
+enum JoystickCurve
+{
+    CURVE_LINEAR,
+    CURVE_EXPO,    // Fine control near the center, full speed at the end
+    CURVE_S_CURVE, // Fine control near the center and a soft approach to full speed
+    CURVE_COUNT
+};
+
+// Raw ADC readings (0-4095) at the ends and the rest position of an axis.
+struct AxisCalibration
+{
+    uint16_t min;
+    uint16_t center;
+    uint16_t max;
 };
 
 // Holds user-configurable settings for a single joystick axis.
@@ -38,6 +59,12 @@ struct JoystickAxisDynamicConfig
     bool is_inverted = false;
     float sensitivity = 1.0f;
     int center_deadzone = 50;
+    JoystickCurve curve = CURVE_LINEAR;
+    uint8_t curve_strength = 50; // 0-100: how far the curve departs from linear
+    // Captured from the web UI. Until then the rest position found at
+    // start-up and the full ADC range are used.
+    bool is_calibrated = false;
+    AxisCalibration cal = {0, 2048, 4095};
 };
 
 // --- NEW: Action Binding Definitions ---
@@ -67,13 +94,35 @@ enum TriggerType
 
 /**
  * @brief Defines all possible actions the HMI can perform based on a trigger.
+ * The meaning of ActionBinding::param depends on the action (see comments).
+ * Existing values must keep their numbers; they are stored in NVS.
  */
 enum ActionType
 {
     NO_ACTION,
     ENABLE_JOYSTICK_1,
     DISABLE_JOYSTICK_1,
-    // Add other actions here, e.g., for enabling/disabling button groups
+    ENABLE_BUTTON_GROUP,  // param: radio group id (1-31)
+    DISABLE_BUTTON_GROUP, // param: radio group id (1-31); presses in the group are ignored
+    LED_ON,               // param: LED index; forces the LED on
+    LED_OFF,              // param: LED index; releases a forced LED
+    LED_BLINK,            // param: LED index
+    LED_STEADY,           // param: LED index; stops blinking
+    SET_JOYSTICK_SCALE,   // param: percent applied on top of each axis' sensitivity
+    ACTION_TYPE_COUNT
+};
+
+/**
+ * @brief How a binding reacts to its trigger bit.
+ * LEVEL applies the action while the bit is set and undoes it when it clears.
+ * RISING/FALLING apply it once on the edge, and it stays in effect until
+ * another edge rule changes the same output.
+ */
+enum TriggerMode
+{
+    TRIGGER_LEVEL,
+    TRIGGER_RISING,
+    TRIGGER_FALLING
 };
 
 /**
@@ -85,6 +134,8 @@ struct ActionBinding
     TriggerType trigger = MACHINE_IS_ON;
     ActionType action = NO_ACTION;
     bool is_active = false; // To enable/disable the rule in the UI
+    TriggerMode mode = TRIGGER_LEVEL;
+    uint8_t param = 0; // Action argument, see ActionType
 };
 
 #define MAX_ACTION_BINDINGS 16 // Allow for up to 16 user-defined rules
@@ -101,23 +152,42 @@ struct WebConfig
     ActionBinding bindings[MAX_ACTION_BINDINGS]; // NEW: Added the array of bindings
 };
 
+// The live configuration, defined in persistence.cpp.
+extern WebConfig web_cfg;
+
 // --- FUNCTION PROTOTYPES ---
 
 /**
- * @brief Loads the configuration from NVS into the global web_cfg object.
+ * @brief Loads the configuration from the active NVS slot into the global web_cfg object.
+ * Damaged records are recovered from the previous slot or left at their defaults.
  */
 void load_configuration();
 
 /**
- * @brief Parses a JSON string and saves the new configuration to NVS.
+ * @brief Parses a JSON string and commits the new configuration to NVS.
+ * Only records that changed are written; web_cfg is updated once the commit succeeds.
  * @param json_string The complete configuration as a JSON string.
  */
 void save_configuration(const String &json_string);
 
+/**
+ * @brief Stores a joystick calibration in web_cfg and commits it to NVS.
+ * @param joystick Index of the joystick.
+ * @param axes Calibration of each of its axes.
+ * @return true if the calibration was committed.
+ */
+bool save_joystick_calibration(int joystick, const AxisCalibration axes[NUM_JOYSTICK_AXES]);
+
 /**
  * @brief Serializes the current configuration into a JSON string.
  * @return String The current configuration as a JSON object.
  */
 String get_config_as_json();
 
+/**
+ * @brief Streams the current configuration as one JSON object into a writer.
+ * Used to send the config to WebSocket clients without an intermediate document.
+ */
+void write_config_json(JsonStreamWriter &w);
+
 #endif // PERSISTENCE_H
\ No newline at end of file
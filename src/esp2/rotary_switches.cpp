@@ -0,0 +1,92 @@
+/**
+ * @file rotary_switches.cpp
+ * @brief Implements the rotary switch read, decoding and stability filter.
+ */
+
+#include "rotary_switches.h"
+#include "mcp_bus.h"
+
+static const uint8_t UNSTABLE = 0xFF;
+
+// --- MODULE STATE ---
+static uint8_t chip_addr = 0;
+static bool present = false;
+static unsigned long last_poll_ms = 0;
+static uint8_t positions[NUM_ROTARY_SWITCHES] = {0};
+static uint8_t candidates[NUM_ROTARY_SWITCHES] = {0};
+static uint8_t candidate_reads[NUM_ROTARY_SWITCHES] = {0};
+
+// --- DECODING ---
+
+/**
+ * @brief Decodes one switch from the inverted input word (bit set = input low).
+ * @return The position, or UNSTABLE if more than one input is low.
+ */
+static uint8_t decode(const RotarySwitchConfig &cfg, uint16_t low_inputs)
+{
+    const uint16_t mask = (1U << (cfg.positions - 1)) - 1;
+    const uint16_t bits = (low_inputs >> cfg.first_input) & mask;
+    if (bits == 0)
+        return 0;
+    if (bits & (bits - 1))
+        return UNSTABLE;
+    return __builtin_ctz(bits) + 1;
+}
+
+// --- PUBLIC API ---
+
+void rotary_switches_init(uint8_t hw_addr)
+{
+    chip_addr = hw_addr;
+    for (int i = 0; i < NUM_ROTARY_SWITCHES; i++)
+    {
+        const RotarySwitchConfig &cfg = rotary_switch_configs[i];
+        if (cfg.positions < 2 || cfg.positions > 8 || cfg.first_input + cfg.positions - 1 > 16)
+        {
+            if (DEBUG_ENABLED)
+                Serial.printf("Rotary switch %d: invalid input range; switches disabled.\n", i);
+            return;
+        }
+    }
+
+    const uint8_t inputs[2] = {0xFF, 0xFF};
+    mcp_bus_write(chip_addr, MCP_IODIRA, inputs, 2);
+    mcp_bus_write(chip_addr, MCP_GPPUA, inputs, 2);
+    present = true;
+}
+
+bool rotary_switches_poll()
+{
+    const unsigned long now = millis();
+    if (!present || now - last_poll_ms < ROTARY_SWITCH_POLL_MS)
+        return false;
+    last_poll_ms = now;
+
+    uint8_t ports[2];
+    mcp_bus_read(chip_addr, MCP_GPIOA, ports, 2);
+    const uint16_t low_inputs = ~(ports[0] | (ports[1] << 8)) & 0xFFFF;
+
+    bool changed = false;
+    for (int i = 0; i < NUM_ROTARY_SWITCHES; i++)
+    {
+        const uint8_t pos = decode(rotary_switch_configs[i], low_inputs);
+        if (pos != candidates[i])
+        {
+            candidates[i] = pos;
+            candidate_reads[i] = 0;
+        }
+        if (candidate_reads[i] < ROTARY_SWITCH_STABLE_READS)
+            candidate_reads[i]++;
+        if (pos != UNSTABLE && pos != positions[i] && candidate_reads[i] >= ROTARY_SWITCH_STABLE_READS)
+        {
+            positions[i] = pos;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+uint8_t rotary_switch_position(int index)
+{
+    return positions[index];
+}
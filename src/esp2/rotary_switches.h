@@ -0,0 +1,37 @@
+/**
+ * @file rotary_switches.h
+ * @brief Position decoding for the multi-position rotary switches (ESP2).
+ *
+ * All switch inputs live on one MCP23S17 and are read together, both
+ * ports in one frame. A switch's position is the index of its low input
+ * plus one, or 0 when none of its inputs is low. A position is only taken
+ * over after ROTARY_SWITCH_STABLE_READS equal reads, which hides the
+ * open gap of a break-before-make switch between two detents. Readings
+ * with several inputs of one switch low are treated as unstable.
+ */
+
+#ifndef ROTARY_SWITCHES_H
+#define ROTARY_SWITCHES_H
+
+#include <Arduino.h>
+#include "config_esp2.h"
+
+/**
+ * @brief Configures all 16 pins of the switch expander as pulled-up inputs.
+ * Call after mcp_bus_init().
+ * @param hw_addr The chip's A2..A0 hardware address.
+ */
+void rotary_switches_init(uint8_t hw_addr);
+
+/**
+ * @brief Reads the switches every ROTARY_SWITCH_POLL_MS; between reads it returns at once.
+ * @return true if a stable position changed.
+ */
+bool rotary_switches_poll();
+
+/**
+ * @brief Current stable position of a switch, 0 .. positions - 1.
+ */
+uint8_t rotary_switch_position(int index);
+
+#endif // ROTARY_SWITCHES_H
@@ -0,0 +1,55 @@
+/**
+ * @file snapshot.h
+ * @brief Single-writer, lock-free snapshot (seqlock) for passing state between tasks (ESP2).
+ *
+ * The writer bumps the sequence to odd, copies the value in and bumps it
+ * back to even. A reader copies the value out and retries if the sequence
+ * was odd or moved meanwhile. The writer never waits, so a slow reader
+ * (the web task) cannot delay the input task. Readers only retry when a
+ * write overlaps their copy, which with small values is rare and short.
+ * A reader must not run at a higher priority than the writer on the
+ * writer's core, or it could spin on a write it has interrupted.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+
+template <typename T>
+class Snapshot
+{
+public:
+    /** @brief Publishes a new value. Only one task may write a given snapshot. */
+    void publish(const T &value)
+    {
+        seq_ = seq_ + 1;
+        __sync_synchronize();
+        value_ = value;
+        __sync_synchronize();
+        seq_ = seq_ + 1;
+    }
+
+    /** @brief Returns the latest complete value. Safe from any task. */
+    T read() const
+    {
+        for (;;)
+        {
+            const uint32_t before = seq_;
+            __sync_synchronize();
+            T copy = value_;
+            __sync_synchronize();
+            if ((before & 1) == 0 && seq_ == before)
+                return copy;
+        }
+    }
+
+    /** @brief Increases with every publish(); readers compare it to skip unchanged data. */
+    uint32_t version() const { return seq_ >> 1; }
+
+private:
+    volatile uint32_t seq_ = 0;
+    T value_ = T();
+};
+
+#endif // SNAPSHOT_H
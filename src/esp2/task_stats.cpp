@@ -0,0 +1,88 @@
+/**
+ * @file task_stats.cpp
+ * @brief Implements the busy-time counters and the load report.
+ */
+
+#include "task_stats.h"
+#include <esp_timer.h>
+
+// --- INTERNAL DATA STRUCTURES ---
+
+// Counters are 32-bit so a reader on the other core never sees half an
+// update; busy_us wraps after ~71 minutes, which the window deltas absorb.
+struct TaskCounters
+{
+    const char *name;
+    TaskHandle_t handle;
+    volatile uint32_t busy_us; // Written by the task itself only
+    volatile uint32_t passes;
+    volatile uint32_t max_us;  // Longest pass in the current window; reset by the report
+    uint32_t reported_busy_us; // Values at the previous report
+    uint32_t reported_passes;
+};
+
+// --- MODULE STATE ---
+static TaskCounters counters[PANEL_TASK_COUNT];
+static uint32_t window_start_us = 0;
+
+// --- PUBLIC API ---
+
+void task_stats_register(PanelTask task, const char *name, TaskHandle_t handle)
+{
+    counters[task].name = name;
+    counters[task].handle = handle;
+}
+
+uint32_t task_stats_begin()
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+void task_stats_end(PanelTask task, uint32_t start_us)
+{
+    task_stats_add(task, (uint32_t)esp_timer_get_time() - start_us);
+}
+
+void task_stats_add(PanelTask task, uint32_t busy_us)
+{
+    TaskCounters &c = counters[task];
+    c.busy_us = c.busy_us + busy_us;
+    c.passes = c.passes + 1;
+    if (busy_us > c.max_us)
+        c.max_us = busy_us;
+}
+
+void task_stats_write_report(JsonStreamWriter &w)
+{
+    const uint32_t now_us = (uint32_t)esp_timer_get_time();
+    const uint32_t window_us = max<uint32_t>(1, now_us - window_start_us);
+    window_start_us = now_us;
+
+    w.begin_object();
+    w.field("window_ms", (unsigned long)(window_us / 1000));
+    w.key("tasks");
+    w.begin_array();
+    for (int i = 0; i < PANEL_TASK_COUNT; i++)
+    {
+        TaskCounters &c = counters[i];
+        if (!c.name)
+            continue;
+        const uint32_t busy = c.busy_us;
+        const uint32_t passes = c.passes;
+        const uint32_t max_us = c.max_us;
+        c.max_us = 0;
+
+        w.begin_object();
+        w.field("name", c.name);
+        w.field("cpu_pct", 100.0 * (busy - c.reported_busy_us) / window_us);
+        w.field("passes", (unsigned long)(passes - c.reported_passes));
+        w.field("max_us", (unsigned long)max_us);
+        w.field("stack_free", c.handle ? (unsigned long)uxTaskGetStackHighWaterMark(c.handle) : 0UL);
+        w.end_object();
+
+        c.reported_busy_us = busy;
+        c.reported_passes = passes;
+    }
+    w.end_array();
+    w.end_object();
+}
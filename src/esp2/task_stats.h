@@ -0,0 +1,57 @@
+/**
+ * @file task_stats.h
+ * @brief Per-task CPU accounting for the panel tasks (ESP2).
+ *
+ * Each task brackets one pass of its work with task_stats_begin() and
+ * task_stats_end(), or sums up a pass made of several pieces and hands
+ * it to task_stats_add(). Busy time is counted in microseconds from
+ * esp_timer, so this works without FreeRTOS run-time stats in the SDK
+ * config. A report turns the busy time since the previous report into a
+ * share of one core, and adds the pass count, the longest pass and the
+ * stack headroom.
+ */
+
+#ifndef TASK_STATS_H
+#define TASK_STATS_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "json_stream.h"
+
+enum PanelTask
+{
+    PANEL_TASK_INPUT,
+    PANEL_TASK_LED,
+    PANEL_TASK_COMMS,
+    PANEL_TASK_WEB,
+    PANEL_TASK_COUNT
+};
+
+/**
+ * @brief Names a task slot and records its handle for the stack report.
+ */
+void task_stats_register(PanelTask task, const char *name, TaskHandle_t handle);
+
+/**
+ * @brief Current time in microseconds, to hand to task_stats_end().
+ */
+uint32_t task_stats_begin();
+
+/**
+ * @brief Records one pass that started at @p start_us. Only the task itself may call this.
+ */
+void task_stats_end(PanelTask task, uint32_t start_us);
+
+/**
+ * @brief Records one pass of @p busy_us. Only the task itself may call this.
+ */
+void task_stats_add(PanelTask task, uint32_t busy_us);
+
+/**
+ * @brief Streams the load since the previous report as
+ * {window_ms, tasks:[{name, cpu_pct, passes, max_us, stack_free}]} and starts a new window.
+ */
+void task_stats_write_report(JsonStreamWriter &w);
+
+#endif // TASK_STATS_H
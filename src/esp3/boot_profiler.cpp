@@ -0,0 +1,87 @@
+/**
+ * @file boot_profiler.cpp
+ * @brief Implements the boot stage timer using the microsecond esp_timer clock.
+ */
+
+#include "boot_profiler.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+// --- Constants ---
+static constexpr int MAX_BOOT_STAGES = 16;
+
+// --- Module-static (private) variables ---
+struct BootStage
+{
+    const char *name;
+    int64_t start_us;
+    int64_t end_us; // -1 while the stage is still running
+};
+
+static BootStage stages[MAX_BOOT_STAGES];
+static int stage_count = 0;
+static portMUX_TYPE stage_lock = portMUX_INITIALIZER_UNLOCKED;
+
+//================================================================================
+// PUBLIC API FUNCTIONS
+//================================================================================
+
+int boot_profiler_begin(const char *name)
+{
+    int64_t now = esp_timer_get_time();
+    int idx = -1;
+
+    portENTER_CRITICAL(&stage_lock);
+    if (stage_count < MAX_BOOT_STAGES)
+    {
+        idx = stage_count++;
+        stages[idx] = {name, now, -1};
+    }
+    portEXIT_CRITICAL(&stage_lock);
+    return idx;
+}
+
+void boot_profiler_end(int stage)
+{
+    if (stage < 0 || stage >= MAX_BOOT_STAGES)
+        return;
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&stage_lock);
+    stages[stage].end_us = now;
+    portEXIT_CRITICAL(&stage_lock);
+}
+
+void boot_profiler_milestone(const char *name)
+{
+    boot_profiler_end(boot_profiler_begin(name));
+}
+
+void boot_profiler_report()
+{
+    BootStage snapshot[MAX_BOOT_STAGES];
+    int count;
+
+    portENTER_CRITICAL(&stage_lock);
+    count = stage_count;
+    memcpy(snapshot, stages, sizeof(BootStage) * count);
+    portEXIT_CRITICAL(&stage_lock);
+
+    Serial.println("--- Boot profile (ms since app start) ---");
+    Serial.println("  start  duration  stage");
+    for (int i = 0; i < count; ++i)
+    {
+        const BootStage &s = snapshot[i];
+        if (s.end_us < 0)
+        {
+            Serial.printf("%7.1f   running  %s\n", s.start_us / 1000.0, s.name);
+        }
+        else
+        {
+            Serial.printf("%7.1f  %8.1f  %s\n", s.start_us / 1000.0,
+                          (s.end_us - s.start_us) / 1000.0, s.name);
+        }
+    }
+    Serial.println("-----------------------------------------");
+}
@@ -0,0 +1,39 @@
+/**
+ * @file boot_profiler.h
+ * @brief Lightweight stage timer for the pendant's staged boot sequence.
+ *
+ * Each boot stage is bracketed by boot_profiler_begin()/boot_profiler_end().
+ * Stages may overlap (the network stage runs in the background while the UI
+ * is already live), so every stage records its own start and end time.
+ */
+
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Marks the start of a boot stage.
+ * @param name A string literal naming the stage (the pointer is stored, not copied).
+ * @return A stage handle for boot_profiler_end(), or -1 if the table is full.
+ */
+int boot_profiler_begin(const char *name);
+
+/**
+ * @brief Marks the end of a boot stage started with boot_profiler_begin().
+ * @param stage The handle returned by boot_profiler_begin().
+ */
+void boot_profiler_end(int stage);
+
+/**
+ * @brief Records a single point in time (e.g. "first frame") as a zero-length stage.
+ * @param name A string literal naming the milestone.
+ */
+void boot_profiler_milestone(const char *name);
+
+/**
+ * @brief Prints all recorded stages with their start offset and duration to Serial.
+ */
+void boot_profiler_report();
+
+#endif // BOOT_PROFILER_H
@@ -0,0 +1,311 @@
+/**
+ * @file config_blob_esp3.cpp
+ * @brief Implements the binary PendantWebConfig codec, its CRC and schema migrations.
+ */
+
+#include "config_blob_esp3.h"
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_rom_crc.h>
+#endif
+
+// --- Little-endian writer ---
+namespace
+{
+    struct BlobWriter
+    {
+        std::vector<uint8_t> &out;
+
+        void u8(uint8_t v) { out.push_back(v); }
+        void u16(uint16_t v)
+        {
+            out.push_back(v & 0xFF);
+            out.push_back(v >> 8);
+        }
+        void u32(uint32_t v)
+        {
+            for (int i = 0; i < 4; ++i)
+                out.push_back((v >> (8 * i)) & 0xFF);
+        }
+        void str(const std::string &s)
+        {
+            size_t n = s.size() > 0xFFFF ? 0xFFFF : s.size();
+            u16((uint16_t)n);
+            out.insert(out.end(), s.begin(), s.begin() + n);
+        }
+        void count(size_t n) { u16(n > 0xFFFF ? 0xFFFF : (uint16_t)n); }
+    };
+
+    // --- Bounds-checked little-endian reader ---
+    // Any read past the end clears `ok` and yields zeros; callers check once at the end.
+    struct BlobReader
+    {
+        const uint8_t *p;
+        const uint8_t *end;
+        bool ok = true;
+
+        bool need(size_t n)
+        {
+            if (!ok || (size_t)(end - p) < n)
+            {
+                ok = false;
+                return false;
+            }
+            return true;
+        }
+        uint8_t u8()
+        {
+            return need(1) ? *p++ : 0;
+        }
+        uint16_t u16()
+        {
+            if (!need(2))
+                return 0;
+            uint16_t v = p[0] | (p[1] << 8);
+            p += 2;
+            return v;
+        }
+        uint32_t u32()
+        {
+            if (!need(4))
+                return 0;
+            uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+            p += 4;
+            return v;
+        }
+        // Element count, rejected if even the smallest elements could not fit.
+        uint16_t count(size_t min_element_size)
+        {
+            uint16_t n = u16();
+            if (ok && (size_t)(end - p) < n * min_element_size)
+                ok = false;
+            return ok ? n : 0;
+        }
+        void str(std::string &s)
+        {
+            uint16_t n = u16();
+            if (!need(n))
+                return;
+            s.assign((const char *)p, n);
+            p += n;
+        }
+    };
+}
+
+// --- Schema v1 payload ---
+
+static void encode_payload(const PendantWebConfig &cfg, BlobWriter &w)
+{
+    w.u8(cfg.num_dro_axes);
+    w.u8(cfg.handwheel_enable_button);
+
+    w.count(cfg.axis_labels.size());
+    for (auto &s : cfg.axis_labels)
+        w.str(s);
+
+    w.count(cfg.button_bindings.size());
+    for (auto &b : cfg.button_bindings)
+    {
+        w.u8(b.button_index);
+        w.str(b.action_name);
+        w.u8((uint8_t)b.type);
+        w.u16(b.lcnc_action_code);
+    }
+
+    w.count(cfg.led_bindings.size());
+    for (auto &l : cfg.led_bindings)
+    {
+        w.u8(l.led_index);
+        w.str(l.signal_name);
+        w.u8((uint8_t)l.type);
+        w.u8(l.matrix_index);
+        w.u8(l.bit_index);
+        w.u8(l.button_index);
+    }
+
+    w.count(cfg.macros.size());
+    for (auto &m : cfg.macros)
+    {
+        w.str(m.name);
+        w.u16(m.action_code);
+        w.count(m.commands.size());
+        for (auto &c : m.commands)
+            w.str(c);
+    }
+}
+
+static bool decode_payload(BlobReader &r, PendantWebConfig &cfg)
+{
+    cfg.num_dro_axes = r.u8();
+    cfg.handwheel_enable_button = r.u8();
+
+    cfg.axis_labels.assign(r.count(2), std::string());
+    for (auto &s : cfg.axis_labels)
+        r.str(s);
+
+    cfg.button_bindings.assign(r.count(6), ButtonBinding());
+    for (auto &b : cfg.button_bindings)
+    {
+        b.button_index = r.u8();
+        r.str(b.action_name);
+        b.type = (BindingType)r.u8();
+        b.lcnc_action_code = r.u16();
+    }
+
+    cfg.led_bindings.assign(r.count(7), LedBinding()); // u8 + empty string (u16) + 4 x u8
+    for (auto &l : cfg.led_bindings)
+    {
+        l.led_index = r.u8();
+        r.str(l.signal_name);
+        l.type = (LedBindingType)r.u8();
+        l.matrix_index = r.u8();
+        l.bit_index = r.u8();
+        l.button_index = r.u8();
+    }
+
+    cfg.macros.assign(r.count(6), MacroEntry());
+    for (auto &m : cfg.macros)
+    {
+        r.str(m.name);
+        m.action_code = r.u16();
+        m.commands.assign(r.count(2), std::string());
+        for (auto &c : m.commands)
+            r.str(c);
+    }
+
+    return r.ok && r.p == r.end;
+}
+
+// --- Migrations ---
+
+/**
+ * @brief Upgrades a payload one schema version at a time until it is current.
+ *
+ * Each case rewrites `payload` from version N to N+1 and falls through to
+ * the next. To change the layout: bump CONFIG_BLOB_SCHEMA, update
+ * encode_payload()/decode_payload() to the new layout, and add a case here
+ * for the previous version.
+ */
+static bool migrate_payload(uint16_t from, std::vector<uint8_t> &payload)
+{
+    (void)payload;
+    switch (from)
+    {
+    case CONFIG_BLOB_SCHEMA:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// --- Public API ---
+
+uint32_t config_blob_crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+#if defined(ESP_PLATFORM)
+    return esp_rom_crc32_le(crc, data, len);
+#else
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *data++;
+        for (int i = 0; i < 8; ++i)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+#endif
+}
+
+void config_blob_encode(const PendantWebConfig &cfg, std::vector<uint8_t> &out)
+{
+    out.clear();
+    out.reserve(256);
+    out.resize(CONFIG_BLOB_HEADER_SIZE);
+
+    BlobWriter w{out};
+    encode_payload(cfg, w);
+
+    const uint32_t payload_len = out.size() - CONFIG_BLOB_HEADER_SIZE;
+    const uint32_t crc = config_blob_crc32(0, out.data() + CONFIG_BLOB_HEADER_SIZE, payload_len);
+
+    std::vector<uint8_t> header;
+    BlobWriter h{header};
+    h.u32(CONFIG_BLOB_MAGIC);
+    h.u16(CONFIG_BLOB_SCHEMA);
+    h.u16(CONFIG_BLOB_HEADER_SIZE);
+    h.u32(payload_len);
+    h.u32(crc);
+    memcpy(out.data(), header.data(), CONFIG_BLOB_HEADER_SIZE);
+}
+
+ConfigBlobStatus config_blob_decode(const uint8_t *data, size_t len, PendantWebConfig &cfg,
+                                    uint16_t *schema_out)
+{
+    BlobReader hr{data, data + len};
+    const uint32_t magic = hr.u32();
+    const uint16_t schema = hr.u16();
+    const uint16_t header_size = hr.u16();
+    const uint32_t payload_len = hr.u32();
+    const uint32_t crc = hr.u32();
+
+    if (!hr.ok)
+        return ConfigBlobStatus::TOO_SHORT;
+    if (magic != CONFIG_BLOB_MAGIC)
+        return ConfigBlobStatus::BAD_MAGIC;
+    if (schema_out)
+        *schema_out = schema;
+    if (header_size < CONFIG_BLOB_HEADER_SIZE || len < (size_t)header_size + payload_len)
+        return ConfigBlobStatus::TOO_SHORT;
+    if (schema > CONFIG_BLOB_SCHEMA)
+        return ConfigBlobStatus::TOO_NEW;
+
+    const uint8_t *payload = data + header_size;
+    if (config_blob_crc32(0, payload, payload_len) != crc)
+        return ConfigBlobStatus::BAD_CRC;
+
+    // Current blobs decode in place; only old ones pay for a copy.
+    std::vector<uint8_t> migrated;
+    if (schema < CONFIG_BLOB_SCHEMA)
+    {
+        migrated.assign(payload, payload + payload_len);
+        if (!migrate_payload(schema, migrated))
+            return ConfigBlobStatus::MIGRATION_FAILED;
+        payload = migrated.data();
+        len = migrated.size();
+    }
+    else
+    {
+        len = payload_len;
+    }
+
+    PendantWebConfig decoded;
+    BlobReader r{payload, payload + len};
+    if (!decode_payload(r, decoded))
+        return ConfigBlobStatus::MALFORMED;
+
+    cfg = std::move(decoded);
+    return ConfigBlobStatus::OK;
+}
+
+const char *config_blob_status_name(ConfigBlobStatus status)
+{
+    switch (status)
+    {
+    case ConfigBlobStatus::OK:
+        return "ok";
+    case ConfigBlobStatus::TOO_SHORT:
+        return "truncated";
+    case ConfigBlobStatus::BAD_MAGIC:
+        return "bad magic";
+    case ConfigBlobStatus::BAD_CRC:
+        return "CRC mismatch";
+    case ConfigBlobStatus::TOO_NEW:
+        return "schema too new";
+    case ConfigBlobStatus::MIGRATION_FAILED:
+        return "migration failed";
+    case ConfigBlobStatus::MALFORMED:
+        return "malformed payload";
+    }
+    return "unknown";
+}
@@ -0,0 +1,73 @@
+/**
+ * @file config_blob_esp3.h
+ * @brief Compact binary encoding of PendantWebConfig for NVS storage.
+ *
+ * The blob is a fixed header followed by a length-prefixed payload:
+ *
+ *   offset  size  field
+ *   0       4     magic 'PCFG'
+ *   4       2     schema version of the payload
+ *   6       2     header size (lets later headers grow without breaking old readers)
+ *   8       4     payload length in bytes
+ *   12      4     CRC32 of the payload
+ *
+ * All integers are little-endian. Strings are a u16 length plus raw bytes.
+ * Decoding is a single bounds-checked pass, with no tokenizing and no
+ * intermediate document. Payloads from older schema versions are migrated
+ * forward before decoding. Payloads from a newer firmware are rejected, so a
+ * downgrade falls back to defaults instead of misreading the data.
+ *
+ * The module has no Arduino dependencies.
+ */
+
+#ifndef CONFIG_BLOB_ESP3_H
+#define CONFIG_BLOB_ESP3_H
+
+#include "shared_structures.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+static constexpr uint32_t CONFIG_BLOB_MAGIC = 0x47464350; // "PCFG" little-endian
+static constexpr uint16_t CONFIG_BLOB_SCHEMA = 1;
+static constexpr uint16_t CONFIG_BLOB_HEADER_SIZE = 16;
+
+enum class ConfigBlobStatus : uint8_t
+{
+    OK,
+    TOO_SHORT,    // Fewer bytes than the header claims
+    BAD_MAGIC,    // Not a config blob at all
+    BAD_CRC,      // Payload corrupted (e.g. interrupted write)
+    TOO_NEW,      // Written by a newer firmware
+    MIGRATION_FAILED,
+    MALFORMED     // CRC fine but the payload does not decode
+};
+
+/**
+ * @brief Encodes a configuration into a complete blob (header + payload).
+ * @param cfg The configuration to encode.
+ * @param out Replaced with the encoded bytes.
+ */
+void config_blob_encode(const PendantWebConfig &cfg, std::vector<uint8_t> &out);
+
+/**
+ * @brief Validates, migrates and decodes a blob.
+ * @param data Blob bytes as read from NVS.
+ * @param len Number of bytes in @p data.
+ * @param cfg Receives the configuration; left untouched unless OK is returned.
+ * @param schema_out Optional; receives the schema version found in the header.
+ */
+ConfigBlobStatus config_blob_decode(const uint8_t *data, size_t len, PendantWebConfig &cfg,
+                                    uint16_t *schema_out = nullptr);
+
+/**
+ * @brief Returns a short human-readable name for a status code.
+ */
+const char *config_blob_status_name(ConfigBlobStatus status);
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected). Chain calls by passing the previous result.
+ */
+uint32_t config_blob_crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+#endif // CONFIG_BLOB_ESP3_H
@@ -9,7 +9,9 @@
 #define PENDANT_HAS_FEED_OVERRIDE_ENCODER 1
 #define PENDANT_HAS_RAPID_OVERRIDE_ENCODER 0   // set to 0 if BUTTON_MATRIX > 2x2
 #define PENDANT_HAS_SPINDLE_OVERRIDE_ENCODER 0 //
-#define PENDANT_HAS_HANDWEEL_ENCODER 1
+#define PENDANT_HAS_HANDWHEEL_ENCODER 1
+#define PENDANT_TOUCH_USE_IRQ 1 // 0 = poll the touch controller on every LVGL indev read
+#define PERSISTENCE_BENCHMARK 0 // 1 = time binary vs. JSON config decoding at boot and print the result
 
 namespace Pinout
 {
@@ -32,6 +34,10 @@ namespace Pinout
         constexpr uint8_t PENDANT_COL_PINS[] = {3, 21};  // 2 columns (avoiding GPIO4/5 conflicts)
         constexpr size_t PENDANT_MATRIX_ROWS = sizeof(PENDANT_ROW_PINS) / sizeof(PENDANT_ROW_PINS[0]);
         constexpr size_t PENDANT_MATRIX_COLS = sizeof(PENDANT_COL_PINS) / sizeof(PENDANT_COL_PINS[0]);
+
+        // Matrix scan cadence: one row per tick, columns settle for a full tick
+        constexpr uint32_t MATRIX_SCAN_TICK_US = 250;
+        constexpr uint32_t MATRIX_DEBOUNCE_US = 10000; // Level must hold this long to register
 #endif
 
         // Status LEDs - disabled
@@ -59,6 +65,12 @@ namespace Pinout
 #endif
 }
 
+namespace WebConfig
+{
+        // Live-status WebSocket frames are coalesced to this rate
+        constexpr uint32_t LIVE_STATUS_RATE_HZ = 10;
+}
+
 namespace DisplayConfig
 {
         // LCD SPI (VSPI) - no conflicts now
@@ -74,6 +86,10 @@ namespace DisplayConfig
         constexpr uint8_t PIN_TOUCH_SDA = 8;
         constexpr uint8_t PIN_TOUCH_SCL = 9;
         constexpr uint8_t PIN_TOUCH_INT = 6;
+
+        // Touch sampling (interrupt-driven path)
+        constexpr uint32_t TOUCH_SAMPLE_PERIOD_MS = 10; // Re-read cadence while a finger is down
+        constexpr size_t TOUCH_BUFFER_DEPTH = 16;       // Buffered samples between reader task and LVGL
 }
 
 /*
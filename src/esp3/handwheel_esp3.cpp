@@ -0,0 +1,159 @@
+/**
+ * @file handwheel_esp3.cpp
+ * @brief Implements the handwheel velocity estimator and acceleration curve.
+ */
+
+#include "handwheel_esp3.h"
+#include <math.h>
+
+// --- Constants ---
+static constexpr int HISTORY_SIZE = 16;                // Timestamped samples kept for velocity
+static constexpr int64_t VELOCITY_WINDOW_US = 100000;  // Look-back window for the estimate
+static constexpr int64_t IDLE_RESET_US = 250000;       // Wheel at rest: drop velocity to zero
+static constexpr float VELOCITY_SMOOTHING = 0.5f;      // EMA weight of the newest estimate
+
+// --- Module-static (private) variables ---
+struct CountSample
+{
+    int64_t t_us;
+    int32_t count;
+};
+
+static CountSample history[HISTORY_SIZE];
+static int history_head = 0;
+static int history_len = 0;
+
+static int32_t last_raw = 0;
+static int32_t pending_counts = 0; // Raw counts not yet forming a whole detent
+static float scaled_residual = 0;  // Fractional jog counts carried between calls
+static float velocity = 0;         // Detents per second, signed
+static float last_multiplier = 1.0f;
+static int64_t last_motion_us = 0;
+static int last_direction = 0;
+
+// --- Internal helpers ---
+
+static void push_sample(int64_t t_us, int32_t count)
+{
+    history[history_head] = {t_us, count};
+    history_head = (history_head + 1) % HISTORY_SIZE;
+    if (history_len < HISTORY_SIZE)
+        history_len++;
+}
+
+/**
+ * @brief Estimates velocity from the oldest sample still inside the window.
+ */
+static float estimate_velocity(int64_t now_us, int32_t count, uint8_t counts_per_detent)
+{
+    const CountSample *oldest = nullptr;
+    for (int i = 1; i <= history_len; ++i)
+    {
+        const CountSample &s = history[(history_head - i + HISTORY_SIZE) % HISTORY_SIZE];
+        if (now_us - s.t_us > VELOCITY_WINDOW_US)
+            break;
+        oldest = &s;
+    }
+    if (!oldest || oldest->t_us == now_us)
+        return 0;
+
+    float detents = (float)(count - oldest->count) / (counts_per_detent ? counts_per_detent : 1);
+    return detents * 1e6f / (float)(now_us - oldest->t_us);
+}
+
+static float curve_multiplier(float speed, uint8_t axis, const HandwheelConfig &cfg)
+{
+    if (!cfg.accel_enabled || speed <= cfg.velocity_low || cfg.velocity_high <= cfg.velocity_low)
+        return 1.0f;
+
+    float x = (speed - cfg.velocity_low) / (cfg.velocity_high - cfg.velocity_low);
+    if (x > 1.0f)
+        x = 1.0f;
+
+    float limit = cfg.max_multiplier;
+    if (axis < HANDWHEEL_MAX_AXES && cfg.axis_max_multiplier[axis] < limit)
+        limit = cfg.axis_max_multiplier[axis];
+    if (limit < 1.0f)
+        limit = 1.0f;
+
+    // A stored config that slipped past validation must not turn into a runaway jog.
+    float m = 1.0f + (limit - 1.0f) * powf(x, cfg.curve_exponent);
+    if (!(m >= 1.0f)) // Also catches NaN
+        return 1.0f;
+    return m < limit ? m : limit;
+}
+
+//================================================================================
+// PUBLIC API FUNCTIONS
+//================================================================================
+
+void handwheel_engine_reset(int32_t raw_count)
+{
+    last_raw = raw_count;
+    pending_counts = 0;
+    scaled_residual = 0;
+    velocity = 0;
+    last_multiplier = 1.0f;
+    last_direction = 0;
+    history_len = 0;
+}
+
+int32_t handwheel_engine_process(int32_t raw_count, int64_t now_us, uint8_t axis, const HandwheelConfig &cfg)
+{
+    int32_t delta = raw_count - last_raw;
+    last_raw = raw_count;
+
+    if (delta == 0)
+    {
+        if (now_us - last_motion_us > IDLE_RESET_US)
+        {
+            velocity = 0;
+            history_len = 0;
+        }
+        return 0;
+    }
+    last_motion_us = now_us;
+
+    // A reversal is a positioning move: forget the old speed and any residual.
+    int direction = delta > 0 ? 1 : -1;
+    if (direction != last_direction)
+    {
+        velocity = 0;
+        history_len = 0;
+        scaled_residual = 0;
+        last_direction = direction;
+    }
+
+    push_sample(now_us, raw_count);
+    float v = estimate_velocity(now_us, raw_count, cfg.counts_per_detent);
+    velocity = VELOCITY_SMOOTHING * v + (1.0f - VELOCITY_SMOOTHING) * velocity;
+
+    // Detent filter: release raw counts only in whole detents. Output stays in
+    // raw-count units either way so the HAL scale does not depend on the filter.
+    int32_t counts = delta;
+    if (cfg.detent_filter && cfg.counts_per_detent > 1)
+    {
+        pending_counts += delta;
+        int32_t detents = pending_counts / cfg.counts_per_detent;
+        counts = detents * cfg.counts_per_detent;
+        pending_counts -= counts;
+        if (counts == 0)
+            return 0;
+    }
+
+    last_multiplier = curve_multiplier(fabsf(velocity), axis, cfg);
+    float scaled = counts * last_multiplier + scaled_residual;
+    int32_t out = (int32_t)scaled;
+    scaled_residual = scaled - out;
+    return out;
+}
+
+float handwheel_engine_velocity()
+{
+    return velocity;
+}
+
+float handwheel_engine_multiplier()
+{
+    return last_multiplier;
+}
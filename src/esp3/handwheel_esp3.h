@@ -0,0 +1,58 @@
+/**
+ * @file handwheel_esp3.h
+ * @brief Handwheel processing engine: velocity estimation, acceleration curve and detent filtering.
+ *
+ * The engine turns raw quadrature counts into jog counts. Slow turns pass
+ * through 1:1 for fine positioning; fast spins are multiplied along a
+ * configurable curve so long travels need no step-selector change.
+ */
+
+#ifndef HANDWHEEL_ESP3_H
+#define HANDWHEEL_ESP3_H
+
+#include <stdint.h>
+
+static constexpr uint8_t HANDWHEEL_MAX_AXES = 6;
+
+/**
+ * @brief User-tunable handwheel parameters, persisted by persistence_esp3.
+ */
+struct HandwheelConfig
+{
+    bool accel_enabled = true;
+    float velocity_low = 8.0f;   // Detents/s at or below which motion is 1:1
+    float velocity_high = 60.0f; // Detents/s at which the full multiplier applies
+    float max_multiplier = 10.0f;
+    float curve_exponent = 2.0f; // 1 = linear ramp, >1 = gentle start, <1 = aggressive start
+    uint8_t counts_per_detent = 4;
+    bool detent_filter = true; // Only emit whole detents; hides jitter on a resting wheel
+    float axis_max_multiplier[HANDWHEEL_MAX_AXES] = {10.0f, 10.0f, 5.0f, 5.0f, 5.0f, 5.0f};
+};
+
+/**
+ * @brief Resets the engine state to a new raw count (e.g. after encoder init).
+ * @param raw_count The current raw encoder count.
+ */
+void handwheel_engine_reset(int32_t raw_count);
+
+/**
+ * @brief Feeds the latest raw encoder count into the engine.
+ * @param raw_count Absolute raw count from the encoder.
+ * @param now_us Timestamp of the sample in microseconds.
+ * @param axis The currently selected axis (selects the per-axis limit).
+ * @param cfg The active configuration.
+ * @return The number of jog counts to add to the handwheel position.
+ */
+int32_t handwheel_engine_process(int32_t raw_count, int64_t now_us, uint8_t axis, const HandwheelConfig &cfg);
+
+/**
+ * @brief Returns the last velocity estimate in detents per second (signed).
+ */
+float handwheel_engine_velocity();
+
+/**
+ * @brief Returns the multiplier applied to the last emitted detents.
+ */
+float handwheel_engine_multiplier();
+
+#endif // HANDWHEEL_ESP3_H
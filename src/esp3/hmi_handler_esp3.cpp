@@ -8,9 +8,16 @@
 using namespace Pinout;
 
 #include "persistence_esp3.h"
+#include "handwheel_esp3.h"
+#include "input_bus_esp3.h"
+#include "matrix_scan_esp3.h"
+#include "override_esp3.h"
+#include "selector_esp3.h"
 #include "ui.h"
+#include "ui_popups.h"
 #include <Arduino.h>
 #include <ESP32Encoder.h>
+#include <esp_timer.h>
 
 // -----------------------------------------------------------------------------
 // Encoder instances must live in global scope to avoid PCNT/FreeRTOS before-init
@@ -21,44 +28,18 @@ static ESP32Encoder spindleEnc;
 
 // -----------------------------------------------------------------------------
 
-// --- Constants ---
-static constexpr unsigned long KEY_DEBOUNCE_MS = 50;
-
-// --- Internal State Enums and Structs ---
-enum class KeyState
-{
-    IDLE,
-    PRESSED,
-    HELD,
-    RELEASED
-};
-
-struct KeyInfo
-{
-    KeyState state = KeyState::IDLE;
-    bool last_raw = false;
-    unsigned long last_change_ms = 0;
-};
-
 // --- Module-static (private) variables ---
-#if PENDANT_HAS_BUTTON_MATRIX
-static KeyInfo key_matrix[PENDANT_MATRIX_ROWS][PENDANT_MATRIX_COLS];
-#endif
-
 static uint32_t current_button_bitmask = 0;
 static ESP32Encoder handwheel;
 static int32_t handwheel_position = 0;
 static uint8_t selected_axis = 0;
 static uint8_t selected_step = 0;
-static bool data_changed_flag = false;
-
-// For get_handwheel_diff()
-static int32_t last_count = 0;
-static volatile int16_t handwheel_diff = 0;
+static int32_t handwheel_raw_last = 0;
 
 // --- Forward declarations for internal functions ---
 static void update_keypad_states();
 static void read_encoders();
+static void read_overrides();
 static void read_selectors();
 
 //================================================================================
@@ -112,6 +93,7 @@ void hmi_pendant_init()
     feedEnc.attachFullQuad(PIN_FEED_OVR_A, PIN_FEED_OVR_B);
     feedEnc.clearCount();
 #endif
+    override_engine_reset(OVERRIDE_FEED, 0);
 
     // 2) Rapid-override encoder
 #if PENDANT_HAS_RAPID_OVERRIDE_ENCODER
@@ -122,6 +104,7 @@ void hmi_pendant_init()
     rapidEnc.attachFullQuad(PIN_RAPID_OVR_A, PIN_RAPID_OVR_B);
     rapidEnc.clearCount();
 #endif
+    override_engine_reset(OVERRIDE_RAPID, 0);
 
     // 3) Spindle-override encoder
 #if PENDANT_HAS_SPINDLE_OVERRIDE_ENCODER
@@ -132,28 +115,41 @@ void hmi_pendant_init()
     spindleEnc.attachFullQuad(PIN_SPINDLE_OVR_A, PIN_SPINDLE_OVR_B);
     spindleEnc.clearCount();
 #endif
+    override_engine_reset(OVERRIDE_SPINDLE, 0);
 
     // 4) Handwheel encoder
 #if PENDANT_HAS_HANDWHEEL_ENCODER
     ESP32Encoder::useInternalWeakPullResistors = puType::up;
     handwheel.attachFullQuad(HW_ENCODER_A, HW_ENCODER_B);
     handwheel.clearCount();
+    handwheel_engine_reset(0);
 #endif
 
-    // 5) Button matrix
+    // 5) Button matrix (scanned from its own timer from here on)
 #if PENDANT_HAS_BUTTON_MATRIX
-    for (size_t i = 0; i < PENDANT_MATRIX_ROWS; ++i)
+    if (matrix_scan_init())
     {
-        pinMode(PENDANT_ROW_PINS[i], OUTPUT);
-        digitalWrite(PENDANT_ROW_PINS[i], HIGH);
+        MatrixScanStats st;
+        matrix_scan_get_stats(st);
+        Serial.printf("Matrix scan: tick %lu us, full scan %lu us, worst key latency %lu us\n",
+                      (unsigned long)st.tick_us, (unsigned long)st.scan_period_us,
+                      (unsigned long)st.worst_latency_us);
     }
-    for (size_t i = 0; i < PENDANT_MATRIX_COLS; ++i)
+    else
     {
-        pinMode(PENDANT_COL_PINS[i], INPUT_PULLUP);
+        Serial.println("ERROR: Button matrix scanner failed to start.");
     }
 #endif
 
-    // 6) LEDs
+    // 6) Axis/step selectors (ADC continuous mode, decoded on core 0)
+    selector_set_positions(SELECTOR_AXIS, pendant_web_cfg.num_dro_axes);
+    selector_set_positions(SELECTOR_STEP, 4);
+    if (!selector_init())
+    {
+        Serial.println("ERROR: Selector ADC failed to start; axis/step stay at 0.");
+    }
+
+    // 7) LEDs
 #if PENDANT_HAS_LEDS
     for (size_t i = 0; i < NUM_PENDANT_LEDS; ++i)
     {
@@ -167,20 +163,11 @@ void hmi_pendant_task()
 {
     update_keypad_states();
     read_encoders();
+    read_overrides();
     read_selectors();
     ui_bridge_update_jog_selectors(selected_axis, selected_step);
 }
 
-bool hmi_pendant_data_has_changed()
-{
-    if (data_changed_flag)
-    {
-        data_changed_flag = false;
-        return true;
-    }
-    return false;
-}
-
 void get_pendant_data(PendantStatePacket *out)
 {
     if (!out)
@@ -189,12 +176,25 @@ void get_pendant_data(PendantStatePacket *out)
     out->handwheel_position = handwheel_position;
     out->selected_axis = selected_axis;
     out->selected_step = selected_step;
+    out->feed_override_position = override_engine_percent(OVERRIDE_FEED) / 100.0f;
+    out->rapid_override_position = override_engine_percent(OVERRIDE_RAPID) / 100.0f;
+    out->spindle_override_position = override_engine_percent(OVERRIDE_SPINDLE) / 100.0f;
 }
 
+// Runs on loopTask, like the knob processing and LVGL.
 void update_hmi_from_lcnc(const LcncStatusPacket &data)
 {
     ui_bridge_update_from_lcnc(data);
 
+    // Follow overrides changed elsewhere (GUI, MDI) while the knobs are idle
+    int64_t now = esp_timer_get_time();
+    override_engine_sync(OVERRIDE_FEED, (int16_t)lroundf(data.feed_override * 100), now);
+    override_engine_sync(OVERRIDE_RAPID, (int16_t)lroundf(data.rapid_override * 100), now);
+    override_engine_sync(OVERRIDE_SPINDLE, (int16_t)lroundf(data.spindle_override * 100), now);
+    ui_popups_set_override(UI_PART_FEED_OVERRIDE, override_engine_percent(OVERRIDE_FEED));
+    ui_popups_set_override(UI_PART_RAPIDS_OVERRIDE, override_engine_percent(OVERRIDE_RAPID));
+    ui_popups_set_override(UI_PART_SPINDLE_OVERRIDE, override_engine_percent(OVERRIDE_SPINDLE));
+
 #if PENDANT_HAS_LEDS
     for (size_t i = 0;
          i < pendant_web_cfg.led_bindings.size() && i < NUM_PENDANT_LEDS;
@@ -218,106 +218,85 @@ void get_pendant_live_status(uint32_t &btn_states,
     step_pos = selected_step;
 }
 
-// Returns the delta since last call and stores it internally
-int32_t get_handwheel_diff()
-{
-    int32_t current = handwheel.getCount();
-    int32_t diff = current - last_count;
-    last_count = current;
-    handwheel_diff = diff;
-    return diff;
-}
-
 //================================================================================
 // INTERNAL HELPER FUNCTIONS
 //================================================================================
 
 static void update_keypad_states()
 {
-#if PENDANT_HAS_BUTTON_MATRIX
-    // Drive one row low at a time, read columns
-    for (size_t r = 0; r < PENDANT_MATRIX_ROWS; ++r)
+    // The scanner debounces on its own timer; here we only forward its edges.
+    MatrixKeyEdge edge;
+    while (matrix_scan_next_edge(edge))
     {
-        // Set all rows HIGH, then drive this one LOW
-        for (size_t rr = 0; rr < PENDANT_MATRIX_ROWS; ++rr)
-            digitalWrite(PENDANT_ROW_PINS[rr], rr == r ? LOW : HIGH);
-        delayMicroseconds(20);
-
-        // Read each column
-        for (size_t c = 0; c < PENDANT_MATRIX_COLS; ++c)
-        {
-            bool raw = (digitalRead(PENDANT_COL_PINS[c]) == LOW);
-            KeyInfo &ki = key_matrix[r][c];
-
-            // Debounce edge detection
-            if (raw != ki.last_raw)
-            {
-                ki.last_raw = raw;
-                ki.last_change_ms = millis();
-            }
-            else if (millis() - ki.last_change_ms >= KEY_DEBOUNCE_MS)
-            {
-                uint8_t bitIndex = r * PENDANT_MATRIX_COLS + c;
-
-                if (raw && ki.state == KeyState::IDLE)
-                {
-                    ki.state = KeyState::PRESSED;
-                    data_changed_flag = true;
-                    if (bitIndex < 32)
-                        current_button_bitmask |= (1u << bitIndex);
-                }
-                else if (!raw && (ki.state == KeyState::PRESSED || ki.state == KeyState::HELD))
-                {
-                    ki.state = KeyState::RELEASED;
-                    data_changed_flag = true;
-                    if (bitIndex < 32)
-                        current_button_bitmask &= ~(1u << bitIndex);
-                }
-                else if (ki.state == KeyState::PRESSED)
-                {
-                    ki.state = KeyState::HELD;
-                }
-            }
-        }
+        input_bus_publish(InputEventType::KEY, edge.index, edge.pressed ? 1 : 0);
     }
-
-    // Return all rows to HIGH
-    for (size_t rr = 0; rr < PENDANT_MATRIX_ROWS; ++rr)
-        digitalWrite(PENDANT_ROW_PINS[rr], HIGH);
-#endif
+    current_button_bitmask = matrix_scan_state();
 }
 
 static void read_encoders()
 {
-    int32_t diff = get_handwheel_diff();
-    if (diff != 0)
+    // The engine applies the velocity curve, so handwheel_position is in jog
+    // counts. The raw change travels alongside it for LVGL focus navigation.
+    int32_t raw = handwheel.getCount();
+    int32_t jog = handwheel_engine_process(raw, esp_timer_get_time(),
+                                           selected_axis, handwheel_cfg);
+    handwheel_position += jog;
+    if (raw != handwheel_raw_last)
+    {
+        input_bus_publish(InputEventType::HANDWHEEL, 0, handwheel_position,
+                          raw - handwheel_raw_last);
+        handwheel_raw_last = raw;
+    }
+    else if (jog != 0)
+    {
+        // Residual from the curve emitted after the wheel stopped.
+        input_bus_publish(InputEventType::HANDWHEEL, 0, handwheel_position, 0);
+    }
+}
+
+/**
+ * @brief Runs one override knob through the engine and publishes any change.
+ */
+static void process_override(OverrideChannel ch, int32_t raw, InputEventType type, ui_lazy_part_t part)
+{
+    int32_t detents;
+    if (override_engine_process(ch, raw, esp_timer_get_time(), detents))
     {
-        handwheel_position += diff;
-        data_changed_flag = true;
+        int16_t pct = override_engine_percent(ch);
+        input_bus_publish(type, ch, pct, detents);
+        ui_popups_set_override(part, pct);
     }
 }
 
+static void read_overrides()
+{
+#if PENDANT_HAS_FEED_OVERRIDE_ENCODER
+    process_override(OVERRIDE_FEED, feedEnc.getCount(), InputEventType::FEED_OVERRIDE, UI_PART_FEED_OVERRIDE);
+#endif
+#if PENDANT_HAS_RAPID_OVERRIDE_ENCODER
+    process_override(OVERRIDE_RAPID, rapidEnc.getCount(), InputEventType::RAPID_OVERRIDE, UI_PART_RAPIDS_OVERRIDE);
+#endif
+#if PENDANT_HAS_SPINDLE_OVERRIDE_ENCODER
+    process_override(OVERRIDE_SPINDLE, spindleEnc.getCount(), InputEventType::SPINDLE_OVERRIDE, UI_PART_SPINDLE_OVERRIDE);
+#endif
+}
+
 static void read_selectors()
 {
-#if defined(AXIS_SELECTOR_ADC)
-    uint32_t rawA = analogRead(AXIS_SELECTOR_ADC);
-    uint8_t maxAxes = pendant_web_cfg.num_dro_axes;
-    uint8_t newAxis = (rawA * maxAxes) / 4096;
+    // Positions are confirmed by the selector task; this only reports changes.
+    selector_set_positions(SELECTOR_AXIS, pendant_web_cfg.num_dro_axes);
+
+    uint8_t newAxis = selector_position(SELECTOR_AXIS);
     if (newAxis != selected_axis)
     {
         selected_axis = newAxis;
-        data_changed_flag = true;
+        input_bus_publish(InputEventType::AXIS_SELECTOR, 0, selected_axis);
     }
-#endif
 
-#if defined(STEP_SELECTOR_ADC)
-    uint32_t rawS = analogRead(STEP_SELECTOR_ADC);
-    constexpr uint8_t NUM_STEPS = 4;
-    uint8_t newStep = (rawS * NUM_STEPS) / 4096;
+    uint8_t newStep = selector_position(SELECTOR_STEP);
     if (newStep != selected_step)
     {
         selected_step = newStep;
-        data_changed_flag = true;
+        input_bus_publish(InputEventType::STEP_SELECTOR, 0, selected_step);
     }
-#endif
 }
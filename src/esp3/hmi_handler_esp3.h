@@ -17,11 +17,9 @@ extern "C"
 
     void hmi_pendant_init();
     void hmi_pendant_task();
-    bool hmi_pendant_data_has_changed();
     void get_pendant_data(PendantStatePacket *out);
     void update_hmi_from_lcnc(const LcncStatusPacket &data);
     void get_pendant_live_status(uint32_t &btn_states, int32_t &hw_pos, uint8_t &axis_pos, uint8_t &step_pos);
-    int32_t get_handwheel_diff();
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,118 @@
+/**
+ * @file input_bus_esp3.cpp
+ * @brief Single-producer, multi-consumer ring buffer for pendant input events.
+ *
+ * The producer writes a slot and then publishes it by advancing the sequence
+ * counter with release ordering. Consumers never write shared state: each one
+ * owns a cursor and re-checks the counter after copying a slot, so a slot that
+ * was overwritten mid-copy is detected and counted rather than delivered torn.
+ * A slot is unsafe as soon as head - cursor reaches INPUT_BUS_CAPACITY: the
+ * producer writes sequence head into it before advancing head.
+ */
+
+#include "input_bus_esp3.h"
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+
+static_assert((INPUT_BUS_CAPACITY & (INPUT_BUS_CAPACITY - 1)) == 0,
+              "INPUT_BUS_CAPACITY must be a power of two");
+
+struct Subscriber
+{
+    const char *name;
+    uint32_t cursor;
+    uint32_t overruns;
+};
+
+static InputEvent ring[INPUT_BUS_CAPACITY];
+static std::atomic<uint32_t> head{0}; // Sequence number of the next event to write
+static Subscriber subscribers[INPUT_BUS_MAX_SUBSCRIBERS];
+static std::atomic<int> subscriber_count{0};
+
+void input_bus_publish(InputEventType type, uint8_t index, int32_t value, int32_t delta)
+{
+    uint32_t seq = head.load(std::memory_order_relaxed);
+    InputEvent &slot = ring[seq & (INPUT_BUS_CAPACITY - 1)];
+    slot.timestamp_us = (uint32_t)esp_timer_get_time();
+    slot.type = type;
+    slot.index = index;
+    slot.value = value;
+    slot.delta = delta;
+    head.store(seq + 1, std::memory_order_release);
+}
+
+int input_bus_subscribe(const char *name)
+{
+    int id = subscriber_count.load();
+    if (id >= INPUT_BUS_MAX_SUBSCRIBERS)
+    {
+        Serial.printf("ERROR: input bus has no free slot for '%s'\n", name);
+        return -1;
+    }
+    subscribers[id].name = name;
+    subscribers[id].cursor = head.load(std::memory_order_acquire);
+    subscribers[id].overruns = 0;
+    subscriber_count.store(id + 1);
+    return id;
+}
+
+size_t input_bus_read(int subscriber, InputEvent *out, size_t max_events)
+{
+    if (subscriber < 0 || subscriber >= subscriber_count.load() || !out)
+        return 0;
+
+    Subscriber &sub = subscribers[subscriber];
+    size_t copied = 0;
+    while (copied < max_events)
+    {
+        uint32_t published = head.load(std::memory_order_acquire);
+        if (published == sub.cursor)
+            break;
+
+        // With head - cursor == CAPACITY the producer is already rewriting the
+        // cursor's slot (it publishes only after writing). Skip to the oldest
+        // slot that is complete and not the next one to be written.
+        if (published - sub.cursor >= INPUT_BUS_CAPACITY)
+        {
+            const uint32_t oldest = published - INPUT_BUS_CAPACITY + 1;
+            sub.overruns += oldest - sub.cursor;
+            sub.cursor = oldest;
+        }
+
+        InputEvent ev = ring[sub.cursor & (INPUT_BUS_CAPACITY - 1)];
+
+        // The producer may have reached the slot while we copied; discard it torn.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (head.load(std::memory_order_relaxed) - sub.cursor >= INPUT_BUS_CAPACITY)
+        {
+            sub.overruns++;
+            sub.cursor++;
+            continue;
+        }
+
+        out[copied++] = ev;
+        sub.cursor++;
+    }
+    return copied;
+}
+
+uint32_t input_bus_overruns(int subscriber)
+{
+    if (subscriber < 0 || subscriber >= subscriber_count.load())
+        return 0;
+    return subscribers[subscriber].overruns;
+}
+
+void input_bus_print_stats()
+{
+    uint32_t published = head.load(std::memory_order_acquire);
+    Serial.printf("--- Input bus: %lu events published ---\n", (unsigned long)published);
+    for (int i = 0; i < subscriber_count.load(); ++i)
+    {
+        const Subscriber &sub = subscribers[i];
+        Serial.printf("  %-10s backlog %3lu  overruns %lu\n", sub.name,
+                      (unsigned long)(published - sub.cursor),
+                      (unsigned long)sub.overruns);
+    }
+}
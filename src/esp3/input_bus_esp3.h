@@ -0,0 +1,77 @@
+/**
+ * @file input_bus_esp3.h
+ * @brief Lock-free, multi-consumer event bus for the pendant's physical inputs.
+ *
+ * The HMI handler publishes one timestamped event per input change (key edge,
+ * handwheel movement, override encoder, selector). Each consumer - the radio
+ * sender, LVGL focus navigation and the web live view - subscribes with its
+ * own cursor and reads at its own pace, so no consumer can steal events from
+ * another.
+ *
+ * The producer never blocks, so delivery is not guaranteed: a consumer that
+ * falls INPUT_BUS_CAPACITY - 1 events behind loses the oldest ones. They are
+ * counted in input_bus_overruns(), and a slot rewritten while it is being
+ * read is detected and dropped, never delivered torn. With at most one
+ * handwheel event per 1 ms HMI pass the ring holds over 100 ms of input,
+ * while the consumers drain it every loop or LVGL pass.
+ */
+
+#ifndef INPUT_BUS_ESP3_H
+#define INPUT_BUS_ESP3_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+static constexpr size_t INPUT_BUS_CAPACITY = 128; // Must be a power of two
+static constexpr int INPUT_BUS_MAX_SUBSCRIBERS = 4;
+
+enum class InputEventType : uint8_t
+{
+    KEY,              // index = matrix bit, value = 1 pressed / 0 released
+    HANDWHEEL,        // value = jog position, delta = raw count change
+    FEED_OVERRIDE,    // value = override percent, delta = detents
+    RAPID_OVERRIDE,   // value = override percent, delta = detents
+    SPINDLE_OVERRIDE, // value = override percent, delta = detents
+    AXIS_SELECTOR,    // value = selected axis
+    STEP_SELECTOR     // value = selected step
+};
+
+struct InputEvent
+{
+    uint32_t timestamp_us;
+    InputEventType type;
+    uint8_t index;
+    int32_t value;
+    int32_t delta;
+};
+
+/**
+ * @brief Publishes an event. Single producer: call only from the HMI task.
+ */
+void input_bus_publish(InputEventType type, uint8_t index, int32_t value, int32_t delta = 0);
+
+/**
+ * @brief Registers a consumer. Its cursor starts at the current head.
+ * @param name Short label used in diagnostics.
+ * @return Subscriber id, or -1 if all slots are taken.
+ */
+int input_bus_subscribe(const char *name);
+
+/**
+ * @brief Copies up to max_events unread events for a subscriber.
+ * @return Number of events copied; 0 when the subscriber is caught up.
+ */
+size_t input_bus_read(int subscriber, InputEvent *out, size_t max_events);
+
+/**
+ * @brief Returns the number of events a subscriber missed by falling
+ *        INPUT_BUS_CAPACITY - 1 or more events behind.
+ */
+uint32_t input_bus_overruns(int subscriber);
+
+/**
+ * @brief Prints per-subscriber backlog and overrun counts to Serial.
+ */
+void input_bus_print_stats();
+
+#endif // INPUT_BUS_ESP3_H
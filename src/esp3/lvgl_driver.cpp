@@ -10,12 +10,32 @@
 #include <esp_timer.h>
 #include <esp_heap_caps.h>
 #include "persistence_esp3.h"
+#include "config_esp3.h"
+#include "input_bus_esp3.h"
 
 // --- Driver Instances and Globals ---
 static LGFX tft;
 static lv_display_t *disp;
 lv_group_t *g_default_group = nullptr;
-extern QueueHandle_t encoderDeltaQueue;
+static int encoder_subscriber = -1;
+
+// --- Interrupt-driven touch state ---
+// The FT6336U pulls INT low while a finger is down. The ISR only wakes the
+// reader task; the reader does the I2C transfer and buffers timestamped points
+// for touchpad_read_cb, so LVGL never touches the I2C bus itself.
+struct TouchSample
+{
+    uint16_t x;
+    uint16_t y;
+    bool pressed;
+    uint32_t timestamp_us;
+};
+
+static QueueHandle_t touch_queue = nullptr;
+static TaskHandle_t touch_task_handle = nullptr;
+static bool touch_irq_mode = false;
+static TouchSample touch_last = {0, 0, false, 0};
+static uint32_t touch_latency_max_us = 0;
 
 // --- LVGL Callbacks ---
 
@@ -35,41 +55,155 @@ static void display_flush_cb(lv_display_t *display,
     lv_display_flush_ready(display);
 }
 
+static void IRAM_ATTR touch_int_isr()
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(touch_task_handle, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+static void push_touch_sample(uint16_t x, uint16_t y, bool pressed)
+{
+    TouchSample s = {x, y, pressed, (uint32_t)esp_timer_get_time()};
+    if (xQueueSend(touch_queue, &s, 0) != pdTRUE)
+    {
+        // Buffer full: drop the oldest point, never the newest (or a release).
+        TouchSample stale;
+        xQueueReceive(touch_queue, &stale, 0);
+        xQueueSend(touch_queue, &s, 0);
+    }
+}
+
+/**
+ * @brief Sleeps until the touch INT line fires, then samples the controller at
+ *        TOUCH_SAMPLE_PERIOD_MS until the finger is lifted.
+ */
+static void touch_reader_task(void *arg)
+{
+    (void)arg;
+    while (true)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        uint16_t last_x = UINT16_MAX, last_y = UINT16_MAX;
+        bool pressed = true;
+        while (pressed)
+        {
+            uint16_t x, y;
+            pressed = tft.getTouch(&x, &y);
+            if (!pressed)
+            {
+                push_touch_sample(last_x, last_y, false);
+                break;
+            }
+            if (x != last_x || y != last_y)
+            {
+                push_touch_sample(x, y, true);
+                last_x = x;
+                last_y = y;
+            }
+            vTaskDelay(pdMS_TO_TICKS(DisplayConfig::TOUCH_SAMPLE_PERIOD_MS));
+        }
+
+        // Edges raised during the contact are already covered by the loop above.
+        ulTaskNotifyTake(pdTRUE, 0);
+    }
+}
+
+static bool touch_irq_init()
+{
+#if PENDANT_TOUCH_USE_IRQ
+    touch_queue = xQueueCreate(DisplayConfig::TOUCH_BUFFER_DEPTH, sizeof(TouchSample));
+    if (!touch_queue)
+        return false;
+
+    if (xTaskCreatePinnedToCore(touch_reader_task, "touchTask", 3 * 1024, nullptr,
+                                /* priority */ 2, &touch_task_handle, /* core */ 1) != pdPASS)
+    {
+        vQueueDelete(touch_queue);
+        touch_queue = nullptr;
+        return false;
+    }
+
+    pinMode(DisplayConfig::PIN_TOUCH_INT, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(DisplayConfig::PIN_TOUCH_INT), touch_int_isr, FALLING);
+
+    // A finger resting on the panel at boot holds INT low without an edge.
+    if (digitalRead(DisplayConfig::PIN_TOUCH_INT) == LOW)
+        xTaskNotifyGive(touch_task_handle);
+    return true;
+#else
+    return false;
+#endif
+}
+
 static void touchpad_read_cb(lv_indev_t *indev,
                              lv_indev_data_t *data)
 {
     (void)indev;
-    uint16_t touchX, touchY;
-    bool touched = tft.getTouch(&touchX, &touchY);
-    if (touched)
+
+    if (!touch_irq_mode)
     {
-        data->state = LV_INDEV_STATE_PRESSED;
-        data->point.x = touchX;
-        data->point.y = touchY;
+        // Polling fallback: one I2C transaction per LVGL input read.
+        uint16_t touchX, touchY;
+        touch_last.pressed = tft.getTouch(&touchX, &touchY);
+        if (touch_last.pressed)
+        {
+            touch_last.x = touchX;
+            touch_last.y = touchY;
+        }
     }
     else
     {
-        data->state = LV_INDEV_STATE_RELEASED;
+        TouchSample s;
+        if (xQueueReceive(touch_queue, &s, 0) == pdTRUE)
+        {
+            uint32_t latency = (uint32_t)esp_timer_get_time() - s.timestamp_us;
+            if (latency > touch_latency_max_us)
+                touch_latency_max_us = latency;
+
+            // A release carries no coordinates; keep the last pressed point.
+            if (s.pressed)
+            {
+                touch_last = s;
+            }
+            else
+            {
+                touch_last.pressed = false;
+            }
+            data->continue_reading = uxQueueMessagesWaiting(touch_queue) > 0;
+        }
     }
+
+    data->point.x = touch_last.x;
+    data->point.y = touch_last.y;
+    data->state = touch_last.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
 }
 
 static void encoder_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
 {
     (void)indev;
-    int32_t diff = get_handwheel_diff();
+
+    // Sum the raw handwheel movement since LVGL last asked; focus navigation
+    // wants detent-for-detent motion, not the accelerated jog counts.
+    InputEvent events[16];
+    int32_t diff = 0;
+    size_t n = input_bus_read(encoder_subscriber, events, 16);
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (events[i].type == InputEventType::HANDWHEEL)
+            diff += events[i].delta;
+    }
+    if (n == 16)
+        data->continue_reading = true;
+
     // apply inversion and deadzone as before…
     if (encoder_inverted)
         diff = -diff;
     if (abs(diff) < encoder_deadzone)
         diff = 0;
 
-    // feed LVGL so the UI still moves
     data->enc_diff = diff;
-
-    // queue it for later logging/processing
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xQueueSendFromISR(encoderDeltaQueue, &diff, &xHigherPriorityTaskWoken);
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 // --- Main Initialization Function ---
@@ -131,11 +265,14 @@ void lvgl_driver_init()
     lv_indev_t *indev_touch = lv_indev_create();
     lv_indev_set_type(indev_touch, LV_INDEV_TYPE_POINTER);
     lv_indev_set_read_cb(indev_touch, touchpad_read_cb);
+    touch_irq_mode = touch_irq_init();
+    Serial.printf("DEBUG: Touch input mode: %s\n", touch_irq_mode ? "interrupt" : "polling");
 
     // 6. Register handwheel encoder only (no keyboard)
     lv_indev_t *indev_encoder = lv_indev_create();
     lv_indev_set_type(indev_encoder, LV_INDEV_TYPE_ENCODER);
     lv_indev_set_read_cb(indev_encoder, encoder_read_cb);
+    encoder_subscriber = input_bus_subscribe("lvgl");
 
     // 7. Create and assign an encoder-only group
     g_default_group = lv_group_create();
@@ -145,3 +282,10 @@ void lvgl_driver_init()
     lvgl_initialized = true;
     Serial.println("DEBUG: LVGL initialization complete");
 }
+
+bool lvgl_driver_touch_status(bool &irq_mode, uint32_t &max_latency_us)
+{
+    irq_mode = touch_irq_mode;
+    max_latency_us = touch_latency_max_us;
+    return lvgl_initialized;
+}
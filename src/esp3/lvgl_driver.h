@@ -40,6 +40,15 @@ extern "C"
      */
     bool lvgl_driver_status(int &fps);
 
+    /**
+     * @brief Query how touch input is acquired and its worst buffered latency.
+     *
+     * @param[out] irq_mode true if the INT-pin reader task feeds LVGL, false if polling.
+     * @param[out] max_latency_us Largest sample-to-LVGL delay seen so far, in microseconds.
+     * @return true if the driver is initialized, false otherwise.
+     */
+    bool lvgl_driver_touch_status(bool &irq_mode, uint32_t &max_latency_us);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,285 @@
+/**
+ * @file lvgl_mem_tiered.c
+ * @brief LV_STDLIB_CUSTOM allocator that splits LVGL's heap between internal RAM and PSRAM.
+ *
+ * Every block carries an 8-byte header recording its size and tier so frees
+ * and reallocs can keep exact per-tier statistics without querying the heap.
+ */
+
+#include <lvgl.h>
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
+
+#include "lvgl_mem_tiered.h"
+#include <esp_heap_caps.h>
+#include <stdio.h>
+#include <string.h>
+
+// Re-check the internal heap for the fragmentation guard every N allocations.
+#define GUARD_CHECK_INTERVAL 64
+
+#define BLOCK_MAGIC 0x4C560000u // "LV" in the upper half, tier in the lower half
+
+// --- Module-static (private) variables ---
+
+typedef struct
+{
+    uint32_t size;
+    uint32_t tag; // BLOCK_MAGIC | tier
+} block_hdr_t;
+
+static lvgl_mem_tier_stats_t tier_stats[LVGL_MEM_TIER_COUNT];
+static bool guard_active = false;
+static uint32_t guard_countdown = 0;
+static uint32_t exhausted_count = 0;    // Allocations neither tier could serve
+static uint32_t exhausted_reported = 0; // exhausted_count at the last lv_mem_monitor()
+
+static const uint32_t tier_caps[LVGL_MEM_TIER_COUNT] = {
+    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+    MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+};
+
+// --- Internal Functions ---
+
+static void update_guard(void)
+{
+    if (guard_countdown-- > 0)
+        return;
+    guard_countdown = GUARD_CHECK_INTERVAL;
+    guard_active = heap_caps_get_largest_free_block(tier_caps[LVGL_MEM_TIER_INTERNAL]) < LV_MEM_TIER_INTERNAL_RESERVE;
+}
+
+static lvgl_mem_tier_t choose_tier(size_t size)
+{
+    if (size > LV_MEM_TIER_SMALL_MAX)
+        return LVGL_MEM_TIER_PSRAM;
+
+    update_guard();
+    if (guard_active ||
+        tier_stats[LVGL_MEM_TIER_INTERNAL].used_bytes + size > LV_MEM_TIER_INTERNAL_BUDGET)
+    {
+        tier_stats[LVGL_MEM_TIER_INTERNAL].spills++;
+        return LVGL_MEM_TIER_PSRAM;
+    }
+    return LVGL_MEM_TIER_INTERNAL;
+}
+
+static void account_alloc(lvgl_mem_tier_t tier, size_t size)
+{
+    lvgl_mem_tier_stats_t *s = &tier_stats[tier];
+    s->used_bytes += size;
+    s->blocks++;
+    s->allocs++;
+    if (s->used_bytes > s->peak_bytes)
+        s->peak_bytes = s->used_bytes;
+    if (s->blocks > s->peak_blocks)
+        s->peak_blocks = s->blocks;
+}
+
+static void account_free(lvgl_mem_tier_t tier, size_t size)
+{
+    lvgl_mem_tier_stats_t *s = &tier_stats[tier];
+    s->used_bytes -= size;
+    s->blocks--;
+    s->frees++;
+}
+
+static block_hdr_t *header_of(void *p)
+{
+    block_hdr_t *hdr = (block_hdr_t *)p - 1;
+    LV_ASSERT_MSG((hdr->tag & 0xFFFF0000u) == BLOCK_MAGIC, "lv_free on a block not owned by the tiered allocator");
+    return hdr;
+}
+
+static uint8_t frag_pct(uint32_t caps)
+{
+    size_t free_bytes = heap_caps_get_free_size(caps);
+    if (free_bytes == 0)
+        return 0;
+    size_t biggest = heap_caps_get_largest_free_block(caps);
+    return (uint8_t)(100 - (biggest * 100) / free_bytes);
+}
+
+// --- LVGL Custom Stdlib Hooks ---
+
+void lv_mem_init(void)
+{
+    memset(tier_stats, 0, sizeof(tier_stats));
+    guard_active = false;
+    guard_countdown = 0;
+    exhausted_count = 0;
+    exhausted_reported = 0;
+}
+
+void lv_mem_deinit(void)
+{
+    // Blocks live in the system heaps; nothing to release here.
+}
+
+lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes)
+{
+    LV_UNUSED(mem);
+    LV_UNUSED(bytes);
+    return NULL; // Pools are managed by ESP-IDF heap_caps
+}
+
+void lv_mem_remove_pool(lv_mem_pool_t pool)
+{
+    LV_UNUSED(pool);
+}
+
+void *lv_malloc_core(size_t size)
+{
+    lvgl_mem_tier_t tier = choose_tier(size);
+    block_hdr_t *hdr = (block_hdr_t *)heap_caps_malloc(sizeof(block_hdr_t) + size, tier_caps[tier]);
+
+    if (!hdr)
+    {
+        // Serve from the other tier rather than failing the UI.
+        tier_stats[tier].failures++;
+        tier_stats[tier].spills++;
+        tier = (tier == LVGL_MEM_TIER_INTERNAL) ? LVGL_MEM_TIER_PSRAM : LVGL_MEM_TIER_INTERNAL;
+        hdr = (block_hdr_t *)heap_caps_malloc(sizeof(block_hdr_t) + size, tier_caps[tier]);
+        if (!hdr)
+        {
+            tier_stats[tier].failures++;
+            exhausted_count++;
+            return NULL;
+        }
+    }
+
+    hdr->size = (uint32_t)size;
+    hdr->tag = BLOCK_MAGIC | tier;
+    account_alloc(tier, size);
+    return hdr + 1;
+}
+
+void *lv_realloc_core(void *p, size_t new_size)
+{
+    if (!p)
+        return lv_malloc_core(new_size);
+
+    block_hdr_t *hdr = header_of(p);
+    lvgl_mem_tier_t tier = (lvgl_mem_tier_t)(hdr->tag & 0xFFFFu);
+    size_t old_size = hdr->size;
+
+    // PSRAM blocks stay put; internal blocks move out once they outgrow the tier.
+    bool stays = (tier == LVGL_MEM_TIER_PSRAM) ||
+                 (new_size <= LV_MEM_TIER_SMALL_MAX &&
+                  tier_stats[LVGL_MEM_TIER_INTERNAL].used_bytes - old_size + new_size <= LV_MEM_TIER_INTERNAL_BUDGET);
+
+    if (stays)
+    {
+        block_hdr_t *n = (block_hdr_t *)heap_caps_realloc(hdr, sizeof(block_hdr_t) + new_size, tier_caps[tier]);
+        if (n)
+        {
+            account_free(tier, old_size);
+            n->size = (uint32_t)new_size;
+            account_alloc(tier, new_size);
+            tier_stats[tier].frees--; // A resize is not a new block
+            tier_stats[tier].allocs--;
+            return n + 1;
+        }
+        tier_stats[tier].failures++;
+    }
+
+    void *moved = lv_malloc_core(new_size);
+    if (!moved)
+        return NULL;
+    memcpy(moved, p, old_size < new_size ? old_size : new_size);
+    lv_free_core(p);
+    return moved;
+}
+
+void lv_free_core(void *p)
+{
+    if (!p)
+        return;
+    block_hdr_t *hdr = header_of(p);
+    account_free((lvgl_mem_tier_t)(hdr->tag & 0xFFFFu), hdr->size);
+    hdr->tag = 0;
+    heap_caps_free(hdr);
+}
+
+// The internal tier runs close to its budget by design and spills to PSRAM,
+// so it is not counted as pressure. used_pct is the share of everything LVGL
+// can get that is in use (in practice PSRAM), and reads 100 if an allocation
+// failed in both tiers since the previous call. The lazy-UI watchdog trims on it.
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p)
+{
+    const lvgl_mem_tier_stats_t *in = &tier_stats[LVGL_MEM_TIER_INTERNAL];
+    const lvgl_mem_tier_stats_t *ps = &tier_stats[LVGL_MEM_TIER_PSRAM];
+
+    size_t internal_free = in->used_bytes < LV_MEM_TIER_INTERNAL_BUDGET ? LV_MEM_TIER_INTERNAL_BUDGET - in->used_bytes : 0;
+    size_t psram_free = heap_caps_get_free_size(tier_caps[LVGL_MEM_TIER_PSRAM]);
+
+    mon_p->total_size = LV_MEM_TIER_INTERNAL_BUDGET + ps->used_bytes + psram_free;
+    mon_p->free_size = internal_free + psram_free;
+    mon_p->free_biggest_size = heap_caps_get_largest_free_block(tier_caps[LVGL_MEM_TIER_PSRAM]);
+    mon_p->free_cnt = 0; // Not tracked by heap_caps
+    mon_p->used_cnt = in->blocks + ps->blocks;
+    mon_p->max_used = in->peak_bytes + ps->peak_bytes;
+
+    uint32_t used_pct = mon_p->total_size ? (uint32_t)(100 - (mon_p->free_size * 100) / mon_p->total_size) : 100;
+    if (exhausted_count != exhausted_reported)
+    {
+        exhausted_reported = exhausted_count;
+        used_pct = 100;
+    }
+    mon_p->used_pct = (uint8_t)LV_MIN(100, used_pct);
+    mon_p->frag_pct = frag_pct(tier_caps[LVGL_MEM_TIER_INTERNAL]);
+}
+
+lv_result_t lv_mem_test_core(void)
+{
+    return heap_caps_check_integrity_all(true) ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+// --- Public Functions ---
+
+void lvgl_mem_get_stats(lvgl_mem_tier_t tier, lvgl_mem_tier_stats_t *out)
+{
+    if (tier < LVGL_MEM_TIER_COUNT && out)
+    {
+        *out = tier_stats[tier];
+    }
+}
+
+bool lvgl_mem_guard_active(void)
+{
+    return guard_active;
+}
+
+void lvgl_mem_print_report(void)
+{
+    static const char *names[LVGL_MEM_TIER_COUNT] = {"internal", "psram"};
+
+    printf("--- LVGL heap report ---\n");
+    printf("tier      used    peak   blocks  peak  allocs   frees  fail  spill\n");
+    for (int t = 0; t < LVGL_MEM_TIER_COUNT; t++)
+    {
+        const lvgl_mem_tier_stats_t *s = &tier_stats[t];
+        printf("%-8s %6u  %6u  %6u %5u %7u %7u %5u %6u\n", names[t],
+               (unsigned)s->used_bytes, (unsigned)s->peak_bytes,
+               (unsigned)s->blocks, (unsigned)s->peak_blocks,
+               (unsigned)s->allocs, (unsigned)s->frees,
+               (unsigned)s->failures, (unsigned)s->spills);
+    }
+
+    // Blocks cannot be moved once LVGL holds pointers to them, so "compaction"
+    // means freeing whole parts (ui_lazy_trim) and letting the heap coalesce.
+    for (int t = 0; t < LVGL_MEM_TIER_COUNT; t++)
+    {
+        printf("%-8s heap: free %u, largest block %u, fragmentation %u%%\n", names[t],
+               (unsigned)heap_caps_get_free_size(tier_caps[t]),
+               (unsigned)heap_caps_get_largest_free_block(tier_caps[t]),
+               (unsigned)frag_pct(tier_caps[t]));
+    }
+    printf("internal budget %u/%u bytes, fragmentation guard %s\n",
+           (unsigned)tier_stats[LVGL_MEM_TIER_INTERNAL].used_bytes,
+           (unsigned)LV_MEM_TIER_INTERNAL_BUDGET,
+           guard_active ? "ACTIVE (all blocks -> PSRAM)" : "off");
+    printf("------------------------\n");
+}
+
+#endif // LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
@@ -0,0 +1,64 @@
+/**
+ * @file lvgl_mem_tiered.h
+ * @brief Statistics interface for the tiered LVGL allocator.
+ *
+ * With `LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM` LVGL allocates through
+ * lvgl_mem_tiered.c, which places small blocks (objects, styles, short label
+ * text) in internal RAM and large blocks (long text, image cache, layers)
+ * in PSRAM. See the LV_MEM_TIER_* settings in lv_conf.h.
+ */
+
+#ifndef LVGL_MEM_TIERED_H
+#define LVGL_MEM_TIERED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef enum
+    {
+        LVGL_MEM_TIER_INTERNAL,
+        LVGL_MEM_TIER_PSRAM,
+        LVGL_MEM_TIER_COUNT
+    } lvgl_mem_tier_t;
+
+    /** @brief Running counters for one memory tier. */
+    typedef struct
+    {
+        size_t used_bytes;    // Payload bytes currently held by LVGL
+        size_t peak_bytes;    // High-water mark of used_bytes
+        uint32_t blocks;      // Live blocks
+        uint32_t peak_blocks; // High-water mark of blocks
+        uint32_t allocs;      // Successful allocations served by this tier
+        uint32_t frees;       // Blocks returned to this tier
+        uint32_t failures;    // Allocations this tier could not serve
+        uint32_t spills;      // Allocations meant for this tier but placed in the other one
+    } lvgl_mem_tier_stats_t;
+
+    /**
+     * @brief Copies the counters of one tier.
+     * @param tier The tier to query.
+     * @param[out] out Filled with the current counters.
+     */
+    void lvgl_mem_get_stats(lvgl_mem_tier_t tier, lvgl_mem_tier_stats_t *out);
+
+    /**
+     * @brief Returns true while the fragmentation guard routes every block to PSRAM.
+     */
+    bool lvgl_mem_guard_active(void);
+
+    /**
+     * @brief Prints per-tier usage, high-water marks and a fragmentation report to Serial.
+     */
+    void lvgl_mem_print_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LVGL_MEM_TIERED_H
@@ -10,46 +10,57 @@
 #include <nvs_flash.h>
 
 #include <freertos/FreeRTOS.h>
-#include <freertos/queue.h>
 #include <freertos/task.h>
 
 // --- Core Application Headers ---
 #include "config_esp3.h"
+#include "boot_profiler.h"
 #include "persistence_esp3.h"
 #include "hmi_handler_esp3.h"
+#include "input_bus_esp3.h"
 #include "communication_esp3.h"
 #include "web_interface.h"
 #include "lvgl_driver.h"
+#include "lvgl_mem_tiered.h"
 #include "ui.h"
 #include "ui_popups.h"
 #include "ui_tab_logic.h"
 
 // --- Constants ---
 static constexpr unsigned long PENDANT_SEND_INTERVAL_MS = 50;
-static constexpr unsigned long STATUS_BROADCAST_INTERVAL_MS = 250;
 static constexpr unsigned long WIFI_CONNECT_TIMEOUT_MS = 10000;
 
 // --- Global Data Structures ---
 static PendantStatePacket outgoing_pendant_data;
 static LcncStatusPacket incoming_lcnc_data;
 
-// --- FreeRTOS Queue for Encoder Deltas ---
-QueueHandle_t encoderDeltaQueue = nullptr;
+// Latest status packet, handed from the Wi-Fi task to loopTask (the LVGL thread).
+static portMUX_TYPE lcnc_mux = portMUX_INITIALIZER_UNLOCKED;
+static LcncStatusPacket pending_lcnc_data;
+static bool lcnc_data_pending = false;
+
+// --- Input bus cursors ---
+static int radio_subscriber = -1;
+static int web_subscriber = -1;
+
+// Set by the background network task once the web server is listening.
+static volatile bool web_interface_ready = false;
 
 // --- Forward Declarations ---
 static void initialize_core_systems();
 static void initialize_hmi_and_ui();
-static void initialize_network_and_comms();
+static void initialize_comms();
+static void networkTask(void *pvParameters);
+static void deferred_ui_init(void *user_data);
 static void on_lcnc_data_received(const LcncStatusPacket &msg);
 static void handle_core_tasks();
+static void handle_lcnc_data();
 static void handle_pendant_data_sending();
-static void handle_web_status_broadcast();
+static void handle_web_status_post();
 
 // This is our new “robust” loop task:
 static void loopTask(void *pvParameters)
 {
-    int32_t diff;
-
     // Wait for LVGL to be ready
     while (!lvgl_initialized)
     {
@@ -57,38 +68,105 @@ static void loopTask(void *pvParameters)
     }
     Serial.println("DEBUG: loopTask starting - LVGL ready");
 
+    bool first_frame = true;
     while (true)
     {
-        if (xQueueReceive(encoderDeltaQueue, &diff, pdMS_TO_TICKS(10)) == pdTRUE)
+        hmi_pendant_task();
+        handle_lcnc_data();
+        apply_pending_pendant_configuration();
+        handle_pendant_data_sending();
+        if (web_interface_ready)
         {
-            ESP_LOGI("HANDWHEEL", "Encoder delta = %ld", diff);
+            handle_web_status_post();
         }
 
         lv_timer_handler(); // Now safe to call
+
+        if (first_frame)
+        {
+            // The DRO screen is on the glass: jogging is live from here on.
+            boot_profiler_milestone("first frame");
+            lv_async_call(deferred_ui_init, nullptr);
+            first_frame = false;
+        }
         vTaskDelay(pdMS_TO_TICKS(1));
     }
 }
 
+// Brings up Wi-Fi and the web server without holding up the HMI or ESP-NOW.
+static void networkTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    int stage = boot_profiler_begin("wifi join (background)");
+    WiFi.begin(Pinout::WIFI_SSID, Pinout::WIFI_PASSWORD);
+
+    unsigned long start = millis();
+    while (WiFi.status() != WL_CONNECTED &&
+           millis() - start < WIFI_CONNECT_TIMEOUT_MS)
+    {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    boot_profiler_end(stage);
+
+    if (WiFi.status() == WL_CONNECTED)
+    {
+        Serial.printf("Wi-Fi Connected. IP: %s\n",
+                      WiFi.localIP().toString().c_str());
+    }
+    else
+    {
+        Serial.println("WARN: Wi-Fi failed to connect.");
+    }
+
+    stage = boot_profiler_begin("web server (background)");
+    web_interface_init();
+    web_interface_ready = true;
+    boot_profiler_end(stage);
+
+    boot_profiler_report();
+    lvgl_mem_print_report();
+    input_bus_print_stats();
+
+    bool touch_irq = false;
+    uint32_t touch_latency_us = 0;
+    if (lvgl_driver_touch_status(touch_irq, touch_latency_us))
+    {
+        Serial.printf("Touch: %s, worst sample-to-LVGL latency %lu us\n",
+                      touch_irq ? "interrupt-driven" : "polled",
+                      (unsigned long)touch_latency_us);
+    }
+    vTaskDelete(nullptr);
+}
+
 //================================================================================
 // SETUP
 //================================================================================
 
+// Boot is staged so the pendant can jog before the network is up:
+//   1. core systems (NVS, LittleFS)          - blocking, fast
+//   2. config, HMI, LVGL, main screen        - blocking, first frame follows
+//   3. ESP-NOW                               - blocking, no AP needed
+//   4. Wi-Fi join + web server               - background task on core 0
+//   5. pop-up/tab wiring, config to widgets  - deferred until after first frame
 void setup()
 {
+    int stage = boot_profiler_begin("core systems");
     initialize_core_systems();
+    boot_profiler_end(stage);
 
     // Add PSRAM check right here:
     Serial.printf("PSRAM size: %d bytes\n", ESP.getPsramSize());
     Serial.printf("Free PSRAM: %d bytes\n", ESP.getFreePsram());
 
+    // Subscribe before the HMI can publish so no early input is missed
+    radio_subscriber = input_bus_subscribe("radio");
+
     initialize_hmi_and_ui();
-    initialize_network_and_comms();
-    web_interface_init();
 
-    // Create our encoder-delta queue
-    encoderDeltaQueue = xQueueCreate(
-        /* length */ 16,
-        /* item size */ sizeof(int32_t));
+    stage = boot_profiler_begin("esp-now");
+    initialize_comms();
+    boot_profiler_end(stage);
 
     // Launch the loopTask on core 1 with priority 1
     xTaskCreatePinnedToCore(
@@ -100,7 +178,17 @@ void setup()
         /* handle */ nullptr,
         /* core */ 1);
 
-    Serial.println("--- Setup Complete ---");
+    // Wi-Fi and the web server join in the background on the network core
+    xTaskCreatePinnedToCore(
+        networkTask,
+        "networkTask",
+        /* stack depth */ 6 * 1024,
+        /* parameters */ nullptr,
+        /* priority */ 1,
+        /* handle */ nullptr,
+        /* core */ 0);
+
+    Serial.println("--- Setup Complete (network joining in background) ---");
 }
 
 //================================================================================
@@ -152,51 +240,72 @@ static void initialize_core_systems()
 
 static void initialize_hmi_and_ui()
 {
+    int stage = boot_profiler_begin("config load");
     load_pendant_configuration();
+    boot_profiler_end(stage);
+
+    stage = boot_profiler_begin("hmi init");
     hmi_pendant_init();
+    boot_profiler_end(stage);
+
+    stage = boot_profiler_begin("lvgl init");
     lvgl_driver_init();
+    boot_profiler_end(stage);
+
+    stage = boot_profiler_begin("main screen");
     ui_bridge_init();
-    ui_popups_init();
-    ui_tab_logic_init();
+    boot_profiler_end(stage);
 }
 
-static void initialize_network_and_comms()
+// ESP-NOW only needs the radio in STA mode, not an associated access point.
+static void initialize_comms()
 {
-    Serial.println("DEBUG: Starting WiFi setup...");
     WiFi.mode(WIFI_STA);
-    Serial.println("DEBUG: WiFi mode set to STA");
-
-    WiFi.begin(Pinout::WIFI_SSID, Pinout::WIFI_PASSWORD);
-    Serial.println("DEBUG: WiFi.begin() called");
-
-    unsigned long start = millis();
-    Serial.print("Connecting to Wi-Fi");
-    while (WiFi.status() != WL_CONNECTED &&
-           millis() - start < WIFI_CONNECT_TIMEOUT_MS)
-    {
-        Serial.println("DEBUG: In WiFi delay loop"); // ← Add this
-        delay(500);
-        Serial.print(".");
-    }
-    if (WiFi.status() == WL_CONNECTED)
-    {
-        Serial.printf("\nWi-Fi Connected. IP: %s\n",
-                      WiFi.localIP().toString().c_str());
-    }
-    else
-    {
-        Serial.println("\nWARN: Wi-Fi failed to connect.");
-    }
+    WiFi.setAutoReconnect(true);
 
     communication_esp3_init();
     communication_esp3_register_receive_callback(on_lcnc_data_received);
 }
 
+// Runs on the LVGL task right after the first frame has been flushed.
+static void deferred_ui_init(void *user_data)
+{
+    (void)user_data;
+    int stage = boot_profiler_begin("deferred ui");
+    ui_popups_init();
+    ui_tab_logic_init();
+    ui_bridge_apply_config(pendant_web_cfg);
+    boot_profiler_end(stage);
+}
+
+// Runs in the Wi-Fi task: only keeps the packet for loopTask. The override
+// engine and LVGL belong to loopTask and must not be touched from here.
 static void on_lcnc_data_received(const LcncStatusPacket &msg)
 {
-    incoming_lcnc_data = msg;
-    update_hmi_from_lcnc(msg);
-    web_interface_broadcast_status(incoming_lcnc_data);
+    taskENTER_CRITICAL(&lcnc_mux);
+    pending_lcnc_data = msg;
+    lcnc_data_pending = true;
+    taskEXIT_CRITICAL(&lcnc_mux);
+}
+
+// Applies the newest status packet, if one arrived since the last pass.
+static void handle_lcnc_data()
+{
+    bool fresh;
+    taskENTER_CRITICAL(&lcnc_mux);
+    fresh = lcnc_data_pending;
+    if (fresh)
+        incoming_lcnc_data = pending_lcnc_data;
+    lcnc_data_pending = false;
+    taskEXIT_CRITICAL(&lcnc_mux);
+    if (!fresh)
+        return;
+
+    update_hmi_from_lcnc(incoming_lcnc_data);
+    if (web_interface_ready)
+    {
+        web_interface_post_lcnc_status(incoming_lcnc_data);
+    }
 }
 
 static void handle_core_tasks()
@@ -204,31 +313,71 @@ static void handle_core_tasks()
     // No longer called every cycle—it lives in loopTask now
 }
 
+// Drains a subscriber's backlog; true if any event was pending.
+static bool input_bus_drain(int subscriber)
+{
+    InputEvent events[16];
+    bool any = false;
+    while (input_bus_read(subscriber, events, 16) > 0)
+    {
+        any = true;
+    }
+    return any;
+}
+
 static void handle_pendant_data_sending()
 {
     static unsigned long last = 0;
-    if (hmi_pendant_data_has_changed() &&
-        (millis() - last > PENDANT_SEND_INTERVAL_MS))
+    static bool pending = false;
+
+    // The packet carries full state, so the events only tell us when to send.
+    // Key and override changes skip the rate limit: the machine should react
+    // within a servo period, not after the next send slot.
+    InputEvent events[16];
+    bool priority = false;
+    size_t n;
+    while ((n = input_bus_read(radio_subscriber, events, 16)) > 0)
+    {
+        pending = true;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (events[i].type == InputEventType::KEY ||
+                events[i].type == InputEventType::FEED_OVERRIDE ||
+                events[i].type == InputEventType::RAPID_OVERRIDE ||
+                events[i].type == InputEventType::SPINDLE_OVERRIDE)
+                priority = true;
+        }
+    }
+
+    if (pending && (priority || millis() - last > PENDANT_SEND_INTERVAL_MS))
     {
         get_pendant_data(&outgoing_pendant_data);
         if (!communication_esp3_send(outgoing_pendant_data))
         {
             Serial.println("WARN: ESP-NOW send failed.");
         }
+        pending = false;
         last = millis();
     }
 }
 
-static void handle_web_status_broadcast()
+// Hands the pendant state to the web live view whenever an input changed;
+// rate limiting and encoding happen on the web side.
+static void handle_web_status_post()
 {
-    static unsigned long last = 0;
-    if (millis() - last > STATUS_BROADCAST_INTERVAL_MS)
+    static bool first = true;
+
+    // Subscribed once the server is up, so a slow Wi-Fi join can't lap us.
+    if (web_subscriber < 0)
+        web_subscriber = input_bus_subscribe("web");
+
+    if (input_bus_drain(web_subscriber) || first)
     {
         uint32_t btns;
         int32_t hw;
         uint8_t axis, step;
         get_pendant_live_status(btns, hw, axis, step);
-        web_interface_broadcast_live_pendant_status(btns, hw, axis, step);
-        last = millis();
+        web_interface_post_pendant_status(btns, hw, axis, step);
+        first = false;
     }
 }
@@ -0,0 +1,188 @@
+/**
+ * @file matrix_scan_esp3.cpp
+ * @brief Implements the register-level, timer-driven matrix scan and debounce.
+ */
+
+#include "matrix_scan_esp3.h"
+#include "config_esp3.h"
+using namespace Pinout;
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <soc/gpio_reg.h>
+
+#if PENDANT_HAS_BUTTON_MATRIX
+
+// --- Constants ---
+static constexpr size_t EDGE_QUEUE_DEPTH = 32;
+static constexpr size_t NUM_KEYS = PENDANT_MATRIX_ROWS * PENDANT_MATRIX_COLS;
+static_assert(NUM_KEYS <= 32, "Debounced state is kept in a 32-bit mask");
+
+// --- Module-static (private) variables ---
+
+// GPIO0-31 live in the first register bank, GPIO32+ in the second.
+struct PinMask
+{
+    uint32_t lo;
+    uint32_t hi;
+};
+
+static PinMask row_masks[PENDANT_MATRIX_ROWS];
+static PinMask all_rows_mask = {0, 0};
+
+struct KeyDebounce
+{
+    bool raw;
+    bool stable;
+    uint32_t changed_us;
+};
+
+static KeyDebounce keys[NUM_KEYS];
+static volatile uint32_t debounced_state = 0;
+static size_t active_row = 0;
+
+static esp_timer_handle_t scan_timer = nullptr;
+static QueueHandle_t edge_queue = nullptr;
+
+static uint32_t last_tick_us = 0;
+static volatile uint32_t max_tick_jitter_us = 0;
+static volatile uint32_t scan_count = 0;
+static volatile uint32_t dropped_edges = 0;
+
+// --- Internal helpers ---
+
+static PinMask mask_for(uint8_t pin)
+{
+    return pin < 32 ? PinMask{1u << pin, 0} : PinMask{0, 1u << (pin - 32)};
+}
+
+static inline void drive_row(size_t row)
+{
+    // Release every row, then pull the selected one low.
+    REG_WRITE(GPIO_OUT_W1TS_REG, all_rows_mask.lo);
+    REG_WRITE(GPIO_OUT1_W1TS_REG, all_rows_mask.hi);
+    REG_WRITE(GPIO_OUT_W1TC_REG, row_masks[row].lo);
+    REG_WRITE(GPIO_OUT1_W1TC_REG, row_masks[row].hi);
+}
+
+static inline bool column_low(uint8_t pin, uint32_t in_lo, uint32_t in_hi)
+{
+    return pin < 32 ? !(in_lo & (1u << pin)) : !(in_hi & (1u << (pin - 32)));
+}
+
+/**
+ * @brief One scanner tick: sample the settled row, then drive the next one.
+ */
+static void scan_tick_cb(void *arg)
+{
+    (void)arg;
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    if (last_tick_us != 0)
+    {
+        uint32_t interval = now - last_tick_us;
+        uint32_t jitter = interval > MATRIX_SCAN_TICK_US ? interval - MATRIX_SCAN_TICK_US
+                                                         : MATRIX_SCAN_TICK_US - interval;
+        if (jitter > max_tick_jitter_us)
+            max_tick_jitter_us = jitter;
+    }
+    last_tick_us = now;
+
+    uint32_t in_lo = REG_READ(GPIO_IN_REG);
+    uint32_t in_hi = REG_READ(GPIO_IN1_REG);
+
+    for (size_t c = 0; c < PENDANT_MATRIX_COLS; ++c)
+    {
+        uint8_t index = active_row * PENDANT_MATRIX_COLS + c;
+        KeyDebounce &k = keys[index];
+        bool raw = column_low(PENDANT_COL_PINS[c], in_lo, in_hi);
+
+        if (raw != k.raw)
+        {
+            k.raw = raw;
+            k.changed_us = now;
+        }
+        else if (raw != k.stable && now - k.changed_us >= MATRIX_DEBOUNCE_US)
+        {
+            k.stable = raw;
+            if (raw)
+                debounced_state |= (1u << index);
+            else
+                debounced_state &= ~(1u << index);
+
+            MatrixKeyEdge edge = {now, index, raw};
+            if (xQueueSend(edge_queue, &edge, 0) != pdTRUE)
+                dropped_edges++;
+        }
+    }
+
+    active_row = (active_row + 1) % PENDANT_MATRIX_ROWS;
+    if (active_row == 0)
+        scan_count++;
+    drive_row(active_row);
+}
+
+// --- Public API ---
+
+bool matrix_scan_init()
+{
+    for (size_t r = 0; r < PENDANT_MATRIX_ROWS; ++r)
+    {
+        pinMode(PENDANT_ROW_PINS[r], OUTPUT);
+        digitalWrite(PENDANT_ROW_PINS[r], HIGH);
+        row_masks[r] = mask_for(PENDANT_ROW_PINS[r]);
+        all_rows_mask.lo |= row_masks[r].lo;
+        all_rows_mask.hi |= row_masks[r].hi;
+    }
+    for (size_t c = 0; c < PENDANT_MATRIX_COLS; ++c)
+    {
+        pinMode(PENDANT_COL_PINS[c], INPUT_PULLUP);
+    }
+
+    edge_queue = xQueueCreate(EDGE_QUEUE_DEPTH, sizeof(MatrixKeyEdge));
+    if (!edge_queue)
+        return false;
+
+    const esp_timer_create_args_t args = {
+        .callback = &scan_tick_cb,
+        .arg = nullptr,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "matrix_scan"};
+    if (esp_timer_create(&args, &scan_timer) != ESP_OK)
+        return false;
+
+    // Drive the first row now so it has settled by the first tick.
+    active_row = 0;
+    drive_row(active_row);
+    return esp_timer_start_periodic(scan_timer, MATRIX_SCAN_TICK_US) == ESP_OK;
+}
+
+bool matrix_scan_next_edge(MatrixKeyEdge &edge)
+{
+    return edge_queue && xQueueReceive(edge_queue, &edge, 0) == pdTRUE;
+}
+
+uint32_t matrix_scan_state()
+{
+    return debounced_state;
+}
+
+void matrix_scan_get_stats(MatrixScanStats &stats)
+{
+    stats.tick_us = MATRIX_SCAN_TICK_US;
+    stats.scan_period_us = MATRIX_SCAN_TICK_US * PENDANT_MATRIX_ROWS;
+    stats.worst_latency_us = MATRIX_DEBOUNCE_US + stats.scan_period_us;
+    stats.max_tick_jitter_us = max_tick_jitter_us;
+    stats.scans = scan_count;
+    stats.dropped_edges = dropped_edges;
+}
+
+#else // !PENDANT_HAS_BUTTON_MATRIX
+
+bool matrix_scan_init() { return true; }
+bool matrix_scan_next_edge(MatrixKeyEdge &edge) { return false; }
+uint32_t matrix_scan_state() { return 0; }
+void matrix_scan_get_stats(MatrixScanStats &stats) { stats = MatrixScanStats{}; }
+
+#endif // PENDANT_HAS_BUTTON_MATRIX
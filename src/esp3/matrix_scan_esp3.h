@@ -0,0 +1,57 @@
+/**
+ * @file matrix_scan_esp3.h
+ * @brief Timer-driven button matrix scanner for the pendant.
+ *
+ * A periodic esp_timer advances a small state machine: each tick samples the
+ * columns of the row driven on the previous tick, then drives the next row and
+ * returns. Rows therefore settle for a full tick without any busy-wait, and
+ * all pin access goes straight to the GPIO registers. Debounce is time-based,
+ * so the key-to-event latency is bounded by
+ * MATRIX_DEBOUNCE_US + rows * MATRIX_SCAN_TICK_US regardless of who polls.
+ */
+
+#ifndef MATRIX_SCAN_ESP3_H
+#define MATRIX_SCAN_ESP3_H
+
+#include <stdint.h>
+
+struct MatrixKeyEdge
+{
+    uint32_t timestamp_us; // When the debounced level changed
+    uint8_t index;         // row * cols + col
+    bool pressed;
+};
+
+struct MatrixScanStats
+{
+    uint32_t tick_us;            // Nominal tick period
+    uint32_t scan_period_us;     // Time to visit every row once
+    uint32_t worst_latency_us;   // Debounce + one full scan
+    uint32_t max_tick_jitter_us; // Largest observed deviation from tick_us
+    uint32_t scans;              // Completed full-matrix scans
+    uint32_t dropped_edges;      // Edges lost to a full queue (state stays correct)
+};
+
+/**
+ * @brief Configures the row/column pins and starts the scan timer.
+ * @return false if the timer or edge queue could not be created.
+ */
+bool matrix_scan_init();
+
+/**
+ * @brief Pops the next debounced key edge, oldest first.
+ * @return false when no edge is pending.
+ */
+bool matrix_scan_next_edge(MatrixKeyEdge &edge);
+
+/**
+ * @brief Returns the debounced key states as a bitmask (bit = row * cols + col).
+ */
+uint32_t matrix_scan_state();
+
+/**
+ * @brief Copies the scanner's timing figures.
+ */
+void matrix_scan_get_stats(MatrixScanStats &stats);
+
+#endif // MATRIX_SCAN_ESP3_H
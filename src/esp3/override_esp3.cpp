@@ -0,0 +1,102 @@
+/**
+ * @file override_esp3.cpp
+ * @brief Implements detent counting, acceleration and clamping for the override knobs.
+ */
+
+#include "override_esp3.h"
+
+// --- Constants ---
+static constexpr int64_t FAST_DETENT_INTERVAL_US = 40000; // Detents closer than this use fast_step_pct
+static constexpr int64_t SYNC_HOLDOFF_US = 500000;        // Ignore LinuxCNC echoes this long after a turn
+
+// --- Module-static (private) variables ---
+struct OverrideState
+{
+    int32_t last_raw = 0;
+    int32_t pending_counts = 0; // Raw counts not yet forming a whole detent
+    int16_t percent = 100;
+    int64_t last_detent_us = 0;
+    bool lcnc_seen = false; // LinuxCNC has reported a plausible (> 0) override
+};
+
+static OverrideState channels[OVERRIDE_COUNT];
+
+static int16_t clamp_percent(OverrideChannel ch, int32_t pct)
+{
+    const OverrideLimits &lim = OVERRIDE_LIMITS[ch];
+    if (pct < lim.min_pct)
+        return lim.min_pct;
+    if (pct > lim.max_pct)
+        return lim.max_pct;
+    return (int16_t)pct;
+}
+
+// --- Public API ---
+
+void override_engine_reset(OverrideChannel ch, int32_t raw_count)
+{
+    if (ch >= OVERRIDE_COUNT)
+        return;
+    OverrideState &s = channels[ch];
+    s.last_raw = raw_count;
+    s.pending_counts = 0;
+    s.percent = clamp_percent(ch, 100);
+    s.last_detent_us = 0;
+    s.lcnc_seen = false;
+}
+
+bool override_engine_process(OverrideChannel ch, int32_t raw_count, int64_t now_us, int32_t &detents)
+{
+    detents = 0;
+    if (ch >= OVERRIDE_COUNT)
+        return false;
+
+    OverrideState &s = channels[ch];
+    const OverrideLimits &lim = OVERRIDE_LIMITS[ch];
+    int32_t delta = raw_count - s.last_raw;
+    s.last_raw = raw_count;
+    if (delta == 0)
+        return false;
+
+    // A reversal discards the half-detent collected in the other direction.
+    if ((delta > 0) != (s.pending_counts > 0) && s.pending_counts != 0)
+        s.pending_counts = 0;
+    s.pending_counts += delta;
+
+    int32_t cpd = lim.counts_per_detent ? lim.counts_per_detent : 1;
+    detents = s.pending_counts / cpd;
+    if (detents == 0)
+        return false;
+    s.pending_counts -= detents * cpd;
+
+    bool fast = s.last_detent_us != 0 && (now_us - s.last_detent_us) < FAST_DETENT_INTERVAL_US;
+    s.last_detent_us = now_us;
+
+    int16_t step = fast ? lim.fast_step_pct : lim.step_pct;
+    int16_t next = clamp_percent(ch, s.percent + detents * step);
+    if (next == s.percent)
+        return false;
+    s.percent = next;
+    return true;
+}
+
+int16_t override_engine_percent(OverrideChannel ch)
+{
+    return ch < OVERRIDE_COUNT ? channels[ch].percent : 100;
+}
+
+void override_engine_sync(OverrideChannel ch, int16_t percent, int64_t now_us)
+{
+    if (ch >= OVERRIDE_COUNT)
+        return;
+    OverrideState &s = channels[ch];
+    // An undriven pin in the OUT PDO reads 0.0; only follow LinuxCNC once it
+    // has sent a real value, later 0% included.
+    if (percent > 0)
+        s.lcnc_seen = true;
+    if (!s.lcnc_seen)
+        return;
+    if (s.last_detent_us != 0 && now_us - s.last_detent_us < SYNC_HOLDOFF_US)
+        return;
+    s.percent = clamp_percent(ch, percent);
+}
@@ -0,0 +1,70 @@
+/**
+ * @file override_esp3.h
+ * @brief Feed, rapid and spindle override knob processing for the pendant.
+ *
+ * Each knob is a detented quadrature encoder. Raw counts are grouped into
+ * whole detents, each detent moves the override by a fixed step (a larger
+ * step when the knob is spun quickly), and the result is clamped to the
+ * channel's range. Percentages are kept as integers; the radio packet carries
+ * them as a fraction (1.0 = 100%), matching LcncStatusPacket.
+ */
+
+#ifndef OVERRIDE_ESP3_H
+#define OVERRIDE_ESP3_H
+
+#include <stdint.h>
+
+enum OverrideChannel : uint8_t
+{
+    OVERRIDE_FEED,
+    OVERRIDE_RAPID,
+    OVERRIDE_SPINDLE,
+    OVERRIDE_COUNT
+};
+
+struct OverrideLimits
+{
+    int16_t min_pct;
+    int16_t max_pct;
+    int16_t step_pct;      // Per detent while turning slowly
+    int16_t fast_step_pct; // Per detent while spinning
+    uint8_t counts_per_detent;
+};
+
+static constexpr OverrideLimits OVERRIDE_LIMITS[OVERRIDE_COUNT] = {
+    {0, 200, 1, 10, 4}, // Feed
+    {0, 100, 5, 25, 4}, // Rapid
+    {50, 150, 1, 10, 4} // Spindle
+};
+
+/**
+ * @brief Resets a channel to 100% (clamped) at the given raw count.
+ */
+void override_engine_reset(OverrideChannel ch, int32_t raw_count);
+
+/**
+ * @brief Feeds the latest raw encoder count of a channel.
+ * @param ch The override channel.
+ * @param raw_count Absolute raw count from the knob's encoder.
+ * @param now_us Timestamp of the sample in microseconds.
+ * @param detents Set to the whole detents consumed by this call (signed).
+ * @return true if the override percentage changed.
+ */
+bool override_engine_process(OverrideChannel ch, int32_t raw_count, int64_t now_us, int32_t &detents);
+
+/**
+ * @brief Returns the current override of a channel in percent.
+ */
+int16_t override_engine_percent(OverrideChannel ch);
+
+/**
+ * @brief Adopts a value reported by LinuxCNC, unless the knob was turned recently.
+ *
+ * This keeps the pendant from snapping an override back after it was changed
+ * from another UI, without fighting the operator mid-turn. Values are ignored
+ * until LinuxCNC has reported one above 0, so an unconnected HAL pin (0.0)
+ * does not drag the pendant to 0% at boot.
+ */
+void override_engine_sync(OverrideChannel ch, int16_t percent, int64_t now_us);
+
+#endif // OVERRIDE_ESP3_H
@@ -1,21 +1,39 @@
 /**
  * @file persistence_esp3.cpp
  * @brief Implements loading/saving the web config + handwheel settings
- *        using ESP32 Preferences and ArduinoJson v7.
+ *        using ESP32 Preferences. The web config is stored as a binary blob;
+ *        ArduinoJson v7 is only used for the web UI's import/export path.
  */
 
 #include "persistence_esp3.h"
+#include "config_blob_esp3.h"
+#include "config_esp3.h"
 #include "ui.h"
 #include <Preferences.h>
+#include <esp_timer.h>
 #include <ArduinoJson.h>
 
 //--- Encoder config NVS keys + globals ---
 static constexpr char ENC_NS[] = "encoder";
 static constexpr char KEY_INV[] = "invert";
 static constexpr char KEY_DZ[] = "dz";
+static constexpr char KEY_HW_ACCEL[] = "hw_accel";
+static constexpr char KEY_HW_VLOW[] = "hw_vlow";
+static constexpr char KEY_HW_VHIGH[] = "hw_vhigh";
+static constexpr char KEY_HW_MAX[] = "hw_max";
+static constexpr char KEY_HW_EXP[] = "hw_exp";
+static constexpr char KEY_HW_CPD[] = "hw_cpd";
+static constexpr char KEY_HW_DETENT[] = "hw_detent";
+static constexpr char KEY_HW_AXMAX[] = "hw_axmax";
+
+static constexpr char SEL_NS[] = "selector";
+static constexpr char KEY_SEL_AXIS[] = "axis";
+static constexpr char KEY_SEL_STEP[] = "step";
 
 bool encoder_inverted = false;
 int16_t encoder_deadzone = 0;
+HandwheelConfig handwheel_cfg;
+SelectorCalibration selector_cal[SELECTOR_COUNT] = {};
 
 //--- Safe Preferences wrapper --------------------------------------------------
 bool safeBegin(Preferences &p, const char *namespaceName, bool readOnly = false)
@@ -54,6 +72,19 @@ void load_encoder_config()
     }
     encoder_inverted = p.getBool(KEY_INV, false);
     encoder_deadzone = p.getInt(KEY_DZ, 0);
+
+    const HandwheelConfig defaults;
+    handwheel_cfg.accel_enabled = p.getBool(KEY_HW_ACCEL, defaults.accel_enabled);
+    handwheel_cfg.velocity_low = p.getFloat(KEY_HW_VLOW, defaults.velocity_low);
+    handwheel_cfg.velocity_high = p.getFloat(KEY_HW_VHIGH, defaults.velocity_high);
+    handwheel_cfg.max_multiplier = p.getFloat(KEY_HW_MAX, defaults.max_multiplier);
+    handwheel_cfg.curve_exponent = p.getFloat(KEY_HW_EXP, defaults.curve_exponent);
+    handwheel_cfg.counts_per_detent = p.getUChar(KEY_HW_CPD, defaults.counts_per_detent);
+    handwheel_cfg.detent_filter = p.getBool(KEY_HW_DETENT, defaults.detent_filter);
+    if (p.getBytesLength(KEY_HW_AXMAX) == sizeof(handwheel_cfg.axis_max_multiplier))
+    {
+        p.getBytes(KEY_HW_AXMAX, handwheel_cfg.axis_max_multiplier, sizeof(handwheel_cfg.axis_max_multiplier));
+    }
     p.end();
 }
 
@@ -67,6 +98,49 @@ void save_encoder_config()
     }
     p.putBool(KEY_INV, encoder_inverted);
     p.putInt(KEY_DZ, encoder_deadzone);
+
+    p.putBool(KEY_HW_ACCEL, handwheel_cfg.accel_enabled);
+    p.putFloat(KEY_HW_VLOW, handwheel_cfg.velocity_low);
+    p.putFloat(KEY_HW_VHIGH, handwheel_cfg.velocity_high);
+    p.putFloat(KEY_HW_MAX, handwheel_cfg.max_multiplier);
+    p.putFloat(KEY_HW_EXP, handwheel_cfg.curve_exponent);
+    p.putUChar(KEY_HW_CPD, handwheel_cfg.counts_per_detent);
+    p.putBool(KEY_HW_DETENT, handwheel_cfg.detent_filter);
+    p.putBytes(KEY_HW_AXMAX, handwheel_cfg.axis_max_multiplier, sizeof(handwheel_cfg.axis_max_multiplier));
+    p.end();
+}
+
+void load_selector_calibration()
+{
+    Preferences p;
+    if (!safeBegin(p, SEL_NS, true))
+    {
+        return;
+    }
+    const char *keys[SELECTOR_COUNT] = {KEY_SEL_AXIS, KEY_SEL_STEP};
+    for (int i = 0; i < SELECTOR_COUNT; ++i)
+    {
+        // A size mismatch means an older layout; fall back to the default table.
+        if (p.getBytesLength(keys[i]) == sizeof(SelectorCalibration))
+        {
+            p.getBytes(keys[i], &selector_cal[i], sizeof(SelectorCalibration));
+        }
+    }
+    p.end();
+}
+
+void save_selector_calibration()
+{
+    Preferences p;
+    if (!safeBegin(p, SEL_NS, false))
+    {
+        Serial.println("ERROR: Could not open selector NVS for writing.");
+        return;
+    }
+    const SelectorCalibration axis = selector_calibration(SELECTOR_AXIS);
+    const SelectorCalibration step = selector_calibration(SELECTOR_STEP);
+    p.putBytes(KEY_SEL_AXIS, &axis, sizeof(SelectorCalibration));
+    p.putBytes(KEY_SEL_STEP, &step, sizeof(SelectorCalibration));
     p.end();
 }
 
@@ -93,14 +167,25 @@ namespace ARDUINOJSON_NAMESPACE
 //--- Global web config --------------------------------------------------------
 PendantWebConfig pendant_web_cfg;
 
+// pendant_web_cfg is only replaced on loopTask, which also reads it without
+// locking. The web server prepares a new config in the background and parks
+// it here; cfg_mutex guards the handoff and the web server's own reads.
+static SemaphoreHandle_t cfg_mutex = nullptr;
+static PendantWebConfig *pending_cfg = nullptr;
+
 //--- NVS constants for web config ---------------------------------------------
 static constexpr char PENDANT_PREF_NS[] = "pendant";
-static constexpr char PENDANT_PREF_KEY[] = "config";
+static constexpr char PENDANT_PREF_KEY[] = "blob";          // Binary config, see config_blob_esp3.h
+static constexpr char PENDANT_LEGACY_JSON_KEY[] = "config"; // Pre-blob firmware stored JSON here
 
 //--- Forward decls for JSON routines ------------------------------------------
-static void load_pendant_default_configuration();
+static void load_pendant_default_configuration(PendantWebConfig &cfg);
 static void deserialize_config_from_json(PendantWebConfig &cfg, const JsonDocument &doc);
-static void serialize_config_to_json(JsonDocument &doc, const PendantWebConfig &cfg);
+static bool store_config_blob(const PendantWebConfig &cfg);
+static void queue_pendant_configuration(PendantWebConfig *cfg);
+#if PERSISTENCE_BENCHMARK
+static void run_config_load_benchmark();
+#endif
 
 //================================================================================
 // PUBLIC API
@@ -108,103 +193,142 @@ static void serialize_config_to_json(JsonDocument &doc, const PendantWebConfig &
 
 void load_pendant_configuration()
 {
+    cfg_mutex = xSemaphoreCreateMutex();
+
     // 1) Load defaults into RAM
-    load_pendant_default_configuration();
+    load_pendant_default_configuration(pendant_web_cfg);
 
-    // 2) Ensure NVS has a config key, initialize if missing, then read it
+    // 2) Read the binary blob; a damaged or missing blob leaves the defaults in place
     Preferences p;
-    bool canRead = false;
-
-    // Try opening in read-write mode to potentially initialize defaults
-    if (safeBegin(p, PENDANT_PREF_NS, /*readOnly=*/false))
+    if (safeBegin(p, PENDANT_PREF_NS, /*readOnly=*/true))
     {
-        if (!p.isKey(PENDANT_PREF_KEY))
+        size_t len = p.getBytesLength(PENDANT_PREF_KEY);
+        if (len > 0)
         {
-            String defaultJson = get_pendant_config_as_json();
-            p.putString(PENDANT_PREF_KEY, defaultJson);
-            Serial.println("INFO: Initialized web config in NVS with defaults.");
-        }
-        p.end();
+            std::vector<uint8_t> blob(len);
+            p.getBytes(PENDANT_PREF_KEY, blob.data(), len);
+            p.end();
 
-        // Re-open in read-only mode for safe retrieval
-        if (safeBegin(p, PENDANT_PREF_NS, /*readOnly=*/true))
-        {
-            canRead = true;
-        }
-    }
-    else
-    {
-        // Fallback: try read-only if read-write failed
-        if (safeBegin(p, PENDANT_PREF_NS, /*readOnly=*/true))
-        {
-            canRead = true;
+            uint16_t schema = 0;
+            ConfigBlobStatus st = config_blob_decode(blob.data(), len, pendant_web_cfg, &schema);
+            if (st == ConfigBlobStatus::OK)
+            {
+                Serial.printf("INFO: Loaded web config from NVS (%u bytes, schema %u).\n",
+                              (unsigned)len, (unsigned)schema);
+                if (schema < CONFIG_BLOB_SCHEMA)
+                    store_config_blob(pendant_web_cfg); // Persist the migrated form
+            }
+            else
+            {
+                Serial.printf("ERROR: Web config in NVS rejected (%s), using defaults.\n",
+                              config_blob_status_name(st));
+            }
         }
         else
         {
-            Serial.println("WARN: Couldn't open NVS for web config.");
-        }
-    }
+            // 3) One-time import of the JSON format written by older firmware
+            String js = p.getString(PENDANT_LEGACY_JSON_KEY, "");
+            p.end();
 
-    if (canRead)
-    {
-        String js = p.getString(PENDANT_PREF_KEY, "");
-        p.end();
-
-        if (!js.isEmpty())
-        {
-            DynamicJsonDocument d(2048);
-            if (deserializeJson(d, js) == DeserializationError::Ok)
+            if (!js.isEmpty())
             {
-                deserialize_config_from_json(pendant_web_cfg, d);
-                Serial.println("INFO: Loaded web config from NVS.");
+                DynamicJsonDocument d(js.length() * 2 + 1024);
+                if (deserializeJson(d, js) == DeserializationError::Ok)
+                {
+                    deserialize_config_from_json(pendant_web_cfg, d);
+                    Serial.println("INFO: Migrated JSON web config to binary format.");
+                }
+                else
+                {
+                    Serial.println("ERROR: Bad legacy JSON in NVS, using defaults.");
+                }
             }
             else
             {
-                Serial.println("ERROR: Bad JSON in NVS.");
+                Serial.println("INFO: No web config, using defaults.");
+            }
+
+            if (store_config_blob(pendant_web_cfg) && safeBegin(p, PENDANT_PREF_NS, false))
+            {
+                p.remove(PENDANT_LEGACY_JSON_KEY);
+                p.end();
             }
         }
-        else
-        {
-            Serial.println("INFO: No web config, using defaults.");
-        }
+    }
+    else
+    {
+        Serial.println("WARN: Couldn't open NVS for web config.");
     }
 
-    // 3) Apply config to UI
+    // 4) Apply config to UI
     ui_bridge_apply_config(pendant_web_cfg);
 
-    // 4) Load encoder (handwheel) settings
+    // 5) Load encoder (handwheel) settings
     load_encoder_config();
+
+    // 6) Load selector calibration
+    load_selector_calibration();
+
+#if PERSISTENCE_BENCHMARK
+    run_config_load_benchmark();
+#endif
 }
 
 void save_pendant_configuration(const String &json_string)
 {
-    Preferences p;
-    if (safeBegin(p, PENDANT_PREF_NS, false))
+    // JSON is only the web UI's import format; NVS always holds the binary blob.
+    DynamicJsonDocument d(json_string.length() * 2 + 1024);
+    DeserializationError err = deserializeJson(d, json_string);
+    if (err)
     {
-        p.putString(PENDANT_PREF_KEY, json_string);
-        p.end();
+        Serial.printf("ERROR: Rejected web config JSON (%s).\n", err.c_str());
+        return;
     }
+
+    // Build on top of a save loopTask hasn't picked up yet, if there is one
+    xSemaphoreTake(cfg_mutex, portMAX_DELAY);
+    PendantWebConfig *incoming = new PendantWebConfig(pending_cfg ? *pending_cfg : pendant_web_cfg);
+    xSemaphoreGive(cfg_mutex);
+
+    deserialize_config_from_json(*incoming, d);
+    if (store_config_blob(*incoming))
+        queue_pendant_configuration(incoming);
     else
-    {
-        Serial.println("ERROR: Cannot save web config to NVS.");
-    }
+        delete incoming;
+}
+
+void apply_pending_pendant_configuration()
+{
+    // Don't stall the UI behind a WebSocket client streaming the config
+    if (!pending_cfg || xSemaphoreTake(cfg_mutex, 0) != pdTRUE)
+        return;
+    PendantWebConfig *next = pending_cfg; // Only cleared here, so still set
+    pending_cfg = nullptr;
+    std::swap(pendant_web_cfg, *next);
+    xSemaphoreGive(cfg_mutex);
+
+    delete next; // Now holds the previous config
+    ui_bridge_apply_config(pendant_web_cfg);
+    selector_set_positions(SELECTOR_AXIS, pendant_web_cfg.num_dro_axes);
+    Serial.println("INFO: Web config applied.");
 }
 
 String get_pendant_config_as_json()
 {
-    DynamicJsonDocument d(2048);
-    serialize_config_to_json(d, pendant_web_cfg);
     String out;
-    serializeJson(d, out);
+    StringPrint sink(out);
+    JsonStreamWriter w(sink);
+    write_pendant_config_json(w);
     return out;
 }
 
 void reset_pendant_to_defaults()
 {
-    // reset web config
-    load_pendant_default_configuration();
-    save_pendant_configuration(get_pendant_config_as_json());
-    ui_bridge_apply_config(pendant_web_cfg);
+    // reset web config; loopTask swaps it in
+    PendantWebConfig *defaults = new PendantWebConfig();
+    load_pendant_default_configuration(*defaults);
+    store_config_blob(*defaults);
+    queue_pendant_configuration(defaults);
     Serial.println("INFO: Web config reset.");
 
     // clear encoder NVS
@@ -215,38 +339,125 @@ void reset_pendant_to_defaults()
         p.end();
         Serial.println("INFO: Encoder config cleared.");
     }
+    encoder_inverted = false;
+    encoder_deadzone = 0;
+    handwheel_cfg = HandwheelConfig();
+
+    // clear selector calibration (default tables are rebuilt on next use)
+    if (safeBegin(p, SEL_NS, false))
+    {
+        p.clear();
+        p.end();
+        Serial.println("INFO: Selector calibration cleared.");
+    }
+    selector_cal[SELECTOR_AXIS].positions = 0;
+    selector_cal[SELECTOR_STEP].positions = 0;
+    selector_set_positions(SELECTOR_STEP, 4); // Axis positions follow when the config is applied
 }
 
 //================================================================================
-// INTERNAL JSON HELPERS
+// INTERNAL BLOB AND JSON HELPERS
 //================================================================================
 
-static void load_pendant_default_configuration()
+// Hands a heap config to apply_pending_pendant_configuration(); a newer one replaces it.
+static void queue_pendant_configuration(PendantWebConfig *cfg)
+{
+    xSemaphoreTake(cfg_mutex, portMAX_DELAY);
+    PendantWebConfig *stale = pending_cfg;
+    pending_cfg = cfg;
+    xSemaphoreGive(cfg_mutex);
+    delete stale;
+}
+
+static bool store_config_blob(const PendantWebConfig &cfg)
+{
+    std::vector<uint8_t> blob;
+    config_blob_encode(cfg, blob);
+
+    Preferences p;
+    if (!safeBegin(p, PENDANT_PREF_NS, false))
+    {
+        Serial.println("ERROR: Cannot save web config to NVS.");
+        return false;
+    }
+    size_t written = p.putBytes(PENDANT_PREF_KEY, blob.data(), blob.size());
+    p.end();
+
+    if (written != blob.size())
+    {
+        Serial.printf("ERROR: Web config write failed (%u of %u bytes).\n",
+                      (unsigned)written, (unsigned)blob.size());
+        return false;
+    }
+    return true;
+}
+
+#if PERSISTENCE_BENCHMARK
+/**
+ * @brief Times decoding the current config from the binary blob against the JSON path.
+ *
+ * Both formats are produced from the same in-RAM config, so the numbers
+ * compare like with like. NVS read time is excluded; it is the same order
+ * for both and depends mostly on size.
+ */
+static void run_config_load_benchmark()
+{
+    constexpr int ROUNDS = 50;
+
+    std::vector<uint8_t> blob;
+    config_blob_encode(pendant_web_cfg, blob);
+    String json = get_pendant_config_as_json();
+
+    PendantWebConfig scratch;
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < ROUNDS; ++i)
+    {
+        config_blob_decode(blob.data(), blob.size(), scratch);
+    }
+    int64_t blob_us = esp_timer_get_time() - t0;
+
+    t0 = esp_timer_get_time();
+    for (int i = 0; i < ROUNDS; ++i)
+    {
+        DynamicJsonDocument d(json.length() * 2 + 1024);
+        deserializeJson(d, json);
+        scratch = {};
+        deserialize_config_from_json(scratch, d);
+    }
+    int64_t json_us = esp_timer_get_time() - t0;
+
+    Serial.printf("BENCH config load: blob %u B %.1f us, json %u B %.1f us (avg of %d)\n",
+                  (unsigned)blob.size(), (double)blob_us / ROUNDS,
+                  (unsigned)json.length(), (double)json_us / ROUNDS, ROUNDS);
+}
+#endif
+
+static void load_pendant_default_configuration(PendantWebConfig &cfg)
 {
     // Clear any existing configuration
-    pendant_web_cfg = {};
+    cfg = {};
 
     // Basic fields
-    pendant_web_cfg.num_dro_axes = 3;
-    pendant_web_cfg.handwheel_enable_button = 0; // Example: first button
+    cfg.num_dro_axes = 3;
+    cfg.handwheel_enable_button = 0; // Example: first button
 
     // Axis labels
-    pendant_web_cfg.axis_labels = {"X", "Y", "Z"};
+    cfg.axis_labels = {"X", "Y", "Z"};
 
     // Button bindings
-    pendant_web_cfg.button_bindings = {
+    cfg.button_bindings = {
         {0, "Cycle Start", BindingType::BOUND_TO_LCNC, 101},
         {1, "Feed Hold", BindingType::BOUND_TO_LCNC, 102},
         {2, "Coolant Toggle", BindingType::BOUND_TO_BUTTON, 200}};
 
     // LED bindings
-    pendant_web_cfg.led_bindings = {
+    cfg.led_bindings = {
         {0, "Spindle On", LedBindingType::LED_BOUND_TO_MATRIX, 0, 0, 0},
         {1, "Feed Override", LedBindingType::LED_BOUND_TO_MATRIX, 0, 1, 1},
         {2, "Coolant", LedBindingType::LED_BOUND_TO_BUTTON, 1, 0, 2}};
 
     // Macros
-    pendant_web_cfg.macros = {
+    cfg.macros = {
         {"M8 Coolant On", {"M8"}, 300},
         {"M9 Coolant Off", {"M9"}, 301}};
 
@@ -310,46 +521,65 @@ static void deserialize_config_from_json(PendantWebConfig &cfg,
     }
 }
 
-static void serialize_config_to_json(JsonDocument &doc,
-                                     const PendantWebConfig &cfg)
+void write_pendant_config_json(JsonStreamWriter &w)
 {
-    doc["num_dro_axes"] = cfg.num_dro_axes;
-    doc["handwheel_enable_button"] = cfg.handwheel_enable_button;
+    // Called from the web server; loopTask may be swapping the config in
+    xSemaphoreTake(cfg_mutex, portMAX_DELAY);
+    const PendantWebConfig &cfg = pendant_web_cfg;
+
+    w.begin_object();
+    w.field("num_dro_axes", cfg.num_dro_axes);
+    w.field("handwheel_enable_button", cfg.handwheel_enable_button);
 
-    auto arr1 = doc["axis_labels"].to<JsonArray>();
+    w.key("axis_labels");
+    w.begin_array();
     for (auto &s : cfg.axis_labels)
-        arr1.add(s);
+        w.value(s);
+    w.end_array();
 
-    auto arr2 = doc["button_bindings"].to<JsonArray>();
+    w.key("button_bindings");
+    w.begin_array();
     for (auto &b : cfg.button_bindings)
     {
-        JsonObject o = arr2.createNestedObject();
-        o["button_index"] = b.button_index;
-        o["action_name"] = b.action_name;
-        o["type"] = b.type;
-        o["lcnc_action_code"] = b.lcnc_action_code;
+        w.begin_object();
+        w.field("button_index", b.button_index);
+        w.field("action_name", b.action_name);
+        w.field("type", (int)b.type);
+        w.field("lcnc_action_code", b.lcnc_action_code);
+        w.end_object();
     }
+    w.end_array();
 
-    auto arr3 = doc["led_bindings"].to<JsonArray>();
+    w.key("led_bindings");
+    w.begin_array();
     for (auto &l : cfg.led_bindings)
     {
-        JsonObject o = arr3.createNestedObject();
-        o["led_index"] = l.led_index;
-        o["signal_name"] = l.signal_name;
-        o["type"] = l.type;
-        o["matrix_index"] = l.matrix_index;
-        o["bit_index"] = l.bit_index;
-        o["button_index"] = l.button_index;
+        w.begin_object();
+        w.field("led_index", l.led_index);
+        w.field("signal_name", l.signal_name);
+        w.field("type", (int)l.type);
+        w.field("matrix_index", l.matrix_index);
+        w.field("bit_index", l.bit_index);
+        w.field("button_index", l.button_index);
+        w.end_object();
     }
+    w.end_array();
 
-    auto arr4 = doc["macros"].to<JsonArray>();
+    w.key("macros");
+    w.begin_array();
     for (auto &m : cfg.macros)
     {
-        JsonObject o = arr4.createNestedObject();
-        o["name"] = m.name;
-        o["action_code"] = m.action_code;
-        auto ca = o["commands"].to<JsonArray>();
+        w.begin_object();
+        w.field("name", m.name);
+        w.field("action_code", m.action_code);
+        w.key("commands");
+        w.begin_array();
         for (auto &c : m.commands)
-            ca.add(c);
+            w.value(c);
+        w.end_array();
+        w.end_object();
     }
+    w.end_array();
+    w.end_object();
+    xSemaphoreGive(cfg_mutex);
 }
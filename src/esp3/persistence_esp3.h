@@ -2,13 +2,17 @@
  * @file persistence_esp3.h
  * @brief Public interface for loading and saving the pendant's configuration.
  *
- * This module handles the serialization of the configuration object to and from
- * the ESP32's non-volatile storage (NVS) using JSON.
+ * This module stores the configuration object in the ESP32's non-volatile
+ * storage (NVS) as a versioned binary blob (see config_blob_esp3.h). JSON is
+ * only used to exchange the configuration with the web UI.
  */
 
 #pragma once
 
 #include "shared_structures.h"
+#include "handwheel_esp3.h"
+#include "selector_esp3.h"
+#include "json_stream.h"
 #include <Arduino.h> // For the String class
 
 #ifdef __cplusplus
@@ -27,6 +31,10 @@ extern "C"
     // Handwheel (encoder) configuration
     extern bool encoder_inverted;
     extern int16_t encoder_deadzone;
+    extern HandwheelConfig handwheel_cfg; // Acceleration curve, detent filter, per-axis limits
+
+    // Axis/step selector detent calibration
+    extern SelectorCalibration selector_cal[SELECTOR_COUNT];
 
     /**
      * @brief Loads the configuration from NVS into the global `pendant_web_cfg` object.
@@ -36,7 +44,11 @@ extern "C"
     void load_pendant_configuration();
 
     /**
-     * @brief Saves a configuration from a JSON string into NVS.
+     * @brief Imports a configuration from the web UI's JSON and saves it to NVS.
+     *
+     * On success the new config is queued for loopTask, which replaces
+     * `pendant_web_cfg` in apply_pending_pendant_configuration(); on a parse
+     * or NVS error both are left unchanged. Safe to call from the web server.
      * @param json_string A string containing the configuration in JSON format.
      */
     void save_pendant_configuration(const String &json_string);
@@ -49,15 +61,29 @@ extern "C"
 
     /**
      * @brief Resets the configuration to factory defaults and saves them to NVS.
+     *
+     * Like save_pendant_configuration(), the defaults take effect on loopTask.
      */
     void reset_pendant_to_defaults();
 
+    /**
+     * @brief Swaps in a config queued by the web server and applies it to the UI.
+     *
+     * Must run on loopTask, the only task that replaces `pendant_web_cfg` or
+     * touches LVGL. Cheap when nothing is queued.
+     */
+    void apply_pending_pendant_configuration();
+
     void update_hmi_from_config();
 
     // Load/save encoder settings
     void load_encoder_config();
     void save_encoder_config();
 
+    // Load/save selector calibration tables
+    void load_selector_calibration();
+    void save_selector_calibration();
+
     /**
      * @brief A stub function for a factory test routine.
      */
@@ -65,4 +91,14 @@ extern "C"
 
 #ifdef __cplusplus
 }
+#endif
+
+#ifdef __cplusplus
+/**
+ * @brief Streams the current `pendant_web_cfg` as one JSON object into a writer.
+ *
+ * Used by get_pendant_config_as_json() and to send the config to WebSocket
+ * clients without building an intermediate document.
+ */
+void write_pendant_config_json(JsonStreamWriter &w);
 #endif
\ No newline at end of file
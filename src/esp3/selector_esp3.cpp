@@ -0,0 +1,262 @@
+/**
+ * @file selector_esp3.cpp
+ * @brief Implements DMA sampling, calibration lookup, hysteresis and stable-time
+ *        confirmation for the pendant selectors.
+ */
+
+#include "selector_esp3.h"
+#include "config_esp3.h"
+#include "persistence_esp3.h"
+using namespace Pinout;
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// --- Constants ---
+static constexpr uint32_t SAMPLE_FREQ_HZ = 20000;    // Shared by both channels
+static constexpr uint32_t FRAME_BYTES = 256;         // One DMA frame handed to the task
+static constexpr uint32_t OVERSAMPLE = 64;           // Samples averaged per decision
+static constexpr uint32_t SELECTOR_STABLE_MS = 30;   // Candidate must hold this long
+static constexpr uint32_t HYSTERESIS_PERMILLE = 150; // Share of half a detent gap kept as dead band
+static constexpr uint16_t ADC_FULL_SCALE = 4095;
+
+// --- Module-static (private) variables ---
+struct SelectorState
+{
+    uint8_t pin;
+    uint8_t channel;
+    uint32_t sum;
+    uint32_t count;
+    volatile uint16_t raw;
+    volatile uint8_t position;
+    uint8_t candidate;
+    uint32_t candidate_since_ms;
+};
+
+static SelectorState selectors[SELECTOR_COUNT] = {
+    {AXIS_SELECTOR_ADC, 0, 0, 0, 0, 0, 0, 0},
+    {STEP_SELECTOR_ADC, 0, 0, 0, 0, 0, 0, 0}};
+
+static portMUX_TYPE table_mux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t selector_task_handle = nullptr;
+
+// --- Internal helpers ---
+
+static void fill_default_table(SelectorCalibration &cal, uint8_t positions)
+{
+    cal.positions = positions;
+    cal.calibrated_mask = 0;
+    for (uint8_t i = 0; i < positions; ++i)
+    {
+        // Centre of each equal-width band, as the old raw * n / 4096 mapping implied.
+        cal.center[i] = (uint16_t)(((2u * i + 1u) * (ADC_FULL_SCALE + 1u)) / (2u * positions));
+    }
+}
+
+/**
+ * @brief Half the distance from a detent's centre to its nearest neighbour.
+ */
+static uint16_t half_gap(const SelectorCalibration &cal, uint8_t pos)
+{
+    // Captured tables need not be monotonic, so compare against every detent.
+    int gap = ADC_FULL_SCALE;
+    for (uint8_t i = 0; i < cal.positions; ++i)
+    {
+        int d = abs((int)cal.center[pos] - (int)cal.center[i]);
+        if (i != pos && d < gap)
+            gap = d;
+    }
+    return (uint16_t)(gap / 2);
+}
+
+/**
+ * @brief Runs one oversampled reading through lookup, hysteresis and stable time.
+ */
+static void decode(SelectorId id, uint16_t raw, uint32_t now_ms)
+{
+    SelectorState &s = selectors[id];
+    s.raw = raw;
+
+    SelectorCalibration cal;
+    portENTER_CRITICAL(&table_mux);
+    cal = selector_cal[id];
+    portEXIT_CRITICAL(&table_mux);
+    if (cal.positions < 2)
+        return;
+
+    uint8_t nearest = 0;
+    uint16_t best = UINT16_MAX;
+    for (uint8_t i = 0; i < cal.positions; ++i)
+    {
+        uint16_t d = abs((int)raw - (int)cal.center[i]);
+        if (d < best)
+        {
+            best = d;
+            nearest = i;
+        }
+    }
+
+    // Only accept a reading that is clearly inside a detent's band; anything in
+    // the dead band between two detents keeps the current candidate.
+    uint16_t hg = half_gap(cal, nearest);
+    if (best > hg - (hg * HYSTERESIS_PERMILLE) / 1000)
+        return;
+
+    if (nearest != s.candidate)
+    {
+        s.candidate = nearest;
+        s.candidate_since_ms = now_ms;
+        return;
+    }
+    if (s.candidate != s.position && now_ms - s.candidate_since_ms >= SELECTOR_STABLE_MS)
+    {
+        s.position = s.candidate;
+    }
+}
+
+static void selector_task(void *arg)
+{
+    (void)arg;
+    uint8_t frame[FRAME_BYTES];
+    while (true)
+    {
+        uint32_t len = 0;
+        esp_err_t err = adc_digi_read_bytes(frame, FRAME_BYTES, &len, ADC_MAX_DELAY);
+        // ESP_ERR_INVALID_STATE means the driver overwrote old frames; the data is still valid.
+        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE)
+            continue;
+
+        uint32_t now_ms = millis();
+        for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len; i += SOC_ADC_DIGI_RESULT_BYTES)
+        {
+            const adc_digi_output_data_t *d = (const adc_digi_output_data_t *)&frame[i];
+            for (int id = 0; id < SELECTOR_COUNT; ++id)
+            {
+                SelectorState &s = selectors[id];
+                if (d->type2.unit != 0 || d->type2.channel != s.channel)
+                    continue;
+                s.sum += d->type2.data;
+                if (++s.count == OVERSAMPLE)
+                {
+                    decode((SelectorId)id, (uint16_t)(s.sum / OVERSAMPLE), now_ms);
+                    s.sum = 0;
+                    s.count = 0;
+                }
+            }
+        }
+    }
+}
+
+// --- Public API ---
+
+bool selector_init()
+{
+    adc_digi_pattern_config_t pattern[SELECTOR_COUNT] = {};
+    uint32_t mask = 0;
+    for (int id = 0; id < SELECTOR_COUNT; ++id)
+    {
+        int8_t ch = digitalPinToAnalogChannel(selectors[id].pin);
+        if (ch < 0 || ch >= SOC_ADC_CHANNEL_NUM(0))
+        {
+            Serial.printf("ERROR: Selector GPIO %u is not on ADC1.\n", selectors[id].pin);
+            return false;
+        }
+        selectors[id].channel = (uint8_t)ch;
+        mask |= BIT(ch);
+
+        pattern[id].atten = ADC_ATTEN_DB_11;
+        pattern[id].channel = ch;
+        pattern[id].unit = 0; // ADC1
+        pattern[id].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+        if (selector_cal[id].positions < 2)
+            fill_default_table(selector_cal[id], id == SELECTOR_STEP ? 4 : 3);
+    }
+
+    adc_digi_init_config_t init_cfg = {};
+    init_cfg.max_store_buf_size = 4 * FRAME_BYTES;
+    init_cfg.conv_num_each_intr = FRAME_BYTES;
+    init_cfg.adc1_chan_mask = mask;
+    init_cfg.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&init_cfg) != ESP_OK)
+        return false;
+
+    adc_digi_configuration_t dig_cfg = {};
+    dig_cfg.conv_limit_en = ADC_CONV_LIMIT_EN;
+    dig_cfg.conv_limit_num = 250;
+    dig_cfg.pattern_num = SELECTOR_COUNT;
+    dig_cfg.adc_pattern = pattern;
+    dig_cfg.sample_freq_hz = SAMPLE_FREQ_HZ;
+    dig_cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    dig_cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    if (adc_digi_controller_configure(&dig_cfg) != ESP_OK)
+    {
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    if (xTaskCreatePinnedToCore(selector_task, "selectorTask", 3 * 1024, nullptr,
+                                /* priority */ 2, &selector_task_handle, /* core */ 0) != pdPASS)
+    {
+        adc_digi_deinitialize();
+        return false;
+    }
+    return adc_digi_start() == ESP_OK;
+}
+
+void selector_set_positions(SelectorId sel, uint8_t positions)
+{
+    if (sel >= SELECTOR_COUNT || positions < 2 || positions > SELECTOR_MAX_POSITIONS)
+        return;
+
+    portENTER_CRITICAL(&table_mux);
+    SelectorCalibration &cal = selector_cal[sel];
+    if (cal.positions != positions)
+    {
+        fill_default_table(cal, positions);
+        if (selectors[sel].position >= positions)
+            selectors[sel].position = positions - 1;
+    }
+    portEXIT_CRITICAL(&table_mux);
+}
+
+uint8_t selector_position(SelectorId sel)
+{
+    return sel < SELECTOR_COUNT ? selectors[sel].position : 0;
+}
+
+uint16_t selector_raw(SelectorId sel)
+{
+    return sel < SELECTOR_COUNT ? selectors[sel].raw : 0;
+}
+
+SelectorCalibration selector_calibration(SelectorId sel)
+{
+    SelectorCalibration cal = {};
+    if (sel >= SELECTOR_COUNT)
+        return cal;
+    portENTER_CRITICAL(&table_mux);
+    cal = selector_cal[sel];
+    portEXIT_CRITICAL(&table_mux);
+    return cal;
+}
+
+bool selector_capture_position(SelectorId sel, uint8_t position)
+{
+    if (sel >= SELECTOR_COUNT)
+        return false;
+
+    bool ok = false;
+    portENTER_CRITICAL(&table_mux);
+    SelectorCalibration &cal = selector_cal[sel];
+    if (position < cal.positions)
+    {
+        cal.center[position] = selectors[sel].raw;
+        cal.calibrated_mask |= (1u << position);
+        ok = true;
+    }
+    portEXIT_CRITICAL(&table_mux);
+    return ok;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file selector_esp3.h
+ * @brief Axis and step selector decoding on top of the ADC continuous (DMA) driver.
+ *
+ * Both resistor-ladder selectors are sampled by the ADC in continuous mode.
+ * A reader task oversamples each channel, maps the average onto a per-detent
+ * calibration table and only confirms a new position once the reading sits
+ * inside that detent's hysteresis band for SELECTOR_STABLE_MS. Noise near a
+ * boundary therefore never reaches the jog logic.
+ */
+
+#ifndef SELECTOR_ESP3_H
+#define SELECTOR_ESP3_H
+
+#include <stdint.h>
+
+static constexpr uint8_t SELECTOR_MAX_POSITIONS = 8;
+
+enum SelectorId : uint8_t
+{
+    SELECTOR_AXIS,
+    SELECTOR_STEP,
+    SELECTOR_COUNT
+};
+
+/**
+ * @brief Raw ADC reading at the centre of each detent, persisted by persistence_esp3.
+ *
+ * When the position count changes the table is reset to evenly spaced
+ * centres, since captured centres no longer describe the hardware.
+ */
+struct SelectorCalibration
+{
+    uint16_t center[SELECTOR_MAX_POSITIONS];
+    uint8_t positions;
+    uint8_t calibrated_mask; // Bit n set: center[n] was captured from the hardware
+};
+
+/**
+ * @brief Starts the ADC in continuous mode and launches the decoder task.
+ * @return false if the ADC driver could not be configured.
+ */
+bool selector_init();
+
+/**
+ * @brief Sets how many detents a selector has (e.g. after num_dro_axes changed).
+ */
+void selector_set_positions(SelectorId sel, uint8_t positions);
+
+/**
+ * @brief Returns the last confirmed position of a selector.
+ */
+uint8_t selector_position(SelectorId sel);
+
+/**
+ * @brief Returns the latest oversampled raw reading (0-4095) of a selector.
+ */
+uint16_t selector_raw(SelectorId sel);
+
+/**
+ * @brief Returns a consistent copy of a selector's calibration table.
+ *
+ * The decoder task and the capture path change the table under a lock;
+ * readers outside this module must go through this copy.
+ */
+SelectorCalibration selector_calibration(SelectorId sel);
+
+/**
+ * @brief Stores the current raw reading as the centre of a detent.
+ *
+ * The caller is responsible for persisting the table afterwards.
+ *
+ * @return false if the position is out of range.
+ */
+bool selector_capture_position(SelectorId sel, uint8_t position);
+
+#endif // SELECTOR_ESP3_H
@@ -4,9 +4,24 @@
  */
 
 #include "ui.h"
+#include "ui_lazy.h"
 #include "ui/ui.h"      // The main header from your EEZ Studio export
 #include "ui/screens.h" // Gives access to the global `objects` struct
 #include <cstdio>       // For snprintf
+#include <string>
+
+// Roller options from the last applied config, kept so a lazily built
+// Macros tab can be populated when it is first opened.
+static std::string macro_roller_options;
+
+static void apply_macros_on_build(ui_lazy_part_t part)
+{
+    (void)part;
+    if (objects.macros_roller && !macro_roller_options.empty())
+    {
+        lv_roller_set_options(objects.macros_roller, macro_roller_options.c_str(), LV_ROLLER_MODE_NORMAL);
+    }
+}
 
 // This function is defined in the EEZ-generated ui.c
 // Our bridge simply wraps it.
@@ -17,8 +32,10 @@ extern void ui_init();
 void ui_bridge_init()
 {
     // Call the initializer from the code generated by EEZ Studio.
-    // This creates all the screens, widgets, etc.
+    // This creates the main screen; tabs and pop-ups are built on first use.
     ::ui_init();
+    ui_lazy_init();
+    ui_lazy_on_build(UI_PART_MACRO_TAB, apply_macros_on_build);
 }
 
 void ui_bridge_update_from_lcnc(const LcncStatusPacket &data)
@@ -40,19 +57,8 @@ void ui_bridge_update_from_lcnc(const LcncStatusPacket &data)
         lv_label_set_text_fmt(objects.main_label_cut_value, "%.0f m/min", data.cutting_speed);
     }
 
-    // Update Overrides Bar
-    if (objects.main_label_feed_override_value)
-    {
-        lv_label_set_text_fmt(objects.main_label_feed_override_value, "%.0f%%", data.feed_override * 100);
-    }
-    if (objects.main_label_rapids_feed_override_value)
-    {
-        lv_label_set_text_fmt(objects.main_label_rapids_feed_override_value, "%.0f%%", data.rapid_override * 100);
-    }
-    if (objects.main_label_spindle_feed_override_value)
-    {
-        lv_label_set_text_fmt(objects.main_label_spindle_feed_override_value, "%.0f%%", data.spindle_override * 100);
-    }
+    // The overrides bar belongs to ui_popups_set_override(): it also shows
+    // knob turns that LinuxCNC has not confirmed yet.
 
     // Update DRO Positions
     lv_obj_t *dro_value_labels[] = {
@@ -108,20 +114,18 @@ void ui_bridge_update_jog_selectors(uint8_t active_axis, uint8_t selected_step)
 
 void ui_bridge_apply_config(const PendantWebConfig &cfg)
 {
-    // Update the Macros roller from the web configuration
-    if (objects.macros_roller)
+    // Update the Macros roller from the web configuration. If the Macros tab
+    // has not been built yet, the options are applied when it is.
+    macro_roller_options.clear();
+    for (size_t i = 0; i < cfg.macros.size(); ++i)
     {
-        std::string roller_options;
-        for (size_t i = 0; i < cfg.macros.size(); ++i)
+        macro_roller_options += cfg.macros[i].name;
+        if (i < cfg.macros.size() - 1)
         {
-            roller_options += cfg.macros[i].name;
-            if (i < cfg.macros.size() - 1)
-            {
-                roller_options += "\n";
-            }
+            macro_roller_options += "\n";
         }
-        lv_roller_set_options(objects.macros_roller, roller_options.c_str(), LV_ROLLER_MODE_NORMAL);
     }
+    apply_macros_on_build(UI_PART_MACRO_TAB);
 
     // (Future) Update DRO axis labels, units, etc., from the config
     // For example: lv_label_set_text(objects.main_label_axis_x, cfg.axis_labels[0].c_str());
@@ -669,156 +669,173 @@ void create_screen_main()
                     objects.macro_tab = obj;
                     lv_obj_add_event_cb(obj, action_set_global_eez_event, LV_EVENT_PRESSING, (void *)0);
                     lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
-                    {
-                        lv_obj_t *parent_obj = obj;
-                        {
-                            // MacrosRoller
-                            lv_obj_t *obj = lv_roller_create(parent_obj);
-                            objects.macros_roller = obj;
-                            lv_obj_set_pos(obj, -16, -16);
-                            lv_obj_set_size(obj, 240, 143);
-                            lv_roller_set_options(obj, "Macro 1: Tool Change\nMacro 2: Probe Z-Axis\nMacro 3: Go to Park Position\nMacro 4: Center on Fixture\nMacro 5: Warm-up Spindle \nMacro 6: ....", LV_ROLLER_MODE_NORMAL);
-                            lv_roller_set_selected(obj, 3, LV_ANIM_OFF);
-                            lv_obj_set_style_text_align(obj, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
-                            lv_obj_set_style_text_font(obj, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
-                            lv_obj_set_style_radius(obj, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-                            lv_obj_set_style_bg_color(obj, lv_color_hex(0xff15171a), LV_PART_MAIN | LV_STATE_DEFAULT);
-                        }
-                        {
-                            // MacrosGcode
-                            lv_obj_t *obj = lv_textarea_create(parent_obj);
-                            objects.macros_gcode = obj;
-                            lv_obj_set_pos(obj, 224, -16);
-                            lv_obj_set_size(obj, 240, 143);
-                            lv_textarea_set_max_length(obj, 128);
-                            lv_textarea_set_text(obj, "G91 G28 Z0\nG90\nM6 T[Current_Tool+1]\n...");
-                            lv_textarea_set_one_line(obj, false);
-                            lv_textarea_set_password_mode(obj, false);
-                            lv_obj_set_style_radius(obj, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
-                            lv_obj_set_style_bg_color(obj, lv_color_hex(0xff15171a), LV_PART_MAIN | LV_STATE_DEFAULT);
-                        }
-                    }
+                    // MacrosRoller and MacrosGcode are built on first use by
+                    // create_macro_tab_content() (see ui_lazy.c).
                 }
             }
         }
+        // WindowFeedOverride, RapidsFeedOverride and SpindleFeedOverride are built
+        // on first use by their create_*() functions (see ui_lazy.c).
+    }
+
+    tick_screen_main();
+}
+
+void tick_screen_main()
+{
+}
+
+void create_macro_tab_content(lv_obj_t *parent_obj)
+{
+    {
+        // MacrosRoller
+        lv_obj_t *obj = lv_roller_create(parent_obj);
+        objects.macros_roller = obj;
+        lv_obj_set_pos(obj, -16, -16);
+        lv_obj_set_size(obj, 240, 143);
+        lv_roller_set_options(obj, "Macro 1: Tool Change\nMacro 2: Probe Z-Axis\nMacro 3: Go to Park Position\nMacro 4: Center on Fixture\nMacro 5: Warm-up Spindle \nMacro 6: ....", LV_ROLLER_MODE_NORMAL);
+        lv_roller_set_selected(obj, 3, LV_ANIM_OFF);
+        lv_obj_set_style_text_align(obj, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_text_font(obj, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_radius(obj, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_color(obj, lv_color_hex(0xff15171a), LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+    {
+        // MacrosGcode
+        lv_obj_t *obj = lv_textarea_create(parent_obj);
+        objects.macros_gcode = obj;
+        lv_obj_set_pos(obj, 224, -16);
+        lv_obj_set_size(obj, 240, 143);
+        lv_textarea_set_max_length(obj, 128);
+        lv_textarea_set_text(obj, "G91 G28 Z0\nG90\nM6 T[Current_Tool+1]\n...");
+        lv_textarea_set_one_line(obj, false);
+        lv_textarea_set_password_mode(obj, false);
+        lv_obj_set_style_radius(obj, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_color(obj, lv_color_hex(0xff15171a), LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+}
+
+void create_window_feed_override(lv_obj_t *parent_obj)
+{
+    {
+        // WindowFeedOverride
+        lv_obj_t *obj = lv_win_create(parent_obj);
+        objects.window_feed_override = obj;
+        lv_obj_set_pos(obj, 36, 12);
+        lv_obj_set_size(obj, 169, 232);
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_add_state(obj, LV_STATE_DISABLED);
+        lv_obj_set_style_bg_opa(obj, 220, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_color(obj, lv_color_hex(0xff0d0d0d), LV_PART_MAIN | LV_STATE_DEFAULT);
         {
-            // WindowFeedOverride
-            lv_obj_t *obj = lv_win_create(parent_obj);
-            objects.window_feed_override = obj;
-            lv_obj_set_pos(obj, 36, 12);
-            lv_obj_set_size(obj, 169, 232);
-            lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
-            lv_obj_add_state(obj, LV_STATE_DISABLED);
-            lv_obj_set_style_bg_opa(obj, 220, LV_PART_MAIN | LV_STATE_DEFAULT);
-            lv_obj_set_style_bg_color(obj, lv_color_hex(0xff0d0d0d), LV_PART_MAIN | LV_STATE_DEFAULT);
+            lv_obj_t *parent_obj = obj;
             {
-                lv_obj_t *parent_obj = obj;
-                {
-                    // ArcFeedOverride
-                    lv_obj_t *obj = lv_arc_create(parent_obj);
-                    objects.arc_feed_override = obj;
-                    lv_obj_set_pos(obj, 10, 0);
-                    lv_obj_set_size(obj, 160, 181);
-                    lv_arc_set_range(obj, 50, 150);
-                    lv_arc_set_value(obj, 100);
-                    lv_obj_set_style_arc_width(obj, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+                // ArcFeedOverride
+                lv_obj_t *obj = lv_arc_create(parent_obj);
+                objects.arc_feed_override = obj;
+                lv_obj_set_pos(obj, 10, 0);
+                lv_obj_set_size(obj, 160, 181);
+                lv_arc_set_range(obj, 50, 150);
+                lv_arc_set_value(obj, 100);
+                lv_obj_set_style_arc_width(obj, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+                {
+                    lv_obj_t *parent_obj = obj;
                     {
-                        lv_obj_t *parent_obj = obj;
-                        {
-                            // ArcFeedOverrideLabel
-                            lv_obj_t *obj = lv_label_create(parent_obj);
-                            objects.arc_feed_override_label = obj;
-                            lv_obj_set_pos(obj, 42, 66);
-                            lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
-                            lv_obj_set_style_text_font(obj, &lv_font_montserrat_30, LV_PART_MAIN | LV_STATE_DEFAULT);
-                            lv_label_set_text(obj, "100%");
-                        }
+                        // ArcFeedOverrideLabel
+                        lv_obj_t *obj = lv_label_create(parent_obj);
+                        objects.arc_feed_override_label = obj;
+                        lv_obj_set_pos(obj, 42, 66);
+                        lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+                        lv_obj_set_style_text_font(obj, &lv_font_montserrat_30, LV_PART_MAIN | LV_STATE_DEFAULT);
+                        lv_label_set_text(obj, "100%");
                     }
                 }
             }
         }
+    }
+}
+
+void create_rapids_feed_override(lv_obj_t *parent_obj)
+{
+    {
+        // RapidsFeedOverride
+        lv_obj_t *obj = lv_win_create(parent_obj);
+        objects.rapids_feed_override = obj;
+        lv_obj_set_pos(obj, 157, 12);
+        lv_obj_set_size(obj, 169, 232);
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_add_state(obj, LV_STATE_DISABLED);
+        lv_obj_set_style_bg_opa(obj, 220, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_color(obj, lv_color_hex(0xff0d0d0d), LV_PART_MAIN | LV_STATE_DEFAULT);
         {
-            // RapidsFeedOverride
-            lv_obj_t *obj = lv_win_create(parent_obj);
-            objects.rapids_feed_override = obj;
-            lv_obj_set_pos(obj, 157, 12);
-            lv_obj_set_size(obj, 169, 232);
-            lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
-            lv_obj_add_state(obj, LV_STATE_DISABLED);
-            lv_obj_set_style_bg_opa(obj, 220, LV_PART_MAIN | LV_STATE_DEFAULT);
-            lv_obj_set_style_bg_color(obj, lv_color_hex(0xff0d0d0d), LV_PART_MAIN | LV_STATE_DEFAULT);
+            lv_obj_t *parent_obj = obj;
             {
-                lv_obj_t *parent_obj = obj;
-                {
-                    // ArcRapidsOverride_1
-                    lv_obj_t *obj = lv_arc_create(parent_obj);
-                    objects.arc_rapids_override_1 = obj;
-                    lv_obj_set_pos(obj, 10, 0);
-                    lv_obj_set_size(obj, 160, 181);
-                    lv_arc_set_range(obj, 50, 150);
-                    lv_arc_set_value(obj, 100);
-                    lv_obj_set_style_arc_width(obj, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+                // ArcRapidsOverride_1
+                lv_obj_t *obj = lv_arc_create(parent_obj);
+                objects.arc_rapids_override_1 = obj;
+                lv_obj_set_pos(obj, 10, 0);
+                lv_obj_set_size(obj, 160, 181);
+                lv_arc_set_range(obj, 50, 150);
+                lv_arc_set_value(obj, 100);
+                lv_obj_set_style_arc_width(obj, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+                {
+                    lv_obj_t *parent_obj = obj;
                     {
-                        lv_obj_t *parent_obj = obj;
-                        {
-                            // ArcRapidsOverrideLabel_1
-                            lv_obj_t *obj = lv_label_create(parent_obj);
-                            objects.arc_rapids_override_label_1 = obj;
-                            lv_obj_set_pos(obj, 42, 66);
-                            lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
-                            lv_obj_set_style_text_font(obj, &lv_font_montserrat_30, LV_PART_MAIN | LV_STATE_DEFAULT);
-                            lv_label_set_text(obj, "100%");
-                        }
+                        // ArcRapidsOverrideLabel_1
+                        lv_obj_t *obj = lv_label_create(parent_obj);
+                        objects.arc_rapids_override_label_1 = obj;
+                        lv_obj_set_pos(obj, 42, 66);
+                        lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+                        lv_obj_set_style_text_font(obj, &lv_font_montserrat_30, LV_PART_MAIN | LV_STATE_DEFAULT);
+                        lv_label_set_text(obj, "100%");
                     }
                 }
             }
         }
+    }
+}
+
+void create_spindle_feed_override(lv_obj_t *parent_obj)
+{
+    {
+        // SpindleFeedOverride
+        lv_obj_t *obj = lv_win_create(parent_obj);
+        objects.spindle_feed_override = obj;
+        lv_obj_set_pos(obj, 277, 12);
+        lv_obj_set_size(obj, 169, 232);
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_add_state(obj, LV_STATE_DISABLED);
+        lv_obj_set_style_bg_opa(obj, 220, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_color(obj, lv_color_hex(0xff0d0d0d), LV_PART_MAIN | LV_STATE_DEFAULT);
         {
-            // SpindleFeedOverride
-            lv_obj_t *obj = lv_win_create(parent_obj);
-            objects.spindle_feed_override = obj;
-            lv_obj_set_pos(obj, 277, 12);
-            lv_obj_set_size(obj, 169, 232);
-            lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
-            lv_obj_add_state(obj, LV_STATE_DISABLED);
-            lv_obj_set_style_bg_opa(obj, 220, LV_PART_MAIN | LV_STATE_DEFAULT);
-            lv_obj_set_style_bg_color(obj, lv_color_hex(0xff0d0d0d), LV_PART_MAIN | LV_STATE_DEFAULT);
+            lv_obj_t *parent_obj = obj;
             {
-                lv_obj_t *parent_obj = obj;
-                {
-                    // ArcSpindleOverride
-                    lv_obj_t *obj = lv_arc_create(parent_obj);
-                    objects.arc_spindle_override = obj;
-                    lv_obj_set_pos(obj, 10, 0);
-                    lv_obj_set_size(obj, 160, 181);
-                    lv_arc_set_range(obj, 50, 150);
-                    lv_arc_set_value(obj, 100);
-                    lv_obj_set_style_arc_width(obj, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+                // ArcSpindleOverride
+                lv_obj_t *obj = lv_arc_create(parent_obj);
+                objects.arc_spindle_override = obj;
+                lv_obj_set_pos(obj, 10, 0);
+                lv_obj_set_size(obj, 160, 181);
+                lv_arc_set_range(obj, 50, 150);
+                lv_arc_set_value(obj, 100);
+                lv_obj_set_style_arc_width(obj, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+                {
+                    lv_obj_t *parent_obj = obj;
                     {
-                        lv_obj_t *parent_obj = obj;
-                        {
-                            // ArcSpindleOverrideLabel
-                            lv_obj_t *obj = lv_label_create(parent_obj);
-                            objects.arc_spindle_override_label = obj;
-                            lv_obj_set_pos(obj, 42, 66);
-                            lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
-                            lv_obj_set_style_text_font(obj, &lv_font_montserrat_30, LV_PART_MAIN | LV_STATE_DEFAULT);
-                            lv_label_set_text(obj, "100%");
-                        }
+                        // ArcSpindleOverrideLabel
+                        lv_obj_t *obj = lv_label_create(parent_obj);
+                        objects.arc_spindle_override_label = obj;
+                        lv_obj_set_pos(obj, 42, 66);
+                        lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+                        lv_obj_set_style_text_font(obj, &lv_font_montserrat_30, LV_PART_MAIN | LV_STATE_DEFAULT);
+                        lv_label_set_text(obj, "100%");
                     }
                 }
             }
         }
     }
-
-    tick_screen_main();
-}
-
-void tick_screen_main()
-{
 }
 
 typedef void (*tick_screen_func_t)();
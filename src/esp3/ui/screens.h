@@ -93,6 +93,12 @@ enum ScreensEnum {
 void create_screen_main();
 void tick_screen_main();
 
+// Parts of the main screen that are built on first use (see ui_lazy.c).
+void create_macro_tab_content(lv_obj_t *parent_obj);
+void create_window_feed_override(lv_obj_t *parent_obj);
+void create_rapids_feed_override(lv_obj_t *parent_obj);
+void create_spindle_feed_override(lv_obj_t *parent_obj);
+
 void tick_screen_by_id(enum ScreensEnum screenId);
 void tick_screen(int screen_index);
 
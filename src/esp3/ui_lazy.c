@@ -0,0 +1,219 @@
+/**
+ * @file ui_lazy.c
+ * @brief Implements on-demand construction and teardown of secondary UI parts.
+ */
+
+#include "ui_lazy.h"
+#include "ui/screens.h" // Access to the global `objects` struct and the create_*() builders
+
+// Trim hidden parts once this much of LVGL's memory (mostly PSRAM) is in use, or an allocation failed (percent).
+#define UI_LAZY_TRIM_USED_PCT 85
+// How often the memory-pressure watchdog runs.
+#define UI_LAZY_WATCHDOG_PERIOD_MS 1000
+// Index of the Macros page inside objects.main_tabview.
+#define UI_LAZY_MACRO_TAB_INDEX 1
+// Maximum number of build callbacks per part.
+#define UI_LAZY_MAX_CALLBACKS 4
+
+// --- Module-static (private) variables ---
+
+static ui_lazy_build_cb_t build_callbacks[UI_PART_COUNT][UI_LAZY_MAX_CALLBACKS];
+
+// --- Forward declarations ---
+static void build_part(ui_lazy_part_t part);
+static void clear_part_pointers(ui_lazy_part_t part);
+static lv_obj_t *part_root(ui_lazy_part_t part);
+static bool part_is_visible(ui_lazy_part_t part);
+static void memory_watchdog_cb(lv_timer_t *timer);
+
+// --- Public Functions ---
+
+void ui_lazy_init()
+{
+    lv_timer_create(memory_watchdog_cb, UI_LAZY_WATCHDOG_PERIOD_MS, NULL);
+}
+
+lv_obj_t *ui_lazy_get(ui_lazy_part_t part)
+{
+    if (!ui_lazy_is_built(part))
+    {
+        build_part(part);
+    }
+    return part_root(part);
+}
+
+bool ui_lazy_is_built(ui_lazy_part_t part)
+{
+    switch (part)
+    {
+    case UI_PART_MACRO_TAB:
+        return objects.macros_roller != NULL;
+    case UI_PART_FEED_OVERRIDE:
+        return objects.window_feed_override != NULL;
+    case UI_PART_RAPIDS_OVERRIDE:
+        return objects.rapids_feed_override != NULL;
+    case UI_PART_SPINDLE_OVERRIDE:
+        return objects.spindle_feed_override != NULL;
+    default:
+        return false;
+    }
+}
+
+void ui_lazy_on_build(ui_lazy_part_t part, ui_lazy_build_cb_t cb)
+{
+    if (part >= UI_PART_COUNT || !cb)
+        return;
+
+    for (int i = 0; i < UI_LAZY_MAX_CALLBACKS; i++)
+    {
+        if (build_callbacks[part][i] == NULL)
+        {
+            build_callbacks[part][i] = cb;
+            if (ui_lazy_is_built(part))
+            {
+                cb(part);
+            }
+            return;
+        }
+    }
+}
+
+bool ui_lazy_release(ui_lazy_part_t part)
+{
+    if (!ui_lazy_is_built(part) || part_is_visible(part))
+        return false;
+
+    if (part == UI_PART_MACRO_TAB)
+    {
+        // The tab page itself belongs to the main screen; only its content goes.
+        lv_obj_clean(objects.macro_tab);
+    }
+    else
+    {
+        lv_obj_delete(part_root(part));
+    }
+    clear_part_pointers(part);
+    return true;
+}
+
+int ui_lazy_trim()
+{
+    int released = 0;
+    for (int p = 0; p < UI_PART_COUNT; p++)
+    {
+        if (ui_lazy_release((ui_lazy_part_t)p))
+            released++;
+    }
+    return released;
+}
+
+
+// --- Internal Functions ---
+
+/**
+ * @brief Runs the EEZ builder for a part and then every registered callback.
+ */
+static void build_part(ui_lazy_part_t part)
+{
+    switch (part)
+    {
+    case UI_PART_MACRO_TAB:
+        if (!objects.macro_tab)
+            return;
+        create_macro_tab_content(objects.macro_tab);
+        break;
+    case UI_PART_FEED_OVERRIDE:
+        create_window_feed_override(objects.main);
+        break;
+    case UI_PART_RAPIDS_OVERRIDE:
+        create_rapids_feed_override(objects.main);
+        break;
+    case UI_PART_SPINDLE_OVERRIDE:
+        create_spindle_feed_override(objects.main);
+        break;
+    default:
+        return;
+    }
+
+    for (int i = 0; i < UI_LAZY_MAX_CALLBACKS; i++)
+    {
+        if (build_callbacks[part][i])
+        {
+            build_callbacks[part][i](part);
+        }
+    }
+}
+
+/**
+ * @brief Resets every `objects` pointer that belonged to a deleted part.
+ */
+static void clear_part_pointers(ui_lazy_part_t part)
+{
+    switch (part)
+    {
+    case UI_PART_MACRO_TAB:
+        objects.macros_roller = NULL;
+        objects.macros_gcode = NULL;
+        break;
+    case UI_PART_FEED_OVERRIDE:
+        objects.window_feed_override = NULL;
+        objects.arc_feed_override = NULL;
+        objects.arc_feed_override_label = NULL;
+        break;
+    case UI_PART_RAPIDS_OVERRIDE:
+        objects.rapids_feed_override = NULL;
+        objects.arc_rapids_override_1 = NULL;
+        objects.arc_rapids_override_label_1 = NULL;
+        break;
+    case UI_PART_SPINDLE_OVERRIDE:
+        objects.spindle_feed_override = NULL;
+        objects.arc_spindle_override = NULL;
+        objects.arc_spindle_override_label = NULL;
+        break;
+    default:
+        break;
+    }
+}
+
+static lv_obj_t *part_root(ui_lazy_part_t part)
+{
+    switch (part)
+    {
+    case UI_PART_MACRO_TAB:
+        return objects.macro_tab;
+    case UI_PART_FEED_OVERRIDE:
+        return objects.window_feed_override;
+    case UI_PART_RAPIDS_OVERRIDE:
+        return objects.rapids_feed_override;
+    case UI_PART_SPINDLE_OVERRIDE:
+        return objects.spindle_feed_override;
+    default:
+        return NULL;
+    }
+}
+
+static bool part_is_visible(ui_lazy_part_t part)
+{
+    if (part == UI_PART_MACRO_TAB)
+    {
+        return objects.main_tabview &&
+               lv_tabview_get_tab_act(objects.main_tabview) == UI_LAZY_MACRO_TAB_INDEX;
+    }
+    lv_obj_t *root = part_root(part);
+    return root && !lv_obj_has_flag(root, LV_OBJ_FLAG_HIDDEN);
+}
+
+/**
+ * @brief Tears down hidden parts when the LVGL pool is nearly exhausted.
+ */
+static void memory_watchdog_cb(lv_timer_t *timer)
+{
+    (void)timer;
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    if (mon.used_pct >= UI_LAZY_TRIM_USED_PCT)
+    {
+        int released = ui_lazy_trim();
+        LV_LOG_WARN("LVGL pool at %d%%, released %d hidden UI parts", mon.used_pct, released);
+    }
+}
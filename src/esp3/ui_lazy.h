@@ -0,0 +1,75 @@
+/**
+ * @file ui_lazy.h
+ * @brief Public interface for building secondary UI parts on first use.
+ *
+ * Only the main DRO screen is created at boot. The Macros tab content and the
+ * three override pop-ups are built the first time they are needed, and hidden
+ * parts can be torn down again when the LVGL heap runs low. The `objects`
+ * pointers of a part are valid only while it is built, so code outside the
+ * main screen should fetch them through ui_lazy_get() or the accessors below.
+ */
+
+#ifndef UI_LAZY_H
+#define UI_LAZY_H
+
+#include <lvgl.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /** @brief The UI parts whose construction is deferred. */
+    typedef enum
+    {
+        UI_PART_MACRO_TAB,
+        UI_PART_FEED_OVERRIDE,
+        UI_PART_RAPIDS_OVERRIDE,
+        UI_PART_SPINDLE_OVERRIDE,
+        UI_PART_COUNT
+    } ui_lazy_part_t;
+
+    /** @brief Called right after a part has been (re)built, e.g. to attach events. */
+    typedef void (*ui_lazy_build_cb_t)(ui_lazy_part_t part);
+
+    /**
+     * @brief Starts the memory-pressure watchdog. Call once after ui_bridge_init().
+     */
+    void ui_lazy_init();
+
+    /**
+     * @brief Returns the root object of a part, building it first if necessary.
+     * @param part The part to fetch.
+     * @return The part's root object (the pop-up window, or the Macros tab page).
+     */
+    lv_obj_t *ui_lazy_get(ui_lazy_part_t part);
+
+    /** @brief Returns true if the part currently exists. Never builds it. */
+    bool ui_lazy_is_built(ui_lazy_part_t part);
+
+    /**
+     * @brief Registers a callback that runs every time a part is built.
+     *
+     * If the part already exists the callback is invoked immediately, so
+     * registration order relative to construction does not matter.
+     */
+    void ui_lazy_on_build(ui_lazy_part_t part, ui_lazy_build_cb_t cb);
+
+    /**
+     * @brief Deletes a part if it is not visible and clears its `objects` pointers.
+     * @return true if the part was torn down.
+     */
+    bool ui_lazy_release(ui_lazy_part_t part);
+
+    /**
+     * @brief Releases every hidden part. Called automatically under memory pressure.
+     * @return The number of parts that were torn down.
+     */
+    int ui_lazy_trim();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_LAZY_H
@@ -4,13 +4,18 @@
  */
 
 #include "ui_popups.h"
+#include "ui_lazy.h"
 #include "ui/screens.h" // Access to the global `objects` struct from EEZ Studio
+#include <stdint.h>
 
 // --- Module-static (private) variables ---
 
 static lv_obj_t *active_popup = NULL; // Pointer to the currently visible pop-up
 static lv_timer_t *hide_timer = NULL; // Timer for auto-hiding the pop-up
 
+// Last override value per part, applied to a pop-up when it gets built
+static int32_t override_percent[UI_PART_COUNT] = {0, 100, 100, 100};
+
 // Timeout in milliseconds
 #define POPUP_HIDE_TIMEOUT_MS 2000
 
@@ -19,27 +24,109 @@ static void hide_popup_timer_cb(lv_timer_t *timer);
 static void show_popup_event_cb(lv_event_t *e);
 static void arc_value_changed_event_cb(lv_event_t *e);
 static void background_click_event_cb(lv_event_t *e);
+static void attach_arc_events(ui_lazy_part_t part);
+static void apply_override(ui_lazy_part_t part);
 
 // --- Public Functions ---
 
 void ui_popups_init()
 {
-    // Attach CLICK events to the labels that will trigger the pop-ups
-    lv_obj_add_event_cb(objects.main_label_feed_override_value, show_popup_event_cb, LV_EVENT_CLICKED, objects.window_feed_override);
-    lv_obj_add_event_cb(objects.main_label_rapids_feed_override_value, show_popup_event_cb, LV_EVENT_CLICKED, objects.rapids_feed_override);
-    lv_obj_add_event_cb(objects.main_label_spindle_feed_override_value, show_popup_event_cb, LV_EVENT_CLICKED, objects.spindle_feed_override);
+    // Attach CLICK events to the labels that will trigger the pop-ups.
+    // The pop-ups themselves are built on first click (see ui_lazy.c).
+    lv_obj_add_event_cb(objects.main_label_feed_override_value, show_popup_event_cb, LV_EVENT_CLICKED, (void *)(uintptr_t)UI_PART_FEED_OVERRIDE);
+    lv_obj_add_event_cb(objects.main_label_rapids_feed_override_value, show_popup_event_cb, LV_EVENT_CLICKED, (void *)(uintptr_t)UI_PART_RAPIDS_OVERRIDE);
+    lv_obj_add_event_cb(objects.main_label_spindle_feed_override_value, show_popup_event_cb, LV_EVENT_CLICKED, (void *)(uintptr_t)UI_PART_SPINDLE_OVERRIDE);
 
-    // Attach VALUE_CHANGED events to the arcs inside the pop-ups
-    lv_obj_add_event_cb(objects.arc_feed_override, arc_value_changed_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
-    lv_obj_add_event_cb(objects.arc_rapids_override_1, arc_value_changed_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
-    lv_obj_add_event_cb(objects.arc_spindle_override, arc_value_changed_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
+    // Attach VALUE_CHANGED events to the arcs every time a pop-up is built
+    ui_lazy_on_build(UI_PART_FEED_OVERRIDE, attach_arc_events);
+    ui_lazy_on_build(UI_PART_RAPIDS_OVERRIDE, attach_arc_events);
+    ui_lazy_on_build(UI_PART_SPINDLE_OVERRIDE, attach_arc_events);
 
     // Attach a CLICK event to the main screen's background to detect outside clicks
     lv_obj_add_event_cb(objects.main, background_click_event_cb, LV_EVENT_CLICKED, NULL);
+
+    // The labels only change on a new value; show the current ones once
+    apply_override(UI_PART_FEED_OVERRIDE);
+    apply_override(UI_PART_RAPIDS_OVERRIDE);
+    apply_override(UI_PART_SPINDLE_OVERRIDE);
+}
+
+void ui_popups_set_override(ui_lazy_part_t part, int32_t percent)
+{
+    if (part == UI_PART_MACRO_TAB || part >= UI_PART_COUNT)
+        return;
+    if (override_percent[part] == percent)
+        return;
+    override_percent[part] = percent;
+    apply_override(part);
+}
+
+// --- Internal helpers ---
+
+/**
+ * @brief Writes the stored override value into the label and, if built, the arc.
+ */
+static void apply_override(ui_lazy_part_t part)
+{
+    int32_t value = override_percent[part];
+    lv_obj_t *main_label = NULL;
+    lv_obj_t *arc = NULL;
+    lv_obj_t *arc_label = NULL;
+
+    if (part == UI_PART_FEED_OVERRIDE)
+    {
+        main_label = objects.main_label_feed_override_value;
+        arc = objects.arc_feed_override;
+        arc_label = objects.arc_feed_override_label;
+    }
+    else if (part == UI_PART_RAPIDS_OVERRIDE)
+    {
+        main_label = objects.main_label_rapids_feed_override_value;
+        arc = objects.arc_rapids_override_1;
+        arc_label = objects.arc_rapids_override_label_1;
+    }
+    else if (part == UI_PART_SPINDLE_OVERRIDE)
+    {
+        main_label = objects.main_label_spindle_feed_override_value;
+        arc = objects.arc_spindle_override;
+        arc_label = objects.arc_spindle_override_label;
+    }
+
+    if (main_label)
+        lv_label_set_text_fmt(main_label, "%d%%", (int)value);
+
+    if (ui_lazy_is_built(part) && arc)
+    {
+        lv_arc_set_value(arc, value);
+        if (arc_label)
+            lv_label_set_text_fmt(arc_label, "%d%%", (int)value);
+    }
 }
 
 // --- Internal Event Callbacks ---
 
+/**
+ * @brief Build hook: wires the arc of a freshly created pop-up.
+ */
+static void attach_arc_events(ui_lazy_part_t part)
+{
+    lv_obj_t *arc = NULL;
+    if (part == UI_PART_FEED_OVERRIDE)
+        arc = objects.arc_feed_override;
+    else if (part == UI_PART_RAPIDS_OVERRIDE)
+        arc = objects.arc_rapids_override_1;
+    else if (part == UI_PART_SPINDLE_OVERRIDE)
+        arc = objects.arc_spindle_override;
+
+    if (arc)
+    {
+        lv_obj_add_event_cb(arc, arc_value_changed_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
+    }
+
+    // A freshly built pop-up starts at the last known override, not at 100%
+    apply_override(part);
+}
+
 /**
  * @brief Hides the currently active pop-up and deletes the timer.
  */
@@ -73,8 +160,9 @@ static void show_popup_event_cb(lv_event_t *e)
     // Hide any previously active pop-up
     hide_active_popup();
 
-    // Get the window to show from the user_data we attached in init
-    lv_obj_t *popup_to_show = (lv_obj_t *)lv_event_get_user_data(e);
+    // Get the pop-up part from the user_data we attached in init, building it if needed
+    ui_lazy_part_t part = (ui_lazy_part_t)(uintptr_t)lv_event_get_user_data(e);
+    lv_obj_t *popup_to_show = ui_lazy_get(part);
 
     if (popup_to_show)
     {
@@ -95,19 +183,24 @@ static void arc_value_changed_event_cb(lv_event_t *e)
     lv_obj_t *arc = lv_event_get_target(e);
     int32_t value = lv_arc_get_value(arc);
 
-    // Determine which arc was changed and update the corresponding labels
+    // Determine which arc was changed and update the corresponding labels.
+    // The stored value follows, so a rebuilt pop-up and the next
+    // ui_popups_set_override() start from what the arc shows.
     if (arc == objects.arc_feed_override)
     {
+        override_percent[UI_PART_FEED_OVERRIDE] = value;
         lv_label_set_text_fmt(objects.arc_feed_override_label, "%d%%", value);
         lv_label_set_text_fmt(objects.main_label_feed_override_value, "%d%%", value);
     }
     else if (arc == objects.arc_rapids_override_1)
     {
+        override_percent[UI_PART_RAPIDS_OVERRIDE] = value;
         lv_label_set_text_fmt(objects.arc_rapids_override_label_1, "%d%%", value);
         lv_label_set_text_fmt(objects.main_label_rapids_feed_override_value, "%d%%", value);
     }
     else if (arc == objects.arc_spindle_override)
     {
+        override_percent[UI_PART_SPINDLE_OVERRIDE] = value;
         lv_label_set_text_fmt(objects.arc_spindle_override_label, "%d%%", value);
         lv_label_set_text_fmt(objects.main_label_spindle_feed_override_value, "%d%%", value);
     }
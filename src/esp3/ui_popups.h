@@ -7,6 +7,9 @@
 #ifndef UI_POPUPS_H
 #define UI_POPUPS_H
 
+#include <stdint.h>
+#include "ui_lazy.h"
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -22,6 +25,17 @@ extern "C"
      */
     void ui_popups_init();
 
+    /**
+     * @brief Mirrors an override value into the main-screen label and, if the
+     *        pop-up is currently built, into its arc.
+     *
+     * Never builds the pop-up; a pop-up built later picks up the last value.
+     *
+     * @param part One of the UI_PART_*_OVERRIDE parts.
+     * @param percent The override in percent.
+     */
+    void ui_popups_set_override(ui_lazy_part_t part, int32_t percent);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,6 +4,7 @@
  */
 
 #include "ui_tab_logic.h"
+#include "ui_lazy.h"
 #include "ui/screens.h" // Access to the global `objects` struct from EEZ Studio
 
 // --- Forward declaration for the event callback ---
@@ -49,6 +50,9 @@ static void tab_changed_event_cb(lv_event_t *e)
         // The second tab (index 1) is the "Macros" tab
         else if (active_tab_index == 1)
         {
+            // The Macros tab content is built the first time it is opened
+            ui_lazy_get(UI_PART_MACRO_TAB);
+
             // Hide the config panel and show the macro panel
             lv_obj_add_flag(objects.main_panel_config, LV_OBJ_FLAG_HIDDEN);
             lv_obj_clear_flag(objects.macro_panel_control, LV_OBJ_FLAG_HIDDEN);
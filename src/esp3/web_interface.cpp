@@ -10,12 +10,66 @@
 #include <AsyncElegantOTA.h>
 #include <ArduinoJson.h>
 #include <LittleFS.h>
-#include "ui.h" // For ui_bridge_apply_config
+#include "web_assets.h"
 
 // --- Module‐static Globals ---
 static AsyncWebServer server(80);
 static AsyncWebSocket ws("/ws");
 
+// --- Live-status binary protocol ---
+// Little-endian frames, decoded by data_esp3/script.js. Bump the version on
+// any layout change so a cached page can tell it is talking to new firmware.
+static constexpr uint8_t LIVE_PROTOCOL_VERSION = 1;
+static constexpr uint8_t LIVE_FRAME_LCNC = 0x01;
+static constexpr uint8_t LIVE_FRAME_PENDANT = 0x02;
+
+struct __attribute__((packed)) LiveFrameHeader
+{
+    uint8_t type;
+    uint8_t version;
+    uint16_t seq;
+};
+
+struct __attribute__((packed)) LcncLiveFrame
+{
+    LiveFrameHeader hdr;
+    uint32_t linuxcnc_status;
+    uint16_t machine_status;
+    uint16_t spindle_coolant_status;
+    float feed_override;
+    float rapid_override;
+    float spindle_override;
+    float current_feedrate;
+    uint32_t spindle_rpm;
+    float cutting_speed;
+    float dro_pos[6];
+};
+
+struct __attribute__((packed)) PendantLiveFrame
+{
+    LiveFrameHeader hdr;
+    uint32_t buttons;
+    int32_t handwheel;
+    uint8_t axis;
+    uint8_t step;
+};
+
+struct PendantLiveState
+{
+    uint32_t buttons;
+    int32_t handwheel;
+    uint8_t axis;
+    uint8_t step;
+};
+
+// Latest snapshots, written by producers and drained by live_status_task
+static portMUX_TYPE live_mux = portMUX_INITIALIZER_UNLOCKED;
+static LcncStatusPacket live_lcnc = {};
+static PendantLiveState live_pendant = {};
+static bool live_lcnc_dirty = false;
+static bool live_pendant_dirty = false;
+static uint32_t live_frames_dropped = 0;
+
 // --- Private Function Prototypes ---
 static void on_ws_event(AsyncWebSocket *server,
                         AsyncWebSocketClient *client,
@@ -25,6 +79,7 @@ static void on_ws_event(AsyncWebSocket *server,
                         size_t len);
 static void handle_ws_connect(AsyncWebSocketClient *client);
 static void handle_ws_data(uint8_t *data, size_t len);
+static void live_status_task(void *arg);
 
 // --- Public API Implementation ---
 
@@ -36,14 +91,6 @@ void web_interface_init()
     ws.onEvent(on_ws_event);
     server.addHandler(&ws);
 
-    // Serve index.html
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *req)
-              { req->send(LittleFS, "/index.html", "text/html"); });
-
-    // Serve your existing CSS and JS from LittleFS
-    server.serveStatic("/style.css", LittleFS, "/style.css", "text/css");
-    server.serveStatic("/script.js", LittleFS, "/script.js", "application/javascript");
-
     // REST endpoint: get full pendant config
     server.on("/get_config_json", HTTP_GET, [](AsyncWebServerRequest *req)
               { req->send(200, "application/json", get_pendant_config_as_json()); });
@@ -51,9 +98,19 @@ void web_interface_init()
     // REST endpoint: read encoder settings
     server.on("/api/encoder", HTTP_GET, [](AsyncWebServerRequest *req)
               {
-        StaticJsonDocument<128> doc;
+        StaticJsonDocument<512> doc;
         doc["inverted"] = encoder_inverted;
         doc["deadzone"] = encoder_deadzone;
+        doc["accel_enabled"] = handwheel_cfg.accel_enabled;
+        doc["velocity_low"] = handwheel_cfg.velocity_low;
+        doc["velocity_high"] = handwheel_cfg.velocity_high;
+        doc["max_multiplier"] = handwheel_cfg.max_multiplier;
+        doc["curve_exponent"] = handwheel_cfg.curve_exponent;
+        doc["counts_per_detent"] = handwheel_cfg.counts_per_detent;
+        doc["detent_filter"] = handwheel_cfg.detent_filter;
+        JsonArray axis_max = doc["axis_max_multiplier"].to<JsonArray>();
+        for (float m : handwheel_cfg.axis_max_multiplier)
+            axis_max.add(m);
         String out;
         serializeJson(doc, out);
         req->send(200, "application/json", out); });
@@ -66,21 +123,88 @@ void web_interface_init()
             return;
         }
         String body = req->getParam("body", true)->value();
-        StaticJsonDocument<128> doc;
+        StaticJsonDocument<512> doc;
         if (deserializeJson(doc, body) == DeserializationError::Ok) {
+            // Build the new settings aside and only take them over once they are sane.
+            HandwheelConfig next = handwheel_cfg;
+            next.accel_enabled = doc["accel_enabled"] | next.accel_enabled;
+            next.velocity_low = doc["velocity_low"] | next.velocity_low;
+            next.velocity_high = doc["velocity_high"] | next.velocity_high;
+            next.max_multiplier = doc["max_multiplier"] | next.max_multiplier;
+            next.curve_exponent = doc["curve_exponent"] | next.curve_exponent;
+            next.counts_per_detent = doc["counts_per_detent"] | next.counts_per_detent;
+            next.detent_filter = doc["detent_filter"] | next.detent_filter;
+            JsonArrayConst axis_max = doc["axis_max_multiplier"].as<JsonArrayConst>();
+            for (size_t i = 0; i < axis_max.size() && i < HANDWHEEL_MAX_AXES; ++i)
+                next.axis_max_multiplier[i] = axis_max[i] | next.axis_max_multiplier[i];
+            if (!(next.curve_exponent > 0.0f) || !(next.velocity_high > next.velocity_low) ||
+                next.counts_per_detent < 1) {
+                req->send(400, "application/json",
+                          "{\"error\":\"need curve_exponent > 0, velocity_high > velocity_low, counts_per_detent >= 1\"}");
+                return;
+            }
             encoder_inverted = doc["inverted"]  | encoder_inverted;
             encoder_deadzone = doc["deadzone"]  | encoder_deadzone;
+            handwheel_cfg = next;
             save_encoder_config();
             req->send(200, "application/json", "{\"status\":\"ok\"}");
         } else {
             req->send(400, "application/json", "{\"error\":\"invalid JSON\"}");
         } });
 
+    // REST endpoint: selector readings and calibration tables
+    server.on("/api/selectors", HTTP_GET, [](AsyncWebServerRequest *req)
+              {
+        StaticJsonDocument<512> doc;
+        const char *names[SELECTOR_COUNT] = {"axis", "step"};
+        for (int i = 0; i < SELECTOR_COUNT; ++i) {
+            JsonObject sel = doc[names[i]].to<JsonObject>();
+            sel["raw"] = selector_raw((SelectorId)i);
+            sel["position"] = selector_position((SelectorId)i);
+            const SelectorCalibration cal = selector_calibration((SelectorId)i);
+            sel["calibrated_mask"] = cal.calibrated_mask;
+            JsonArray centers = sel["centers"].to<JsonArray>();
+            for (uint8_t p = 0; p < cal.positions; ++p)
+                centers.add(cal.center[p]);
+        }
+        String out;
+        serializeJson(doc, out);
+        req->send(200, "application/json", out); });
+
+    // REST endpoint: capture the current reading as a detent centre
+    server.on("/api/selectors", HTTP_POST, [](AsyncWebServerRequest *req)
+              {
+        if (!req->hasParam("body", true)) {
+            req->send(400, "application/json", "{\"error\":\"no body\"}");
+            return;
+        }
+        String body = req->getParam("body", true)->value();
+        StaticJsonDocument<128> doc;
+        if (deserializeJson(doc, body) != DeserializationError::Ok) {
+            req->send(400, "application/json", "{\"error\":\"invalid JSON\"}");
+            return;
+        }
+        SelectorId sel = strcmp(doc["selector"] | "", "step") == 0 ? SELECTOR_STEP : SELECTOR_AXIS;
+        if (selector_capture_position(sel, doc["position"] | 0xFF)) {
+            save_selector_calibration();
+            req->send(200, "application/json", "{\"status\":\"ok\"}");
+        } else {
+            req->send(400, "application/json", "{\"error\":\"position out of range\"}");
+        } });
+
     // OTA
     AsyncElegantOTA.begin(&server);
 
+    // Serve the precompressed UI (index.html, hashed CSS/JS) from LittleFS.
+    // Registered last: the raw-file fallback is a catch-all on "/".
+    web_assets_register(server, LittleFS);
+
     // Start the HTTP server
     server.begin();
+
+    // Live frames are encoded here, never on the radio or LVGL task
+    xTaskCreatePinnedToCore(live_status_task, "wsLiveTask", 4 * 1024, nullptr,
+                            /* priority */ 1, nullptr, /* core */ 0);
 }
 
 void web_interface_loop()
@@ -88,36 +212,103 @@ void web_interface_loop()
     ws.cleanupClients();
 }
 
-void web_interface_broadcast_status(const LcncStatusPacket &data)
+void web_interface_post_lcnc_status(const LcncStatusPacket &data)
+{
+    portENTER_CRITICAL(&live_mux);
+    live_lcnc = data;
+    live_lcnc_dirty = true;
+    portEXIT_CRITICAL(&live_mux);
+}
+
+void web_interface_post_pendant_status(uint32_t btns,
+                                       int32_t hw,
+                                       uint8_t axis,
+                                       uint8_t step)
+{
+    portENTER_CRITICAL(&live_mux);
+    live_pendant = {btns, hw, axis, step};
+    live_pendant_dirty = true;
+    portEXIT_CRITICAL(&live_mux);
+}
+
+// --- Live-status encoding ---
+
+/**
+ * @brief Sends one frame to every client whose queue has room.
+ *
+ * A client that is still behind simply misses this frame; the next tick
+ * carries newer state, so nothing stale is ever buffered for it.
+ */
+static void send_live_frame(const uint8_t *frame, size_t len)
 {
-    StaticJsonDocument<256> doc;
-    doc["type"] = "lcncStatus";
-    auto payload = doc.createNestedObject("payload");
-    payload["feed_override"] = data.feed_override;
-    payload["spindle_rpm"] = data.spindle_rpm;
-    // …add more fields as needed…
-
-    String out;
-    serializeJson(doc, out);
-    ws.textAll(out);
+    for (AsyncWebSocketClient *c : ws.getClients())
+    {
+        if (c->status() != WS_CONNECTED)
+            continue;
+        if (c->queueIsFull())
+        {
+            live_frames_dropped++;
+            continue;
+        }
+        c->binary(frame, len);
+    }
 }
 
-void web_interface_broadcast_live_pendant_status(uint32_t btns,
-                                                 int32_t hw,
-                                                 uint8_t axis,
-                                                 uint8_t step)
+static void live_status_task(void *arg)
 {
-    StaticJsonDocument<128> doc;
-    doc["type"] = "liveStatus";
-    auto payload = doc.createNestedObject("payload");
-    payload["buttons"] = btns;
-    payload["handwheel"] = hw;
-    payload["axis"] = axis;
-    payload["step"] = step;
-
-    String out;
-    serializeJson(doc, out);
-    ws.textAll(out);
+    (void)arg;
+    const TickType_t period = pdMS_TO_TICKS(1000 / WebConfig::LIVE_STATUS_RATE_HZ);
+    TickType_t last_wake = xTaskGetTickCount();
+    uint16_t seq = 0;
+
+    while (true)
+    {
+        vTaskDelayUntil(&last_wake, period);
+        web_interface_loop();
+
+        LcncStatusPacket lcnc;
+        PendantLiveState pendant;
+        bool send_lcnc, send_pendant;
+        portENTER_CRITICAL(&live_mux);
+        lcnc = live_lcnc;
+        pendant = live_pendant;
+        send_lcnc = live_lcnc_dirty;
+        send_pendant = live_pendant_dirty;
+        live_lcnc_dirty = false;
+        live_pendant_dirty = false;
+        portEXIT_CRITICAL(&live_mux);
+
+        // Nobody watching: the snapshots stay current but cost no encoding.
+        if (ws.count() == 0)
+            continue;
+
+        if (send_lcnc)
+        {
+            LcncLiveFrame f;
+            f.hdr = {LIVE_FRAME_LCNC, LIVE_PROTOCOL_VERSION, seq++};
+            f.linuxcnc_status = lcnc.linuxcnc_status;
+            f.machine_status = lcnc.machine_status;
+            f.spindle_coolant_status = lcnc.spindle_coolant_status;
+            f.feed_override = lcnc.feed_override;
+            f.rapid_override = lcnc.rapid_override;
+            f.spindle_override = lcnc.spindle_override;
+            f.current_feedrate = lcnc.current_feedrate;
+            f.spindle_rpm = lcnc.spindle_rpm;
+            f.cutting_speed = lcnc.cutting_speed;
+            memcpy(f.dro_pos, lcnc.dro_pos, sizeof(f.dro_pos));
+            send_live_frame((const uint8_t *)&f, sizeof(f));
+        }
+        if (send_pendant)
+        {
+            PendantLiveFrame f;
+            f.hdr = {LIVE_FRAME_PENDANT, LIVE_PROTOCOL_VERSION, seq++};
+            f.buttons = pendant.buttons;
+            f.handwheel = pendant.handwheel;
+            f.axis = pendant.axis;
+            f.step = pendant.step;
+            send_live_frame((const uint8_t *)&f, sizeof(f));
+        }
+    }
 }
 
 // --- WebSocket Event Handlers ---
@@ -132,6 +323,12 @@ static void on_ws_event(AsyncWebSocket * /*server*/,
     if (type == WS_EVT_CONNECT)
     {
         handle_ws_connect(client);
+
+        // Give the new page a full picture on the next live tick
+        portENTER_CRITICAL(&live_mux);
+        live_lcnc_dirty = true;
+        live_pendant_dirty = true;
+        portEXIT_CRITICAL(&live_mux);
     }
     else if (type == WS_EVT_DATA)
     {
@@ -141,17 +338,16 @@ static void on_ws_event(AsyncWebSocket * /*server*/,
 
 static void handle_ws_connect(AsyncWebSocketClient *client)
 {
-    StaticJsonDocument<512> doc;
-    doc["type"] = "initialConfig";
-
-    // embed current pendant configuration
-    StaticJsonDocument<512> cfg;
-    deserializeJson(cfg, get_pendant_config_as_json());
-    doc["payload"] = cfg.as<JsonObject>();
-
-    String out;
-    serializeJson(doc, out);
-    client->text(out);
+    // Envelope and config are written straight into the frame buffer.
+    bool sent = ws_send_json(client, [](JsonStreamWriter &w)
+                             {
+        w.begin_object();
+        w.field("type", "initialConfig");
+        w.key("payload");
+        write_pendant_config_json(w);
+        w.end_object(); });
+    if (!sent)
+        Serial.println("ERROR: Out of memory for initialConfig frame.");
 }
 
 static void handle_ws_data(uint8_t *data, size_t len)
@@ -168,8 +364,7 @@ static void handle_ws_data(uint8_t *data, size_t len)
     {
         String cfg_out;
         serializeJson(doc["payload"], cfg_out);
-        save_pendant_configuration(cfg_out);
-        ui_bridge_apply_config(pendant_web_cfg);
+        save_pendant_configuration(cfg_out); // loopTask applies it to the UI
     }
     else if (strcmp(cmd, "resetDefaults") == 0)
     {
@@ -20,18 +20,23 @@ void web_interface_init();
 void web_interface_loop();
 
 /**
- * @brief Broadcasts the full LCNC status to all connected WebSocket clients.
+ * @brief Stores the latest LCNC status for the live view.
+ *
+ * Only copies the packet; encoding and sending happen on the live-status task
+ * at WebConfig::LIVE_STATUS_RATE_HZ, so this is safe to call from the radio
+ * receive callback.
+ *
  * @param data The incoming data from LinuxCNC.
  */
-void web_interface_broadcast_status(const LcncStatusPacket &data);
+void web_interface_post_lcnc_status(const LcncStatusPacket &data);
 
 /**
- * @brief Broadcasts the live pendant hardware status to all WebSocket clients.
+ * @brief Stores the latest pendant hardware state for the live view.
  * @param btn_states Bitmask of pressed buttons.
  * @param hw_pos Current handwheel position.
  * @param axis_pos Current axis selector position.
  * @param step_pos Current step selector position.
  */
-void web_interface_broadcast_live_pendant_status(uint32_t btn_states, int32_t hw_pos, uint8_t axis_pos, uint8_t step_pos);
+void web_interface_post_pendant_status(uint32_t btn_states, int32_t hw_pos, uint8_t axis_pos, uint8_t step_pos);
 
 #endif // WEB_INTERFACE_H
\ No newline at end of file
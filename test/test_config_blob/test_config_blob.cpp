@@ -0,0 +1,138 @@
+/**
+ * @file test_config_blob.cpp
+ * @brief Host round-trip tests for the pendant config blob (pio test -e native).
+ */
+
+#include <unity.h>
+#include "config_blob_esp3.h"
+
+// --- HELPERS ---
+
+// Mirrors load_pendant_default_configuration() in persistence_esp3.cpp.
+static PendantWebConfig default_config()
+{
+    PendantWebConfig cfg = {};
+    cfg.num_dro_axes = 3;
+    cfg.handwheel_enable_button = 0;
+    cfg.axis_labels = {"X", "Y", "Z"};
+    cfg.button_bindings = {
+        {0, "Cycle Start", BindingType::BOUND_TO_LCNC, 101},
+        {1, "Feed Hold", BindingType::BOUND_TO_LCNC, 102},
+        {2, "Coolant Toggle", BindingType::BOUND_TO_BUTTON, 200}};
+    cfg.led_bindings = {
+        {0, "Spindle On", LedBindingType::LED_BOUND_TO_MATRIX, 0, 0, 0},
+        {1, "Feed Override", LedBindingType::LED_BOUND_TO_MATRIX, 0, 1, 1},
+        {2, "Coolant", LedBindingType::LED_BOUND_TO_BUTTON, 1, 0, 2}};
+    cfg.macros = {
+        {"M8 Coolant On", {"M8"}, 300},
+        {"M9 Coolant Off", {"M9"}, 301}};
+    return cfg;
+}
+
+static void assert_equal(const PendantWebConfig &a, const PendantWebConfig &b)
+{
+    TEST_ASSERT_EQUAL_UINT8(a.num_dro_axes, b.num_dro_axes);
+    TEST_ASSERT_EQUAL_UINT8(a.handwheel_enable_button, b.handwheel_enable_button);
+    TEST_ASSERT_TRUE(a.axis_labels == b.axis_labels);
+
+    TEST_ASSERT_EQUAL_size_t(a.button_bindings.size(), b.button_bindings.size());
+    for (size_t i = 0; i < a.button_bindings.size(); ++i)
+    {
+        const ButtonBinding &x = a.button_bindings[i], &y = b.button_bindings[i];
+        TEST_ASSERT_EQUAL_UINT8(x.button_index, y.button_index);
+        TEST_ASSERT_TRUE(x.action_name == y.action_name);
+        TEST_ASSERT_EQUAL_INT((int)x.type, (int)y.type);
+        TEST_ASSERT_EQUAL_UINT16(x.lcnc_action_code, y.lcnc_action_code);
+    }
+
+    TEST_ASSERT_EQUAL_size_t(a.led_bindings.size(), b.led_bindings.size());
+    for (size_t i = 0; i < a.led_bindings.size(); ++i)
+    {
+        const LedBinding &x = a.led_bindings[i], &y = b.led_bindings[i];
+        TEST_ASSERT_EQUAL_UINT8(x.led_index, y.led_index);
+        TEST_ASSERT_TRUE(x.signal_name == y.signal_name);
+        TEST_ASSERT_EQUAL_INT((int)x.type, (int)y.type);
+        TEST_ASSERT_EQUAL_UINT8(x.matrix_index, y.matrix_index);
+        TEST_ASSERT_EQUAL_UINT8(x.bit_index, y.bit_index);
+        TEST_ASSERT_EQUAL_UINT8(x.button_index, y.button_index);
+    }
+
+    TEST_ASSERT_EQUAL_size_t(a.macros.size(), b.macros.size());
+    for (size_t i = 0; i < a.macros.size(); ++i)
+    {
+        TEST_ASSERT_TRUE(a.macros[i].name == b.macros[i].name);
+        TEST_ASSERT_TRUE(a.macros[i].commands == b.macros[i].commands);
+        TEST_ASSERT_EQUAL_UINT16(a.macros[i].action_code, b.macros[i].action_code);
+    }
+}
+
+static void round_trip(const PendantWebConfig &cfg)
+{
+    std::vector<uint8_t> blob;
+    config_blob_encode(cfg, blob);
+
+    PendantWebConfig decoded = {};
+    uint16_t schema = 0;
+    ConfigBlobStatus status = config_blob_decode(blob.data(), blob.size(), decoded, &schema);
+    TEST_ASSERT_EQUAL_STRING(config_blob_status_name(ConfigBlobStatus::OK), config_blob_status_name(status));
+    TEST_ASSERT_EQUAL_UINT16(CONFIG_BLOB_SCHEMA, schema);
+    assert_equal(cfg, decoded);
+}
+
+// --- TESTS ---
+
+void setUp() {}
+void tearDown() {}
+
+static void test_default_config_round_trips()
+{
+    round_trip(default_config());
+}
+
+static void test_empty_config_round_trips()
+{
+    round_trip(PendantWebConfig{});
+}
+
+static void test_populated_config_round_trips()
+{
+    PendantWebConfig cfg = default_config();
+    cfg.num_dro_axes = 6;
+    cfg.handwheel_enable_button = 24;
+    cfg.axis_labels = {"X", "Y", "Z", "A", "B", "C"};
+    for (uint8_t i = 0; i < 25; ++i)
+        cfg.button_bindings.push_back({i, "Button " + std::to_string(i), BindingType::BOUND_TO_HANDWHEEL_ENABLE, (uint16_t)(1000 + i)});
+    cfg.macros.push_back({"Probe Z", {"G91", "G38.2 Z-20 F100", "G90"}, 0xFFFF});
+    round_trip(cfg);
+}
+
+// LED bindings are 7 bytes with an empty name; the decoder once required 8.
+static void test_led_bindings_with_empty_names_round_trip()
+{
+    PendantWebConfig cfg = {};
+    for (uint8_t i = 0; i < 8; ++i)
+        cfg.led_bindings.push_back({i, "", LedBindingType::LED_BOUND_TO_MATRIX, 0, i, 0});
+    round_trip(cfg);
+}
+
+static void test_corrupted_blob_is_rejected()
+{
+    std::vector<uint8_t> blob;
+    config_blob_encode(default_config(), blob);
+    blob.back() ^= 0x01;
+
+    PendantWebConfig decoded = {};
+    ConfigBlobStatus status = config_blob_decode(blob.data(), blob.size(), decoded);
+    TEST_ASSERT_EQUAL_STRING(config_blob_status_name(ConfigBlobStatus::BAD_CRC), config_blob_status_name(status));
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_default_config_round_trips);
+    RUN_TEST(test_empty_config_round_trips);
+    RUN_TEST(test_populated_config_round_trips);
+    RUN_TEST(test_led_bindings_with_empty_names_round_trip);
+    RUN_TEST(test_corrupted_blob_is_rejected);
+    return UNITY_END();
+}